@@ -76,6 +76,8 @@ static void free_plugin_env(cp_plugin_env_t *env) {
 		list_destroy(env->plugin_dirs);
 		env->plugin_dirs = NULL;
 	}
+	free(env->descriptor_cache);
+	env->descriptor_cache = NULL;
 	if (env->infos != NULL) {
 		assert(hash_isempty(env->infos));
 		hash_destroy(env->infos);
@@ -1141,6 +1141,20 @@ CP_C_API cp_status_t cp_install_plugin(cp_context_t *ctx, cp_plugin_info_t *pi)
  */
 CP_C_API cp_status_t cp_scan_plugins(cp_context_t *ctx, int flags) CP_GCC_NONNULL(1);
 
+/**
+ * Sets the file used to cache parsed plug-in descriptors between plug-in
+ * scans. When set, ::cp_scan_plugins restores the descriptors of plug-ins
+ * whose descriptor file has the same modification time and size as
+ * during the previous scan from this file instead of parsing them again,
+ * and rewrites the file when any descriptor changed. The file must not
+ * be located inside a registered plug-in collection.
+ * 
+ * @param ctx the plug-in context
+ * @param file the path of the cache file or NULL to disable caching
+ * @return @ref CP_OK (zero) on success or @ref CP_ERR_RESOURCE if insufficient memory
+ */
+CP_C_API cp_status_t cp_set_descriptor_cache(cp_context_t *ctx, const char *file) CP_GCC_NONNULL(1);
+
 /**
  * Starts a plug-in. Also starts any imported plug-ins. If the plug-in is
  * already starting then
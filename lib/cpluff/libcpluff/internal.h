@@ -172,6 +172,9 @@ struct cp_plugin_env_t {
 	/// List of registered plug-in directories 
 	list_t *plugin_dirs;
 
+	/// Path of the plug-in descriptor cache file, or NULL if disabled
+	char *descriptor_cache;
+
 	/// Map of in-use reference counter information object
 	hash_t *infos;
 
@@ -503,6 +506,44 @@ CP_HIDDEN void cpi_deliver_event(cp_context_t *context, const cpi_plugin_event_t
  */
 CP_HIDDEN void cpi_free_plugin(cp_plugin_info_t *plugin) CP_GCC_NONNULL(1);
 
+
+// Plug-in descriptor cache
+
+/// An open plug-in descriptor cache used during a plug-in scan
+typedef struct cpi_dcache_t cpi_dcache_t;
+
+/**
+ * Opens the plug-in descriptor cache of the context for a plug-in scan.
+ * Returns NULL if no cache has been configured or on resource errors,
+ * in which case descriptors are parsed as usual.
+ * 
+ * @param context the plug-in context
+ * @return the descriptor cache or NULL
+ */
+CP_HIDDEN cpi_dcache_t *cpi_open_dcache(cp_context_t *context) CP_GCC_NONNULL(1);
+
+/**
+ * Loads a plug-in descriptor like ::cp_load_plugin_descriptor but restores
+ * it from the descriptor cache if the descriptor file has not changed
+ * since the previous scan.
+ * 
+ * @param context the plug-in context
+ * @param dcache the descriptor cache or NULL
+ * @param path the installation path of the plug-in
+ * @param status a pointer to the location where status code is to be stored, or NULL
+ * @return pointer to the information structure or NULL if error occurs
+ */
+CP_HIDDEN cp_plugin_info_t *cpi_load_cached_descriptor(cp_context_t *context, cpi_dcache_t *dcache, const char *path, cp_status_t *status) CP_GCC_NONNULL(1, 3);
+
+/**
+ * Closes the descriptor cache and writes a new snapshot of it if
+ * any descriptor was added, changed or removed.
+ * 
+ * @param context the plug-in context
+ * @param dcache the descriptor cache or NULL
+ */
+CP_HIDDEN void cpi_close_dcache(cp_context_t *context, cpi_dcache_t *dcache) CP_GCC_NONNULL(1);
+
 /**
  * Starts the specified plug-in and its dependencies.
  * 
@@ -0,0 +1,739 @@
+/*-------------------------------------------------------------------------
+ * C-Pluff, a plug-in framework for C
+ * Copyright 2007 Johannes Lehtinen
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *-----------------------------------------------------------------------*/
+
+/** @file
+ * Plug-in descriptor cache
+ *
+ * Keeps a binary snapshot of parsed plug-in descriptors keyed by plug-in
+ * path, descriptor modification time and size. The snapshot of the previous
+ * scan is mapped into memory, unchanged descriptors are restored from it and
+ * only new or modified ones are parsed. A new snapshot is written when
+ * anything changed.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+#include "../kazlib/hash.h"
+#include "cpluff.h"
+#include "defines.h"
+#include "util.h"
+#include "internal.h"
+
+
+/* ------------------------------------------------------------------------
+ * Constants and data types
+ * ----------------------------------------------------------------------*/
+
+/// Magic bytes at the start of a cache file
+#define CPI_DCACHE_MAGIC "CPDC"
+
+/// Version of the cache file format, bump when the layout changes
+#define CPI_DCACHE_VERSION 2
+
+/// Encoded length of a NULL string
+#define CPI_DCACHE_NULL_STR 0xFFFFFFFFu
+
+/// Name of the descriptor file within a plug-in directory
+#define CPI_DCACHE_DESCRIPTOR "addon.xml"
+
+struct cpi_dcache_t {
+
+	/// The snapshot of the previous scan, or NULL if none
+	unsigned char *map;
+
+	/// Size of the snapshot
+	size_t map_size;
+
+	/// Whether the snapshot is memory mapped or allocated
+	int mapped;
+
+	/// Maps plug-in paths to their record in the snapshot
+	hash_t *entries;
+
+	/// The snapshot being built during this scan
+	unsigned char *out;
+	size_t out_size;
+	size_t out_capacity;
+	uint32_t out_count;
+
+	/// Number of descriptors restored from the snapshot
+	unsigned int hits;
+
+	/// Whether a descriptor had to be parsed or the snapshot could not be read
+	int dirty;
+
+	/// Whether the new snapshot could not be built
+	int failed;
+};
+
+/// Sequential reader over a snapshot record
+typedef struct reader_t {
+	const unsigned char *pos;
+	const unsigned char *end;
+	int error;
+} reader_t;
+
+
+/* ------------------------------------------------------------------------
+ * Reading
+ * ----------------------------------------------------------------------*/
+
+static uint32_t read_u32(reader_t *r) {
+	uint32_t v = 0;
+
+	if (r->error || r->end - r->pos < (ptrdiff_t) sizeof(v)) {
+		r->error = 1;
+		return 0;
+	}
+	memcpy(&v, r->pos, sizeof(v));
+	r->pos += sizeof(v);
+	return v;
+}
+
+static int64_t read_i64(reader_t *r) {
+	int64_t v = 0;
+
+	if (r->error || r->end - r->pos < (ptrdiff_t) sizeof(v)) {
+		r->error = 1;
+		return 0;
+	}
+	memcpy(&v, r->pos, sizeof(v));
+	r->pos += sizeof(v);
+	return v;
+}
+
+/**
+ * Returns a pointer to a string stored in the snapshot. Strings are stored
+ * with their terminating zero so they can be used in place.
+ */
+static const char *read_str(reader_t *r) {
+	uint32_t len = read_u32(r);
+	const char *s;
+
+	if (r->error || len == CPI_DCACHE_NULL_STR) {
+		return NULL;
+	}
+	if ((size_t) (r->end - r->pos) < (size_t) len + 1 || r->pos[len] != '\0') {
+		r->error = 1;
+		return NULL;
+	}
+	s = (const char *) r->pos;
+	r->pos += len + 1;
+	return s;
+}
+
+static char *read_strdup(reader_t *r) {
+	const char *s = read_str(r);
+	char *d;
+
+	if (s == NULL) {
+		return NULL;
+	}
+	if ((d = strdup(s)) == NULL) {
+		r->error = 1;
+	}
+	return d;
+}
+
+/**
+ * Reads a count and checks that at least that many minimum sized elements
+ * fit into the remaining data, which guards the allocations against
+ * corrupted input.
+ */
+static unsigned int read_count(reader_t *r, size_t min_size) {
+	uint32_t n = read_u32(r);
+
+	if (r->error || (size_t) (r->end - r->pos) / min_size < n) {
+		r->error = 1;
+		return 0;
+	}
+	return n;
+}
+
+static void read_cfg_element(reader_t *r, cp_cfg_element_t *ce, cp_cfg_element_t *parent, unsigned int index) {
+	unsigned int i;
+
+	ce->name = read_strdup(r);
+	ce->parent = parent;
+	ce->index = index;
+
+	ce->num_atts = read_count(r, 2 * sizeof(uint32_t));
+	if (ce->num_atts > 0) {
+		reader_t first = *r;
+		size_t size = 0;
+		char *data;
+
+		// measure the strings first to use a single block like the parser
+		for (i = 0; i < 2 * ce->num_atts && !r->error; i++) {
+			const char *s = read_str(r);
+
+			if (s == NULL) {
+				r->error = 1;
+				break;
+			}
+			size += strlen(s) + 1;
+		}
+		if (r->error) {
+			ce->num_atts = 0;
+			return;
+		}
+
+		ce->atts = calloc(2 * ce->num_atts, sizeof(char *));
+		data = malloc(size);
+		if (ce->atts == NULL || data == NULL) {
+			free(ce->atts);
+			free(data);
+			ce->atts = NULL;
+			ce->num_atts = 0;
+			r->error = 1;
+			return;
+		}
+		*r = first;
+		for (i = 0; i < 2 * ce->num_atts; i++) {
+			const char *s = read_str(r);
+
+			strcpy(data, s);
+			ce->atts[i] = data;
+			data += strlen(s) + 1;
+		}
+	}
+
+	ce->value = read_strdup(r);
+
+	ce->num_children = read_count(r, sizeof(uint32_t));
+	if (ce->num_children > 0) {
+		if ((ce->children = calloc(ce->num_children, sizeof(cp_cfg_element_t))) == NULL) {
+			ce->num_children = 0;
+			r->error = 1;
+			return;
+		}
+		for (i = 0; i < ce->num_children && !r->error; i++) {
+			read_cfg_element(r, ce->children + i, ce, i);
+		}
+	}
+}
+
+static cp_plugin_info_t *read_plugin(reader_t *r, const char *path) {
+	cp_plugin_info_t *plugin;
+	unsigned int i;
+
+	if ((plugin = calloc(1, sizeof(cp_plugin_info_t))) == NULL) {
+		return NULL;
+	}
+
+	plugin->identifier = read_strdup(r);
+	plugin->name = read_strdup(r);
+	plugin->version = read_strdup(r);
+	plugin->provider_name = read_strdup(r);
+	plugin->abi_bw_compatibility = read_strdup(r);
+	plugin->api_bw_compatibility = read_strdup(r);
+	plugin->req_cpluff_version = read_strdup(r);
+	plugin->runtime_lib_name = read_strdup(r);
+	plugin->runtime_funcs_symbol = read_strdup(r);
+	if ((plugin->plugin_path = strdup(path)) == NULL) {
+		r->error = 1;
+	}
+
+	plugin->num_imports = read_count(r, 3 * sizeof(uint32_t));
+	if (!r->error && plugin->num_imports > 0) {
+		if ((plugin->imports = calloc(plugin->num_imports, sizeof(cp_plugin_import_t))) == NULL) {
+			plugin->num_imports = 0;
+			r->error = 1;
+		}
+		for (i = 0; i < plugin->num_imports && !r->error; i++) {
+			plugin->imports[i].plugin_id = read_strdup(r);
+			plugin->imports[i].version = read_strdup(r);
+			plugin->imports[i].optional = (int) read_u32(r);
+		}
+	}
+
+	plugin->num_ext_points = read_count(r, 4 * sizeof(uint32_t));
+	if (!r->error && plugin->num_ext_points > 0) {
+		if ((plugin->ext_points = calloc(plugin->num_ext_points, sizeof(cp_ext_point_t))) == NULL) {
+			plugin->num_ext_points = 0;
+			r->error = 1;
+		}
+		for (i = 0; i < plugin->num_ext_points && !r->error; i++) {
+			plugin->ext_points[i].plugin = plugin;
+			plugin->ext_points[i].local_id = read_strdup(r);
+			plugin->ext_points[i].identifier = read_strdup(r);
+			plugin->ext_points[i].name = read_strdup(r);
+			plugin->ext_points[i].schema_path = read_strdup(r);
+		}
+	}
+
+	plugin->num_extensions = read_count(r, 5 * sizeof(uint32_t));
+	if (!r->error && plugin->num_extensions > 0) {
+		if ((plugin->extensions = calloc(plugin->num_extensions, sizeof(cp_extension_t))) == NULL) {
+			plugin->num_extensions = 0;
+			r->error = 1;
+		}
+		for (i = 0; i < plugin->num_extensions && !r->error; i++) {
+			cp_extension_t *ext = plugin->extensions + i;
+
+			ext->plugin = plugin;
+			ext->ext_point_id = read_strdup(r);
+			ext->local_id = read_strdup(r);
+			ext->identifier = read_strdup(r);
+			ext->name = read_strdup(r);
+			if (read_u32(r) && !r->error) {
+				if ((ext->configuration = calloc(1, sizeof(cp_cfg_element_t))) == NULL) {
+					r->error = 1;
+				} else {
+					read_cfg_element(r, ext->configuration, NULL, 0);
+				}
+			}
+		}
+	}
+
+	if (r->error || plugin->identifier == NULL) {
+		cpi_free_plugin(plugin);
+		return NULL;
+	}
+	return plugin;
+}
+
+
+/* ------------------------------------------------------------------------
+ * Writing
+ * ----------------------------------------------------------------------*/
+
+static void write_data(cpi_dcache_t *dcache, const void *data, size_t size) {
+	if (dcache->failed) {
+		return;
+	}
+	if (dcache->out_size + size > dcache->out_capacity) {
+		size_t capacity = dcache->out_capacity ? dcache->out_capacity : 64 * 1024;
+		unsigned char *out;
+
+		while (capacity < dcache->out_size + size) {
+			capacity *= 2;
+		}
+		if ((out = realloc(dcache->out, capacity)) == NULL) {
+			dcache->failed = 1;
+			return;
+		}
+		dcache->out = out;
+		dcache->out_capacity = capacity;
+	}
+	memcpy(dcache->out + dcache->out_size, data, size);
+	dcache->out_size += size;
+}
+
+static void write_u32(cpi_dcache_t *dcache, uint32_t v) {
+	write_data(dcache, &v, sizeof(v));
+}
+
+static void write_i64(cpi_dcache_t *dcache, int64_t v) {
+	write_data(dcache, &v, sizeof(v));
+}
+
+static void write_str(cpi_dcache_t *dcache, const char *s) {
+	if (s == NULL) {
+		write_u32(dcache, CPI_DCACHE_NULL_STR);
+	} else {
+		size_t len = strlen(s);
+		write_u32(dcache, (uint32_t) len);
+		write_data(dcache, s, len + 1);
+	}
+}
+
+static void write_cfg_element(cpi_dcache_t *dcache, const cp_cfg_element_t *ce) {
+	unsigned int i;
+
+	write_str(dcache, ce->name);
+	write_u32(dcache, ce->num_atts);
+	for (i = 0; i < 2 * ce->num_atts; i++) {
+		write_str(dcache, ce->atts[i]);
+	}
+	write_str(dcache, ce->value);
+	write_u32(dcache, ce->num_children);
+	for (i = 0; i < ce->num_children; i++) {
+		write_cfg_element(dcache, ce->children + i);
+	}
+}
+
+static void write_plugin(cpi_dcache_t *dcache, const cp_plugin_info_t *plugin) {
+	unsigned int i;
+
+	write_str(dcache, plugin->identifier);
+	write_str(dcache, plugin->name);
+	write_str(dcache, plugin->version);
+	write_str(dcache, plugin->provider_name);
+	write_str(dcache, plugin->abi_bw_compatibility);
+	write_str(dcache, plugin->api_bw_compatibility);
+	write_str(dcache, plugin->req_cpluff_version);
+	write_str(dcache, plugin->runtime_lib_name);
+	write_str(dcache, plugin->runtime_funcs_symbol);
+
+	write_u32(dcache, plugin->num_imports);
+	for (i = 0; i < plugin->num_imports; i++) {
+		write_str(dcache, plugin->imports[i].plugin_id);
+		write_str(dcache, plugin->imports[i].version);
+		write_u32(dcache, (uint32_t) plugin->imports[i].optional);
+	}
+
+	write_u32(dcache, plugin->num_ext_points);
+	for (i = 0; i < plugin->num_ext_points; i++) {
+		write_str(dcache, plugin->ext_points[i].local_id);
+		write_str(dcache, plugin->ext_points[i].identifier);
+		write_str(dcache, plugin->ext_points[i].name);
+		write_str(dcache, plugin->ext_points[i].schema_path);
+	}
+
+	write_u32(dcache, plugin->num_extensions);
+	for (i = 0; i < plugin->num_extensions; i++) {
+		const cp_extension_t *ext = plugin->extensions + i;
+
+		write_str(dcache, ext->ext_point_id);
+		write_str(dcache, ext->local_id);
+		write_str(dcache, ext->identifier);
+		write_str(dcache, ext->name);
+		write_u32(dcache, ext->configuration != NULL);
+		if (ext->configuration != NULL) {
+			write_cfg_element(dcache, ext->configuration);
+		}
+	}
+}
+
+/**
+ * Returns the modification time of a file in nanoseconds. Falls back to
+ * whole seconds where the platform does not provide a finer resolution.
+ */
+static int64_t stat_mtime(const struct stat *st) {
+#if defined(__APPLE__)
+	return (int64_t) st->st_mtimespec.tv_sec * 1000000000 + st->st_mtimespec.tv_nsec;
+#elif defined(__linux__) || defined(__ANDROID__) || defined(__FreeBSD__)
+	return (int64_t) st->st_mtim.tv_sec * 1000000000 + st->st_mtim.tv_nsec;
+#else
+	return (int64_t) st->st_mtime * 1000000000;
+#endif
+}
+
+/**
+ * Appends a record for a loaded descriptor to the new snapshot.
+ */
+static void add_record(cpi_dcache_t *dcache, const char *path, const struct stat *st, const cp_plugin_info_t *plugin) {
+	size_t start = dcache->out_size;
+	uint32_t len;
+
+	write_u32(dcache, 0);
+	write_i64(dcache, stat_mtime(st));
+	write_i64(dcache, (int64_t) st->st_size);
+	write_str(dcache, path);
+	write_plugin(dcache, plugin);
+	if (dcache->failed) {
+		return;
+	}
+
+	// patch in the record length now that it is known
+	len = (uint32_t) (dcache->out_size - start - sizeof(len));
+	memcpy(dcache->out + start, &len, sizeof(len));
+	dcache->out_count++;
+}
+
+
+/* ------------------------------------------------------------------------
+ * Snapshot file handling
+ * ----------------------------------------------------------------------*/
+
+static void unmap_snapshot(cpi_dcache_t *dcache) {
+	if (dcache->map == NULL) {
+		return;
+	}
+#ifndef _WIN32
+	if (dcache->mapped) {
+		munmap(dcache->map, dcache->map_size);
+	} else
+#endif
+	{
+		free(dcache->map);
+	}
+	dcache->map = NULL;
+	dcache->map_size = 0;
+}
+
+static int map_snapshot(cpi_dcache_t *dcache, const char *file) {
+#ifndef _WIN32
+	struct stat st;
+	int fd;
+	void *map;
+
+	if ((fd = open(file, O_RDONLY)) < 0) {
+		return 0;
+	}
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		close(fd);
+		return 0;
+	}
+	map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		return 0;
+	}
+	dcache->map = map;
+	dcache->map_size = (size_t) st.st_size;
+	dcache->mapped = 1;
+	return 1;
+#else
+	FILE *fh;
+	long size;
+
+	if ((fh = fopen(file, "rb")) == NULL) {
+		return 0;
+	}
+	if (fseek(fh, 0, SEEK_END) != 0 || (size = ftell(fh)) <= 0 || fseek(fh, 0, SEEK_SET) != 0
+		|| (dcache->map = malloc((size_t) size)) == NULL) {
+		fclose(fh);
+		return 0;
+	}
+	dcache->map_size = fread(dcache->map, 1, (size_t) size, fh);
+	dcache->mapped = 0;
+	fclose(fh);
+	return dcache->map_size == (size_t) size;
+#endif
+}
+
+/**
+ * Indexes the records of the mapped snapshot by plug-in path.
+ */
+static int index_snapshot(cpi_dcache_t *dcache) {
+	reader_t r;
+	uint32_t count, i;
+
+	r.pos = dcache->map;
+	r.end = dcache->map + dcache->map_size;
+	r.error = 0;
+
+	if (dcache->map_size < 4 || memcmp(r.pos, CPI_DCACHE_MAGIC, 4) != 0) {
+		return 0;
+	}
+	r.pos += 4;
+	if (read_u32(&r) != CPI_DCACHE_VERSION) {
+		return 0;
+	}
+	count = read_u32(&r);
+	for (i = 0; i < count && !r.error; i++) {
+		uint32_t len = read_u32(&r);
+		const unsigned char *record = r.pos;
+		reader_t path_reader;
+		const char *path;
+
+		if (r.error || (size_t) (r.end - r.pos) < len) {
+			return 0;
+		}
+		path_reader.pos = record + 2 * sizeof(int64_t);
+		path_reader.end = record + len;
+		path_reader.error = 0;
+		path = read_str(&path_reader);
+		if (path == NULL || hash_lookup(dcache->entries, path) != NULL) {
+			return 0;
+		}
+		if (!hash_alloc_insert(dcache->entries, path, (void *) record)) {
+			return 0;
+		}
+		r.pos += len;
+	}
+	return !r.error;
+}
+
+static void write_snapshot(cp_context_t *context, cpi_dcache_t *dcache, const char *file) {
+	char *tmp;
+	FILE *fh;
+	int ok;
+	uint32_t header[2];
+
+	if ((tmp = malloc(strlen(file) + 5)) == NULL) {
+		return;
+	}
+	strcpy(tmp, file);
+	strcat(tmp, ".tmp");
+
+	header[0] = CPI_DCACHE_VERSION;
+	header[1] = dcache->out_count;
+	if ((fh = fopen(tmp, "wb")) == NULL) {
+		cpi_debugf(context, N_("Could not write the plug-in descriptor cache %s."), tmp);
+		free(tmp);
+		return;
+	}
+	ok = fwrite(CPI_DCACHE_MAGIC, 1, 4, fh) == 4
+		&& fwrite(header, sizeof(header), 1, fh) == 1
+		&& (dcache->out_size == 0 || fwrite(dcache->out, dcache->out_size, 1, fh) == 1);
+	ok = (fclose(fh) == 0) && ok;
+
+#ifdef _WIN32
+	if (ok) {
+		remove(file);
+	}
+#endif
+	if (!ok || rename(tmp, file) != 0) {
+		cpi_debugf(context, N_("Could not write the plug-in descriptor cache %s."), file);
+		remove(tmp);
+	}
+	free(tmp);
+}
+
+
+/* ------------------------------------------------------------------------
+ * Function definitions
+ * ----------------------------------------------------------------------*/
+
+static void dealloc_plugin_info(cp_context_t *ctx, cp_plugin_info_t *plugin) {
+	cpi_free_plugin(plugin);
+}
+
+CP_C_API cp_status_t cp_set_descriptor_cache(cp_context_t *context, const char *file) {
+	char *f = NULL;
+
+	CHECK_NOT_NULL(context);
+
+	if (file != NULL && (f = strdup(file)) == NULL) {
+		return CP_ERR_RESOURCE;
+	}
+	cpi_lock_context(context);
+	cpi_check_invocation(context, CPI_CF_ANY, __func__);
+	free(context->env->descriptor_cache);
+	context->env->descriptor_cache = f;
+	cpi_unlock_context(context);
+	return CP_OK;
+}
+
+CP_HIDDEN cpi_dcache_t *cpi_open_dcache(cp_context_t *context) {
+	cpi_dcache_t *dcache;
+
+	if (context->env->descriptor_cache == NULL) {
+		return NULL;
+	}
+	if ((dcache = calloc(1, sizeof(cpi_dcache_t))) == NULL) {
+		return NULL;
+	}
+	if ((dcache->entries = hash_create(HASHCOUNT_T_MAX, (int (*)(const void *, const void *)) strcmp, NULL)) == NULL) {
+		free(dcache);
+		return NULL;
+	}
+
+	if (!map_snapshot(dcache, context->env->descriptor_cache)) {
+		dcache->dirty = 1;
+	} else if (!index_snapshot(dcache)) {
+		cpi_warnf(context, N_("Ignoring invalid plug-in descriptor cache %s."), context->env->descriptor_cache);
+		hash_free_nodes(dcache->entries);
+		unmap_snapshot(dcache);
+		dcache->dirty = 1;
+	}
+	return dcache;
+}
+
+CP_HIDDEN cp_plugin_info_t *cpi_load_cached_descriptor(cp_context_t *context, cpi_dcache_t *dcache, const char *path, cp_status_t *error) {
+	cp_plugin_info_t *plugin = NULL;
+	struct stat st;
+	char *file;
+	hnode_t *node;
+	size_t len;
+	int have_stat;
+
+	if (dcache == NULL) {
+		return cp_load_plugin_descriptor(context, path, error);
+	}
+
+	if ((file = malloc(strlen(path) + strlen(CPI_DCACHE_DESCRIPTOR) + 2)) == NULL) {
+		return cp_load_plugin_descriptor(context, path, error);
+	}
+	len = strlen(path);
+	strcpy(file, path);
+	if (len == 0 || path[len - 1] != CP_FNAMESEP_CHAR) {
+		file[len++] = CP_FNAMESEP_CHAR;
+	}
+	strcpy(file + len, CPI_DCACHE_DESCRIPTOR);
+	have_stat = stat(file, &st) == 0;
+	free(file);
+
+	// restore from the snapshot if the descriptor did not change
+	if (have_stat && (node = hash_lookup(dcache->entries, path)) != NULL) {
+		reader_t r;
+		uint32_t record_len;
+
+		r.pos = hnode_get(node);
+		memcpy(&record_len, r.pos - sizeof(record_len), sizeof(record_len));
+		r.end = r.pos + record_len;
+		r.error = 0;
+		if (read_i64(&r) == stat_mtime(&st) && read_i64(&r) == (int64_t) st.st_size) {
+			read_str(&r);
+			plugin = read_plugin(&r, path);
+			if (plugin != NULL && cpi_register_info(context, plugin, (void (*)(cp_context_t *, void *)) dealloc_plugin_info) != CP_OK) {
+				cpi_free_plugin(plugin);
+				plugin = NULL;
+			}
+		}
+	}
+
+	if (plugin != NULL) {
+		dcache->hits++;
+		if (error != NULL) {
+			*error = CP_OK;
+		}
+	} else {
+		dcache->dirty = 1;
+		plugin = cp_load_plugin_descriptor(context, path, error);
+	}
+
+	if (plugin != NULL && have_stat) {
+		add_record(dcache, path, &st, plugin);
+	}
+	return plugin;
+}
+
+CP_HIDDEN void cpi_close_dcache(cp_context_t *context, cpi_dcache_t *dcache) {
+	if (dcache == NULL) {
+		return;
+	}
+
+	// descriptors that vanished also change the snapshot
+	if (dcache->hits != hash_count(dcache->entries)) {
+		dcache->dirty = 1;
+	}
+	if (dcache->dirty && !dcache->failed) {
+		write_snapshot(context, dcache, context->env->descriptor_cache);
+	}
+	cpi_debugf(context, N_("Restored %u of %u plug-in descriptors from the descriptor cache."), dcache->hits, (unsigned int) dcache->out_count);
+
+	hash_free_nodes(dcache->entries);
+	hash_destroy(dcache->entries);
+	unmap_snapshot(dcache);
+	free(dcache->out);
+	free(dcache);
+}
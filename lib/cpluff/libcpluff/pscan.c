@@ -51,6 +51,7 @@ CP_C_API cp_status_t cp_scan_plugins(cp_context_t *context, int flags) {
 	hash_t *avail_plugins = NULL;
 	list_t *started_plugins = NULL;
 	cp_plugin_info_t **plugins = NULL;
+	cpi_dcache_t *dcache = NULL;
 	char *pdir_path = NULL;
 	int pdir_path_size = 0;
 	int plugins_stopped = 0;
@@ -72,6 +73,9 @@ CP_C_API cp_status_t cp_scan_plugins(cp_context_t *context, int flags) {
 			break;
 		}
 	
+		// Open the descriptor cache, if any 
+		dcache = cpi_open_dcache(context);
+	
 		// Scan plug-in directories for available plug-ins 
 		lnode = list_first(context->env->plugin_dirs);
 		while (lnode != NULL) {
@@ -122,7 +126,7 @@ CP_C_API cp_status_t cp_scan_plugins(cp_context_t *context, int flags) {
 						strcpy(pdir_path + dir_path_len + 1, de->d_name);
 							
 						// Try to load a plug-in 
-						plugin = cp_load_plugin_descriptor(context, pdir_path, &s);
+						plugin = cpi_load_cached_descriptor(context, dcache, pdir_path, &s);
 						if (plugin == NULL) {
 							status = s;
 							// continue loading plug-ins from other directories 
@@ -166,6 +170,10 @@ CP_C_API cp_status_t cp_scan_plugins(cp_context_t *context, int flags) {
 			lnode = list_next(context->env->plugin_dirs, lnode);
 		}
 		
+		// Update the descriptor cache 
+		cpi_close_dcache(context, dcache);
+		dcache = NULL;
+		
 		// Copy the list of started plug-ins, if necessary 
 		if ((flags & CP_SP_RESTART_ACTIVE)
 			&& (flags & (CP_SP_UPGRADE | CP_SP_STOP_ALL_ON_INSTALL))) {
@@ -281,6 +289,9 @@ CP_C_API cp_status_t cp_scan_plugins(cp_context_t *context, int flags) {
 			cpi_warn(context, N_("Not all directories were successfully scanned."));
 			break;
 	}
+	if (dcache != NULL) {
+		cpi_close_dcache(context, dcache);
+	}
 	cpi_unlock_context(context);
 	
 	// Release resources 
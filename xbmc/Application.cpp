@@ -20,6 +20,7 @@
 
 #include "network/EventServer.h"
 #include "network/Network.h"
+#include "threads/LockProfiler.h"
 #include "threads/SystemClock.h"
 #include "Application.h"
 #include "AppInboundProtocol.h"
@@ -27,6 +28,7 @@
 #include "events/EventLog.h"
 #include "events/NotificationEvent.h"
 #include "interfaces/builtins/Builtins.h"
+#include "utils/FrameTrace.h"
 #include "utils/JobManager.h"
 #include "utils/Variant.h"
 #include "LangInfo.h"
@@ -1804,6 +1806,8 @@ bool CApplication::LoadCustomWindows()
 
 void CApplication::Render()
 {
+  FRAME_TRACE_ZONE("CApplication::Render");
+
   // do not render if we are stopped or in background
   if (m_bStop)
     return;
@@ -2622,6 +2626,8 @@ void CApplication::UnlockFrameMoveGuard()
 
 void CApplication::FrameMove(bool processEvents, bool processGUI)
 {
+  FRAME_TRACE_ZONE("CApplication::FrameMove");
+
   if (processEvents)
   {
     // currently we calculate the repeat time (ie time from last similar keypress) just global as fps
@@ -2912,6 +2918,8 @@ void CApplication::Stop(int exitCode)
     m_pActiveAE->Shutdown();
     m_pActiveAE.reset();
 
+    CLockProfiler::Log();
+
     CLog::Log(LOGNOTICE, "stopped");
   }
   catch (...)
@@ -4262,6 +4270,8 @@ void CApplication::ShowAppMigrationMessage()
 
 void CApplication::Process()
 {
+  FRAME_TRACE_ZONE("CApplication::Process");
+
   // dispatch the messages generated by python or other threads to the current window
   CServiceBroker::GetGUI()->GetWindowManager().DispatchThreadMessages();
 
@@ -38,7 +38,7 @@ CApplicationPlayer::CApplicationPlayer()
 
 std::shared_ptr<IPlayer> CApplicationPlayer::GetInternal() const
 {
-  CSingleLock lock(m_playerLock);
+  CSharedLock lock(m_playerLock);
   return m_pPlayer;
 }
 
@@ -50,7 +50,7 @@ void CApplicationPlayer::ClosePlayer()
   {
     CloseFile();
     // we need to do this directly on the member
-    CSingleLock lock(m_playerLock);
+    CExclusiveLock lock(m_playerLock);
     m_pPlayer.reset();
   }
 }
@@ -66,7 +66,7 @@ void CApplicationPlayer::CloseFile(bool reopen)
 
 void CApplicationPlayer::CreatePlayer(const CPlayerCoreFactory &factory, const std::string &player, IPlayerCallback& callback)
 {
-  CSingleLock lock(m_playerLock);
+  CExclusiveLock lock(m_playerLock);
   if (!m_pPlayer)
   {
     CDataCacheCore::GetInstance().Reset();
@@ -121,7 +121,7 @@ bool CApplicationPlayer::OpenFile(const CFileItem& item, const CPlayerOptions& o
       CloseFile();
       if (player->m_name != newPlayer)
       {
-        CSingleLock lock(m_playerLock);
+        CExclusiveLock lock(m_playerLock);
         m_pPlayer.reset();
       }
       return true;
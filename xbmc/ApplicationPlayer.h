@@ -24,7 +24,7 @@
 #include <string>
 #include <vector>
 
-#include "threads/CriticalSection.h"
+#include "threads/SharedSection.h"
 #include "threads/SystemClock.h"
 #include "windowing/Resolution.h"
 #include "cores/IPlayer.h"
@@ -168,7 +168,7 @@ private:
   void CloseFile(bool reopen = false);
 
   std::shared_ptr<IPlayer> m_pPlayer;
-  CCriticalSection m_playerLock;
+  CSharedSection m_playerLock{"CApplicationPlayer"};
   CSeekHandler m_seekHandler;
 
   // cache player state
@@ -58,7 +58,8 @@ bool InfoBoolComparator(const InfoPtr &right, const InfoPtr &left)
 CGUIInfoManager::CGUIInfoManager(void)
 : m_currentFile(new CFileItem),
   m_bools(&InfoBoolComparator),
-  m_refreshCounter(0)
+  m_refreshCounter(0),
+  m_skinSettingsRefreshCounter(1)
 {
 }
 
@@ -6406,6 +6407,19 @@ INFO::InfoPtr CGUIInfoManager::Register(const std::string &expression, int conte
   return *(res.first);
 }
 
+void CGUIInfoManager::GetInfoBools(std::vector<INFO::InfoPtr> &bools)
+{
+  CSingleLock lock(m_critInfo);
+  bools.assign(m_bools.begin(), m_bools.end());
+}
+
+void CGUIInfoManager::ResetInfoBoolProfiles()
+{
+  CSingleLock lock(m_critInfo);
+  for (auto &info : m_bools)
+    info->ResetProfile();
+}
+
 bool CGUIInfoManager::EvaluateBool(const std::string &expression, int contextWindow /* = 0 */, const CGUIListItemPtr &item /* = nullptr */)
 {
   INFO::InfoPtr info = Register(expression, contextWindow);
@@ -6701,6 +6715,8 @@ void CGUIInfoManager::Clear()
 {
   CSingleLock lock(m_critInfo);
   m_skinVariableStrings.clear();
+  // the next skin has its own settings
+  ++m_skinSettingsRefreshCounter;
 
   /*
     Erase any info bools that are unused. We do this repeatedly as each run
@@ -6934,6 +6950,26 @@ void CGUIInfoManager::ResetCache()
   ++m_refreshCounter;
 }
 
+void CGUIInfoManager::ResetSkinSettingsCache()
+{
+  CSingleLock lock(m_critInfo);
+  ++m_skinSettingsRefreshCounter;
+}
+
+unsigned int& CGUIInfoManager::GetRefreshCounter(int condition)
+{
+  condition = std::abs(condition);
+  if (condition >= MULTI_INFO_START && condition <= MULTI_INFO_END)
+  {
+    CSingleLock lock(m_critInfo);
+    int info = m_multiInfo[condition - MULTI_INFO_START].m_info;
+    // skin settings only change through CSkinSettings
+    if (info == SKIN_BOOL || info == SKIN_STRING)
+      return m_skinSettingsRefreshCounter;
+  }
+  return m_refreshCounter;
+}
+
 void CGUIInfoManager::SetCurrentVideoTag(const CVideoInfoTag &tag)
 {
   m_currentFile->SetFromVideoInfoTag(tag);
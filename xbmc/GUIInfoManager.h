@@ -73,6 +73,11 @@ public:
   void Clear();
   void ResetCache();
 
+  /*! \brief Mark the conditions on skin settings as dirty
+   Those are not refreshed every frame, so this has to be called whenever a skin setting changes.
+   */
+  void ResetSkinSettingsCache();
+
   // KODI::MESSAGING::IMessageTarget implementation
   int GetMessageMask() override;
   void OnApplicationMessage(KODI::MESSAGING::ThreadMessage* pMsg) override;
@@ -89,8 +94,19 @@ public:
    */
   INFO::InfoPtr Register(const std::string &expression, int context = 0);
 
+  /*! \brief Fetch all registered conditions and expressions
+   Used to report their evaluation profile.
+   \param bools [out] the registered info bools
+   \sa INFO::InfoBool::SetProfiling
+   */
+  void GetInfoBools(std::vector<INFO::InfoPtr> &bools);
+
+  /*! \brief Reset the evaluation profile of all registered conditions and expressions
+   */
+  void ResetInfoBoolProfiles();
+
   /// \brief iterates through boolean conditions and compares their stored values to current values. Returns true if any condition changed value.
-  bool ConditionsChangedValues(const std::map<INFO::InfoPtr, bool>& map);
+  static bool ConditionsChangedValues(const std::map<INFO::InfoPtr, bool>& map);
 
   /*! \brief Evaluate a boolean expression
    \param expression the expression to evaluate
@@ -103,6 +119,13 @@ public:
   int TranslateString(const std::string &strCondition);
   int TranslateSingleString(const std::string &strCondition, bool &listItemDependent);
 
+  /*! \brief Get the counter that invalidates the cached value of the given condition
+   Conditions are refreshed every frame unless the provider of their value signals its changes.
+   \param condition the translated condition
+   \return the refresh counter the condition has to follow
+   */
+  unsigned int& GetRefreshCounter(int condition);
+
   std::string GetLabel(int info, int contextWindow = 0, std::string *fallback = nullptr) const;
   std::string GetImage(int info, int contextWindow, std::string *fallback = nullptr);
   bool GetInt(int &value, int info, int contextWindow = 0, const CGUIListItem *item = nullptr) const;
@@ -210,6 +233,7 @@ private:
   typedef std::set<INFO::InfoPtr, bool(*)(const INFO::InfoPtr&, const INFO::InfoPtr&)> INFOBOOLTYPE;
   INFOBOOLTYPE m_bools;
   unsigned int m_refreshCounter;
+  unsigned int m_skinSettingsRefreshCounter;
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
 
   CCriticalSection m_critInfo;
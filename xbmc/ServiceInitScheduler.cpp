@@ -0,0 +1,194 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ServiceInitScheduler.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+
+#include <chrono>
+
+namespace
+{
+CCriticalSection timelineSection;
+std::vector<ServiceInitRecord> timeline;
+std::chrono::steady_clock::time_point timelineOrigin;
+bool timelineStarted = false;
+
+int64_t TimelineNow()
+{
+  CSingleLock lock(timelineSection);
+  auto now = std::chrono::steady_clock::now();
+  if (!timelineStarted)
+  {
+    timelineOrigin = now;
+    timelineStarted = true;
+  }
+  return std::chrono::duration_cast<std::chrono::microseconds>(now - timelineOrigin).count();
+}
+}
+
+CServiceInitScheduler::CServiceInitScheduler(const std::string &stage) :
+  m_stage(stage)
+{
+}
+
+void CServiceInitScheduler::Add(const std::string &name, const std::vector<std::string> &dependencies,
+                                std::function<bool()> init, bool worker)
+{
+  Step step;
+  step.name = name;
+  step.dependencyNames = dependencies;
+  step.init = std::move(init);
+  step.worker = worker;
+  step.record.name = name;
+  step.record.stage = m_stage;
+  step.record.worker = worker;
+  m_steps.push_back(std::move(step));
+}
+
+bool CServiceInitScheduler::IsReady(const Step &step) const
+{
+  for (size_t dependency : step.dependencies)
+  {
+    if (m_steps[dependency].state != State::DONE)
+      return false;
+  }
+  return true;
+}
+
+void CServiceInitScheduler::Execute(size_t index)
+{
+  Step &step = m_steps[index];
+
+  step.record.start = TimelineNow();
+  bool success = step.init();
+  step.record.end = TimelineNow();
+  step.record.success = success;
+
+  if (!success)
+    CLog::Log(LOGERROR, "CServiceInitScheduler::%s: %s failed in stage %s", __FUNCTION__, step.name.c_str(), m_stage.c_str());
+
+  CSingleLock lock(m_section);
+  step.state = success ? State::DONE : State::FAILED;
+  m_finished.Set();
+}
+
+bool CServiceInitScheduler::Run()
+{
+  // resolve dependencies, they have to be added before the steps using them
+  for (size_t i = 0; i < m_steps.size(); i++)
+  {
+    for (const auto &name : m_steps[i].dependencyNames)
+    {
+      size_t dependency = 0;
+      while (dependency < i && m_steps[dependency].name != name)
+        dependency++;
+      if (dependency == i)
+      {
+        CLog::Log(LOGERROR, "CServiceInitScheduler::%s: %s depends on unknown step %s", __FUNCTION__, m_steps[i].name.c_str(), name.c_str());
+        return false;
+      }
+      m_steps[i].dependencies.push_back(dependency);
+    }
+  }
+
+  const int64_t stageStart = TimelineNow();
+  bool failed = false;
+
+  CSingleLock lock(m_section);
+  while (true)
+  {
+    size_t running = 0;
+    size_t pending = 0;
+    size_t inlineStep = m_steps.size();
+
+    for (size_t i = 0; i < m_steps.size(); i++)
+    {
+      Step &step = m_steps[i];
+      if (step.state == State::FAILED)
+        failed = true;
+      else if (step.state == State::RUNNING)
+        running++;
+      else if (step.state == State::PENDING)
+      {
+        pending++;
+        if (failed || !IsReady(step))
+          continue;
+
+        if (step.worker)
+        {
+          step.state = State::RUNNING;
+          running++;
+          CJobManager::GetInstance().Submit([this, i]() {
+            Execute(i);
+          }, CJob::PRIORITY_HIGH);
+        }
+        else if (inlineStep == m_steps.size())
+          inlineStep = i;
+      }
+    }
+
+    if (inlineStep < m_steps.size())
+    {
+      m_steps[inlineStep].state = State::RUNNING;
+      lock.Leave();
+      Execute(inlineStep);
+      lock.Enter();
+    }
+    else if (running > 0)
+    {
+      lock.Leave();
+      m_finished.Wait();
+      lock.Enter();
+    }
+    else
+    {
+      if (pending > 0 && !failed)
+        CLog::Log(LOGERROR, "CServiceInitScheduler::%s: %u steps of stage %s can never start", __FUNCTION__, (unsigned int)pending, m_stage.c_str());
+      failed = failed || pending > 0;
+      break;
+    }
+  }
+  lock.Leave();
+
+  const int64_t stageEnd = TimelineNow();
+
+  CSingleLock timelineLock(timelineSection);
+  for (const auto &step : m_steps)
+  {
+    if (step.state == State::PENDING)
+      continue;
+
+    CLog::Log(LOGINFO, "CServiceInitScheduler: %s/%s %.1f ms - %.1f ms%s%s", m_stage.c_str(), step.name.c_str(),
+              step.record.start / 1000.0, step.record.end / 1000.0,
+              step.worker ? " (worker)" : "", step.record.success ? "" : " FAILED");
+    timeline.push_back(step.record);
+  }
+  CLog::Log(LOGNOTICE, "CServiceInitScheduler: stage %s took %.1f ms", m_stage.c_str(), (stageEnd - stageStart) / 1000.0);
+
+  return !failed;
+}
+
+std::vector<ServiceInitRecord> CServiceInitScheduler::GetTimeline()
+{
+  CSingleLock lock(timelineSection);
+  return timeline;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <functional>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+/*!
+ \brief Start and end of one service initialisation step
+ */
+struct ServiceInitRecord
+{
+  std::string name;
+  std::string stage;
+  int64_t start = 0;    ///< microseconds since the first step of the first stage started
+  int64_t end = 0;
+  bool worker = false;  ///< true if the step ran on a worker thread
+  bool success = false;
+};
+
+/*!
+ \brief Runs service initialisation steps in dependency order.
+
+ Each step names the steps it depends on. A step is started as soon as all of
+ them finished successfully. Steps that are safe to run off the calling thread
+ are submitted to the job manager, all others run on the calling thread in the
+ order they were added. Once a step fails no further steps are started.
+
+ Every step is recorded in a process wide startup timeline.
+ */
+class CServiceInitScheduler
+{
+public:
+  explicit CServiceInitScheduler(const std::string &stage);
+
+  /*!
+   \brief Add a step
+   \param name unique name of the step, used by other steps to depend on it
+   \param dependencies names of steps that need to finish before this one starts
+   \param init the work, returns false on failure
+   \param worker true if the step may run on a worker thread
+   */
+  void Add(const std::string &name, const std::vector<std::string> &dependencies,
+           std::function<bool()> init, bool worker = false);
+
+  /*!
+   \brief Run all steps and wait for them
+   \return true if all steps succeeded
+   */
+  bool Run();
+
+  /*!
+   \brief Get all steps recorded since startup
+   */
+  static std::vector<ServiceInitRecord> GetTimeline();
+
+private:
+  enum class State
+  {
+    PENDING,
+    RUNNING,
+    DONE,
+    FAILED
+  };
+
+  struct Step
+  {
+    std::string name;
+    std::vector<size_t> dependencies;
+    std::vector<std::string> dependencyNames;
+    std::function<bool()> init;
+    bool worker;
+    State state = State::PENDING;
+    ServiceInitRecord record;
+  };
+
+  bool IsReady(const Step &step) const;
+  void Execute(size_t index);
+
+  std::string m_stage;
+  std::vector<Step> m_steps;
+  CCriticalSection m_section;
+  CEvent m_finished;
+};
@@ -19,6 +19,7 @@
  */
 
 #include "ServiceManager.h"
+#include "ServiceInitScheduler.h"
 #include "addons/BinaryAddonCache.h"
 #include "addons/VFSEntry.h"
 #include "addons/binary-addons/BinaryAddonManager.h"
@@ -137,62 +138,129 @@ bool CServiceManager::InitStageOnePointFive()
 
 bool CServiceManager::InitStageTwo(const CAppParamParser &params)
 {
-  // Initialize the addon database (must be before the addon manager is init'd)
-  m_databaseManager.reset(new CDatabaseManager);
-
-  m_Platform.reset(CPlatform::CreateInstance());
-  m_Platform->Init();
-
-  m_binaryAddonManager.reset(new ADDON::CBinaryAddonManager()); /* Need to constructed before, GetRunningInstance() of binary CAddonDll need to call them */
-  m_addonMgr.reset(new ADDON::CAddonMgr());
-  if (!m_addonMgr->Init())
-  {
-    CLog::Log(LOGFATAL, "CServiceManager::%s: Unable to start CAddonMgr", __FUNCTION__);
-    return false;
-  }
+  // Steps marked as worker run in parallel to the others once their
+  // dependencies are done, everything else runs on this thread in order.
+  CServiceInitScheduler scheduler("two");
 
-  if (!m_binaryAddonManager->Init())
-  {
-    CLog::Log(LOGFATAL, "CServiceManager::%s: Unable to initialize CBinaryAddonManager", __FUNCTION__);
+  // Initialize the addon database (must be before the addon manager is init'd)
+  scheduler.Add("database", {}, [this]() {
+    m_databaseManager.reset(new CDatabaseManager);
+    return true;
+  });
+
+  scheduler.Add("platform", {}, [this]() {
+    m_Platform.reset(CPlatform::CreateInstance());
+    m_Platform->Init();
+    return true;
+  });
+
+  // CPlatform::Init sets up the environment (e.g. SSL_CERT_FILE), which must
+  // not change while worker steps may read it
+  scheduler.Add("addons", { "database", "platform" }, [this]() {
+    m_binaryAddonManager.reset(new ADDON::CBinaryAddonManager()); /* Need to constructed before, GetRunningInstance() of binary CAddonDll need to call them */
+    m_addonMgr.reset(new ADDON::CAddonMgr());
+    if (!m_addonMgr->Init())
+    {
+      CLog::Log(LOGFATAL, "CServiceManager::%s: Unable to start CAddonMgr", __FUNCTION__);
+      return false;
+    }
+    return true;
+  }, true);
+
+  scheduler.Add("binaryaddons", { "addons" }, [this]() {
+    if (!m_binaryAddonManager->Init())
+    {
+      CLog::Log(LOGFATAL, "CServiceManager::%s: Unable to initialize CBinaryAddonManager", __FUNCTION__);
+      return false;
+    }
+    return true;
+  }, true);
+
+  scheduler.Add("repositoryupdater", { "addons" }, [this]() {
+    m_repositoryUpdater.reset(new ADDON::CRepositoryUpdater(*m_addonMgr));
+    return true;
+  });
+
+  scheduler.Add("vfsaddoncache", { "binaryaddons" }, [this]() {
+    m_vfsAddonCache.reset(new ADDON::CVFSAddonCache());
+    m_vfsAddonCache->Init();
+    return true;
+  }, true);
+
+  scheduler.Add("pvr", { "addons" }, [this]() {
+    m_PVRManager.reset(new PVR::CPVRManager());
+    return true;
+  });
+
+  scheduler.Add("datacache", {}, [this]() {
+    m_dataCacheCore.reset(new CDataCacheCore());
+    return true;
+  });
+
+  scheduler.Add("binaryaddoncache", { "binaryaddons" }, [this]() {
+    m_binaryAddonCache.reset( new ADDON::CBinaryAddonCache());
+    m_binaryAddonCache->Init();
+    return true;
+  }, true);
+
+  scheduler.Add("favourites", {}, [this]() {
+    m_favouritesService.reset(new CFavouritesService(m_profileManager->GetProfileUserDataFolder()));
+    return true;
+  }, true);
+
+  scheduler.Add("serviceaddons", { "addons" }, [this]() {
+    m_serviceAddons.reset(new ADDON::CServiceAddonManager(*m_addonMgr));
+    return true;
+  });
+
+  scheduler.Add("contextmenu", { "addons" }, [this]() {
+    m_contextMenuManager.reset(new CContextMenuManager(*m_addonMgr.get()));
+    return true;
+  });
+
+  scheduler.Add("gamecontrollers", {}, [this]() {
+    m_gameControllerManager.reset(new GAME::CControllerManager);
+    return true;
+  });
+
+  scheduler.Add("input", {}, [this, &params]() {
+    m_inputManager.reset(new CInputManager(params));
+    m_inputManager->InitializeInputs();
+    return true;
+  });
+
+  scheduler.Add("peripherals", { "input", "gamecontrollers" }, [this]() {
+    m_peripherals.reset(new PERIPHERALS::CPeripherals(*m_announcementManager,
+                                                      *m_inputManager,
+                                                      *m_gameControllerManager));
+    return true;
+  });
+
+  scheduler.Add("gamerender", {}, [this]() {
+    m_gameRenderManager.reset(new RETRO::CGUIGameRenderManager);
+    return true;
+  });
+
+  scheduler.Add("fileextensions", { "binaryaddons" }, [this]() {
+    m_fileExtensionProvider.reset(new CFileExtensionProvider(*m_addonMgr,
+                                                             *m_binaryAddonManager));
+    return true;
+  });
+
+  scheduler.Add("power", {}, [this]() {
+    m_powerManager.reset(new CPowerManager());
+    m_powerManager->Initialize();
+    m_powerManager->SetDefaults();
+    return true;
+  });
+
+  scheduler.Add("weather", {}, [this]() {
+    m_weatherManager.reset(new CWeatherManager());
+    return true;
+  });
+
+  if (!scheduler.Run())
     return false;
-  }
-
-  m_repositoryUpdater.reset(new ADDON::CRepositoryUpdater(*m_addonMgr));
-
-  m_vfsAddonCache.reset(new ADDON::CVFSAddonCache());
-  m_vfsAddonCache->Init();
-
-  m_PVRManager.reset(new PVR::CPVRManager());
-
-  m_dataCacheCore.reset(new CDataCacheCore());
-
-  m_binaryAddonCache.reset( new ADDON::CBinaryAddonCache());
-  m_binaryAddonCache->Init();
-
-  m_favouritesService.reset(new CFavouritesService(m_profileManager->GetProfileUserDataFolder()));
-
-  m_serviceAddons.reset(new ADDON::CServiceAddonManager(*m_addonMgr));
-
-  m_contextMenuManager.reset(new CContextMenuManager(*m_addonMgr.get()));
-
-  m_gameControllerManager.reset(new GAME::CControllerManager);
-  m_inputManager.reset(new CInputManager(params));
-  m_inputManager->InitializeInputs();
-
-  m_peripherals.reset(new PERIPHERALS::CPeripherals(*m_announcementManager,
-                                                    *m_inputManager,
-                                                    *m_gameControllerManager));
-
-  m_gameRenderManager.reset(new RETRO::CGUIGameRenderManager);
-
-  m_fileExtensionProvider.reset(new CFileExtensionProvider(*m_addonMgr,
-                                                           *m_binaryAddonManager));
-
-  m_powerManager.reset(new CPowerManager());
-  m_powerManager->Initialize();
-  m_powerManager->SetDefaults();
-
-  m_weatherManager.reset(new CWeatherManager());
 
   init_level = 2;
   return true;
@@ -201,20 +269,41 @@ bool CServiceManager::InitStageTwo(const CAppParamParser &params)
 // stage 3 is called after successful initialization of WindowManager
 bool CServiceManager::InitStageThree()
 {
-  // Peripherals depends on strings being loaded before stage 3
-  m_peripherals->Initialise();
+  CServiceInitScheduler scheduler("three");
 
-  m_gameServices.reset(new GAME::CGameServices(*m_gameControllerManager,
-    *m_gameRenderManager,
-    *m_settings,
-    *m_peripherals,
-    *m_profileManager));
-
-  m_contextMenuManager->Init();
-  m_PVRManager->Init();
-
-  m_playerCoreFactory.reset(new CPlayerCoreFactory(*m_settings,
-                                                   *m_profileManager));
+  // Peripherals depends on strings being loaded before stage 3
+  scheduler.Add("peripherals", {}, [this]() {
+    m_peripherals->Initialise();
+    return true;
+  });
+
+  scheduler.Add("gameservices", { "peripherals" }, [this]() {
+    m_gameServices.reset(new GAME::CGameServices(*m_gameControllerManager,
+      *m_gameRenderManager,
+      *m_settings,
+      *m_peripherals,
+      *m_profileManager));
+    return true;
+  });
+
+  scheduler.Add("contextmenu", {}, [this]() {
+    m_contextMenuManager->Init();
+    return true;
+  });
+
+  scheduler.Add("pvr", {}, [this]() {
+    m_PVRManager->Init();
+    return true;
+  });
+
+  scheduler.Add("playercores", {}, [this]() {
+    m_playerCoreFactory.reset(new CPlayerCoreFactory(*m_settings,
+                                                     *m_profileManager));
+    return true;
+  });
+
+  if (!scheduler.Run())
+    return false;
 
   init_level = 3;
   return true;
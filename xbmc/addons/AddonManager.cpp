@@ -313,6 +313,12 @@ bool CAddonMgr::Init()
   //! @todo could separate addons into different contexts would allow partial unloading of addon framework
   m_cp_context = cp_create_context(&status);
   assert(m_cp_context);
+
+  // keep parsed manifests between scans so only changed add-ons are parsed again
+  status = cp_set_descriptor_cache(m_cp_context, CSpecialProtocol::TranslatePath("special://temp/addon-manifests.cache").c_str());
+  if (status != CP_OK)
+    CLog::Log(LOGWARNING, "ADDONS: cp_set_descriptor_cache() returned status: %i", status);
+
   status = cp_register_pcollection(m_cp_context, CSpecialProtocol::TranslatePath("special://home/addons").c_str());
   if (status != CP_OK)
   {
@@ -34,6 +34,10 @@ std::unique_ptr<CPluginSource> CPluginSource::FromExtension(CAddonInfo addonInfo
   std::string provides = CServiceBroker::GetAddonMgr().GetExtValue(ext->configuration, "provides");
   if (!provides.empty())
     addonInfo.AddExtraInfo("provides", provides);
+  // plugins that can be invoked repeatedly in the same interpreter
+  std::string reuseLanguageInvoker = CServiceBroker::GetAddonMgr().GetExtValue(ext->configuration, "reuselanguageinvoker");
+  if (!reuseLanguageInvoker.empty())
+    addonInfo.AddExtraInfo("reuselanguageinvoker", reuseLanguageInvoker);
   return std::unique_ptr<CPluginSource>(new CPluginSource(std::move(addonInfo), provides));
 }
 
@@ -744,8 +744,17 @@ bool CAESinkALSA::InitializeHW(const ALSAConfig &inconfig, ALSAConfig &outconfig
    will cause problems with menu sounds. Buffer will be increased
    after those are fixed.
   */
-  periodSize  = std::min(periodSize, (snd_pcm_uframes_t) sampleRate / 20);
-  bufferSize  = std::min(bufferSize, (snd_pcm_uframes_t) sampleRate / 5);
+  if (g_advancedSettings.m_audioLowLatency)
+  {
+    /* low latency mode: periods of approx 10 ms, 40 ms buffer */
+    periodSize  = std::min(periodSize, (snd_pcm_uframes_t) sampleRate / 100);
+    bufferSize  = std::min(bufferSize, (snd_pcm_uframes_t) sampleRate / 25);
+  }
+  else
+  {
+    periodSize  = std::min(periodSize, (snd_pcm_uframes_t) sampleRate / 20);
+    bufferSize  = std::min(bufferSize, (snd_pcm_uframes_t) sampleRate / 5);
+  }
   
   /* 
    According to upstream we should set buffer size first - so make sure it is always at least
@@ -27,39 +27,42 @@
 //#define AE_RING_BUFFER_DEBUG
 
 #include "utils/log.h"  //CLog
+#include <atomic>
 #include <string.h>     //memset, memcpy
 #ifdef TARGET_POSIX
 #include "platform/linux/XMemUtils.h"
 #endif
 
+#define AE_RING_BUFFER_CACHELINE 64
+
 /**
- * This buffer can be used by one read and one write thread at any one time
- * without the risk of data corruption.
+ * Single producer, single consumer ring buffer for interleaved (one plane)
+ * or planar audio.
+ *
+ * One thread may write and one thread may read at any one time. Write and
+ * Read are wait-free: each side owns its position, publishes its counter
+ * with release semantics and caches the counter of the other side, so the
+ * shared cache lines are only touched when the cached value runs out.
  * If you intend to call the Reset() method, please use Locks.
- * All other operations are thread-safe.
  */
 class AERingBuffer {
 
 public:
   AERingBuffer() :
-    m_iReadPos(0),
-    m_iWritePos(0),
-    m_iRead(0),
-    m_iWritten(0),
     m_iSize(0),
     m_planes(0),
-    m_Buffer(NULL)
+    m_Buffer(NULL),
+    m_iWritten(0),
+    m_iWritePos(0),
+    m_iReadCache(0),
+    m_iRead(0),
+    m_iReadPos(0),
+    m_iWrittenCache(0)
   {
   }
 
   AERingBuffer(unsigned int size, unsigned int planes = 1) :
-    m_iReadPos(0),
-    m_iWritePos(0),
-    m_iRead(0),
-    m_iWritten(0),
-    m_iSize(0),
-    m_planes(0),
-    m_Buffer(NULL)
+    AERingBuffer()
   {
     Create(size, planes);
   }
@@ -84,7 +87,7 @@ public:
     m_Buffer = new unsigned char*[planes];
     for (unsigned int i = 0; i < planes; i++)
     {
-      m_Buffer[i] = (unsigned char*)_aligned_malloc(size,16);
+      m_Buffer[i] = (unsigned char*)_aligned_malloc(size, AE_RING_BUFFER_CACHELINE);
       if (!m_Buffer[i])
         return false;
       memset(m_Buffer[i], 0, size);
@@ -103,27 +106,32 @@ public:
 #ifdef AE_RING_BUFFER_DEBUG
     CLog::Log(LOGDEBUG, "AERingBuffer::Reset: Buffer reset.");
 #endif
-    m_iWritten = 0;
-    m_iRead = 0;
+    m_iWritten.store(0, std::memory_order_relaxed);
+    m_iRead.store(0, std::memory_order_relaxed);
     m_iReadPos = 0;
     m_iWritePos = 0;
+    m_iReadCache = 0;
+    m_iWrittenCache = 0;
   }
 
   /**
    * Writes data to buffer.
    * Attempt to write more bytes than available results in AE_RING_BUFFER_FULL.
+   * Must only be called by the producer.
    *
    * @return AE_RING_BUFFER_OK on success, otherwise an error code
    */
   int Write(unsigned char *src, unsigned int size, unsigned int plane = 0)
   {
-    unsigned int space = GetWriteSize();
+    unsigned int written = m_iWritten.load(std::memory_order_relaxed);
 
     //do we have enough space for all the data?
-    if (size > space || plane >= m_planes)
+    if (size > m_iSize - (written - m_iReadCache))
+      m_iReadCache = m_iRead.load(std::memory_order_acquire);
+    if (size > m_iSize - (written - m_iReadCache) || plane >= m_planes)
     {
 #ifdef AE_RING_BUFFER_DEBUG
-    CLog::Log(LOGDEBUG, "AERingBuffer: Not enough space, ignoring data. Requested: %u Available: %u",size, space);
+    CLog::Log(LOGDEBUG, "AERingBuffer: Not enough space, ignoring data. Requested: %u Available: %u",size, m_iSize - (written - m_iReadCache));
 #endif
       return AE_RING_BUFFER_FULL;
     }
@@ -132,7 +140,7 @@ public:
     if ( m_iSize > size + m_iWritePos )
     {
 #ifdef AE_RING_BUFFER_DEBUG
-      CLog::Log(LOGDEBUG, "AERingBuffer: Written to: %u size: %u space before: %u\n", m_iWritePos, size, space);
+      CLog::Log(LOGDEBUG, "AERingBuffer: Written to: %u size: %u\n", m_iWritePos, size);
 #endif
       memcpy(m_Buffer[plane] + m_iWritePos, src, size);
     }
@@ -142,7 +150,7 @@ public:
       unsigned int first = m_iSize - m_iWritePos;
       unsigned int second = size - first;
 #ifdef AE_RING_BUFFER_DEBUG
-      CLog::Log(LOGDEBUG, "AERingBuffer: Written to (split) first: %u second: %u size: %u space before: %u\n", first, second, size, space);
+      CLog::Log(LOGDEBUG, "AERingBuffer: Written to (split) first: %u second: %u size: %u\n", first, second, size);
 #endif
       memcpy(m_Buffer[plane] + m_iWritePos, src, first);
       memcpy(m_Buffer[plane], src + first, second);
@@ -157,12 +165,17 @@ public:
    * Reads data from buffer.
    * Attempt to read more bytes than available results in RING_BUFFER_NOTAVAILABLE.
    * Reading from empty buffer returns AE_RING_BUFFER_EMPTY
+   * Must only be called by the consumer.
    *
    * @return AE_RING_BUFFER_OK on success, otherwise an error code
    */
   int Read(unsigned char *dest, unsigned int size, unsigned int plane = 0)
   {
-    unsigned int space = GetReadSize();
+    unsigned int read = m_iRead.load(std::memory_order_relaxed);
+
+    if (size > m_iWrittenCache - read || m_iWrittenCache == read)
+      m_iWrittenCache = m_iWritten.load(std::memory_order_acquire);
+    unsigned int space = m_iWrittenCache - read;
 
     //want to read more than we have written?
     if( space == 0 )
@@ -186,7 +199,7 @@ public:
     if ( size + m_iReadPos < m_iSize )
     {
 #ifdef AE_RING_BUFFER_DEBUG
-      CLog::Log(LOGDEBUG, "AERingBuffer: Reading from: %u size: %u space before: %u\n", m_iWritePos, size, space);
+      CLog::Log(LOGDEBUG, "AERingBuffer: Reading from: %u size: %u space before: %u\n", m_iReadPos, size, space);
 #endif
       if (dest)
         memcpy(dest, m_Buffer[plane] + m_iReadPos, size);
@@ -239,7 +252,7 @@ public:
    */
   unsigned int GetWriteSize()
   {
-    return m_iSize - ( m_iWritten - m_iRead );
+    return m_iSize - (m_iWritten.load(std::memory_order_acquire) - m_iRead.load(std::memory_order_acquire));
   }
 
   /**
@@ -248,7 +261,7 @@ public:
    */
   unsigned int GetReadSize()
   {
-    return m_iWritten - m_iRead;
+    return m_iWritten.load(std::memory_order_acquire) - m_iRead.load(std::memory_order_acquire);
   }
 
   /**
@@ -268,7 +281,7 @@ public:
   }
 private:
   /**
-   * Increments the write pointer.
+   * Increments the write pointer and publishes the data to the reader.
    * Called at the end of writing to all planes.
    */
   void WriteFinished(unsigned int size)
@@ -279,11 +292,11 @@ private:
       m_iWritePos = size - (m_iSize - m_iWritePos);
 
     //we can increase the write count now
-    m_iWritten+=size;
+    m_iWritten.store(m_iWritten.load(std::memory_order_relaxed) + size, std::memory_order_release);
   }
 
   /**
-   * Increments the read pointer.
+   * Increments the read pointer and hands the space back to the writer.
    * Called at the end of reading to all planes.
    */
   void ReadFinished(unsigned int size)
@@ -294,14 +307,24 @@ private:
       m_iReadPos = size - (m_iSize - m_iReadPos);
 
     //we can increase the read count now
-    m_iRead+=size;
+    m_iRead.store(m_iRead.load(std::memory_order_relaxed) + size, std::memory_order_release);
   }
 
-  unsigned int m_iReadPos;
-  unsigned int m_iWritePos;
-  unsigned int m_iRead;
-  unsigned int m_iWritten;
+  // set up by Create, read-only afterwards
   unsigned int m_iSize;
   unsigned int m_planes;
   unsigned char **m_Buffer;
+  char m_padShared[AE_RING_BUFFER_CACHELINE];
+
+  // producer side
+  std::atomic<unsigned int> m_iWritten;
+  unsigned int m_iWritePos;
+  unsigned int m_iReadCache;     ///< last seen m_iRead
+  char m_padProducer[AE_RING_BUFFER_CACHELINE];
+
+  // consumer side
+  std::atomic<unsigned int> m_iRead;
+  unsigned int m_iReadPos;
+  unsigned int m_iWrittenCache;  ///< last seen m_iWritten
+  char m_padConsumer[AE_RING_BUFFER_CACHELINE];
 };
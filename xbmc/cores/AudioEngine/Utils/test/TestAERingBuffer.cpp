@@ -0,0 +1,146 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AERingBuffer.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+TEST(TestAERingBuffer, WrapAround)
+{
+  AERingBuffer buffer(16);
+  unsigned char in[12];
+  unsigned char out[12];
+  for (unsigned int i = 0; i < sizeof(in); i++)
+    in[i] = static_cast<unsigned char>(i + 1);
+
+  for (int round = 0; round < 5; round++)
+  {
+    EXPECT_EQ(0, buffer.Write(in, sizeof(in)));
+    EXPECT_EQ(12U, buffer.GetReadSize());
+    EXPECT_EQ(4U, buffer.GetWriteSize());
+    EXPECT_EQ(2, buffer.Write(in, sizeof(in)));
+    EXPECT_EQ(0, buffer.Read(out, sizeof(out)));
+    EXPECT_EQ(0, memcmp(in, out, sizeof(in)));
+    EXPECT_EQ(1, buffer.Read(out, 1));
+  }
+}
+
+TEST(TestAERingBuffer, Planar)
+{
+  AERingBuffer buffer(8, 2);
+  unsigned char left[4] = { 1, 2, 3, 4 };
+  unsigned char right[4] = { 5, 6, 7, 8 };
+  EXPECT_EQ(0, buffer.Write(left, 4, 0));
+  // data is only visible after the last plane was written
+  EXPECT_EQ(0U, buffer.GetReadSize());
+  EXPECT_EQ(0, buffer.Write(right, 4, 1));
+  EXPECT_EQ(4U, buffer.GetReadSize());
+
+  unsigned char out[4];
+  EXPECT_EQ(0, buffer.Read(out, 4, 0));
+  EXPECT_EQ(0, memcmp(left, out, 4));
+  EXPECT_EQ(0, buffer.Read(out, 4, 1));
+  EXPECT_EQ(0, memcmp(right, out, 4));
+  EXPECT_EQ(0U, buffer.GetReadSize());
+}
+
+// Producer fills the buffer as fast as it can, like ActiveAE does, while the
+// consumer takes one period per period duration, paced like a sink clocked by
+// its device. Every period carries its write time, the difference to the read
+// time is the delay the buffer adds between producer and consumer. As it
+// depends on the scheduler it only runs with --gtest_also_run_disabled_tests.
+TEST(TestAERingBuffer, DISABLED_PacedConsumerLatency)
+{
+  typedef std::chrono::steady_clock clock;
+  const unsigned int periodBytes = 96 * 2 * 4; // 2 ms of 48kHz stereo float
+  const unsigned int periods = 4;
+  const unsigned int total = 100;
+  const auto periodTime = std::chrono::microseconds(2000);
+
+  AERingBuffer buffer(periodBytes * periods);
+  std::atomic<bool> failed(false);
+  std::atomic<bool> stop(false);
+
+  std::thread producer([&]()
+  {
+    std::vector<unsigned char> period(periodBytes);
+    for (uint32_t i = 0; i < total; i++)
+    {
+      while (buffer.GetWriteSize() < periodBytes)
+      {
+        if (stop)
+          return;
+        std::this_thread::yield();
+      }
+      int64_t now = clock::now().time_since_epoch().count();
+      memcpy(period.data(), &i, sizeof(i));
+      memcpy(period.data() + sizeof(i), &now, sizeof(now));
+      if (buffer.Write(period.data(), periodBytes) != 0)
+        failed = true;
+    }
+  });
+
+  std::vector<unsigned char> period(periodBytes);
+  int64_t maxDelay = 0;
+  int64_t sumDelay = 0;
+  uint32_t received = 0;
+  auto next = clock::now();
+  for (uint32_t i = 0; i < total; i++)
+  {
+    next += periodTime;
+    std::this_thread::sleep_until(next);
+    while (buffer.GetReadSize() < periodBytes && !failed)
+      std::this_thread::yield();
+    if (failed)
+      break;
+    // the producer has to be joined before the test returns
+    if (buffer.Read(period.data(), periodBytes) != 0)
+    {
+      ADD_FAILURE() << "reading period " << i << " failed";
+      break;
+    }
+
+    uint32_t sequence;
+    int64_t written;
+    memcpy(&sequence, period.data(), sizeof(sequence));
+    memcpy(&written, period.data() + sizeof(sequence), sizeof(written));
+    EXPECT_EQ(i, sequence);
+
+    int64_t delay = clock::now().time_since_epoch().count() - written;
+    maxDelay = std::max(maxDelay, delay);
+    sumDelay += delay;
+    received++;
+  }
+  stop = true;
+  producer.join();
+
+  EXPECT_FALSE(failed);
+
+  typedef std::chrono::duration<int64_t, clock::period> ticks;
+  RecordProperty("AverageDelayMicroseconds", static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(ticks(sumDelay / std::max<uint32_t>(received, 1))).count()));
+  RecordProperty("MaxDelayMicroseconds", static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(ticks(maxDelay)).count()));
+}
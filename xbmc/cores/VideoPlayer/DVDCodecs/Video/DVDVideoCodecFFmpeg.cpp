@@ -431,6 +431,14 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     m_pCodecContext->skip_loop_filter = (AVDiscard)g_advancedSettings.m_iSkipLoopFilter;
   }
 
+  // only keyframes are wanted, e.g. for thumbnails, skip everything else and deblocking
+  if (hints.codecOptions & CODEC_KEYFRAMES_ONLY)
+  {
+    m_pCodecContext->skip_frame = AVDISCARD_NONKEY;
+    m_pCodecContext->skip_loop_filter = AVDISCARD_ALL;
+    m_pCodecContext->flags2 |= AV_CODEC_FLAG2_FAST;
+  }
+
   // set any special options
   for(std::vector<CDVDCodecOption>::iterator it = options.m_keys.begin(); it != options.m_keys.end(); ++it)
   {
@@ -775,7 +783,7 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
   else
     m_interlaced = false;
 
-  if (!m_started)
+  if (!m_started && !(m_hints.codecOptions & CODEC_KEYFRAMES_ONLY))
   {
     int frames = 300;
     if (m_dropCtrl.m_state == CDropControl::VALID)
@@ -1287,7 +1295,13 @@ void CDVDVideoCodecFFmpeg::SetCodecControl(int flags)
     else
       m_requestSkipDeint = false;
 
-    if (bDrop)
+    if (m_hints.codecOptions & CODEC_KEYFRAMES_ONLY)
+    {
+      m_pCodecContext->skip_frame = AVDISCARD_NONKEY;
+      m_pCodecContext->skip_idct = AVDISCARD_DEFAULT;
+      m_pCodecContext->skip_loop_filter = AVDISCARD_ALL;
+    }
+    else if (bDrop)
     {
       m_pCodecContext->skip_frame = AVDISCARD_NONREF;
       m_pCodecContext->skip_idct = AVDISCARD_NONREF;
@@ -104,6 +104,8 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
 {
   std::string redactPath = CURL::GetRedacted(strPath);
   unsigned int nTime = XbmcThreads::SystemClockMillis();
+  // details.file is relative to the thumbnail folder unless it's a full path
+  const std::string cachedPath = CURL::IsFullPath(details.file) ? details.file : CTextureCache::GetCachedPath(details.file);
   CFileItem item(strPath, false);
 
   item.SetMimeTypeForInternetFile();
@@ -203,7 +205,7 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
     pProcessInfo->SetPixFormats(pixFmts);
 
     CDVDStreamInfo hint(*pDemuxer->GetStream(demuxerId, nVideoStream), true);
-    hint.codecOptions = CODEC_FORCE_SOFTWARE;
+    hint.codecOptions = CODEC_FORCE_SOFTWARE | CODEC_KEYFRAMES_ONLY;
 
     pVideoCodec = CDVDFactoryCodec::CreateVideoCodec(hint, *pProcessInfo);
 
@@ -217,39 +219,87 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
       {
         CDVDVideoCodec::VCReturn iDecoderState = CDVDVideoCodec::VC_NONE;
         VideoPicture picture = {};
+        bool keyframesOnly = true;
+        bool endOfStream = false;
 
-        // num streams * 160 frames, should get a valid frame, if not abort.
-        int abort_index = pDemuxer->GetNrOfStreams() * 160;
-        do
+        auto decodeFrame = [&]()
         {
-          DemuxPacket* pPacket = pDemuxer->Read();
-          packetsTried++;
+          // num streams * 160 frames, should get a valid frame, if not abort.
+          int abort_index = pDemuxer->GetNrOfStreams() * 160;
+          const int DRAIN_AFTER_PACKETS = 8;
+          int videoPackets = 0;
+          do
+          {
+            DemuxPacket* pPacket = pDemuxer->Read();
+            packetsTried++;
 
-          if (!pPacket)
-            break;
+            if (!pPacket)
+            {
+              endOfStream = true;
+              break;
+            }
 
-          if (pPacket->iStreamId != nVideoStream)
-          {
+            if (pPacket->iStreamId != nVideoStream)
+            {
+              CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+              continue;
+            }
+
+            pVideoCodec->AddData(*pPacket);
             CDVDDemuxUtils::FreeDemuxPacket(pPacket);
-            continue;
-          }
 
-          pVideoCodec->AddData(*pPacket);
-          CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+            iDecoderState = CDVDVideoCodec::VC_NONE;
+            while (iDecoderState == CDVDVideoCodec::VC_NONE)
+            {
+              iDecoderState = pVideoCodec->GetPicture(&picture);
+            }
 
-          iDecoderState = CDVDVideoCodec::VC_NONE;
-          while (iDecoderState == CDVDVideoCodec::VC_NONE)
-          {
-            iDecoderState = pVideoCodec->GetPicture(&picture);
-          }
+            // the decoder only outputs keyframes but may still hold them back for
+            // reordering, squeeze them out instead of feeding more packets
+            if (keyframesOnly && iDecoderState == CDVDVideoCodec::VC_BUFFER &&
+                ++videoPackets % DRAIN_AFTER_PACKETS == 0)
+            {
+              pVideoCodec->SetCodecControl(DVD_CODEC_CTRL_DRAIN);
+              iDecoderState = CDVDVideoCodec::VC_NONE;
+              while (iDecoderState == CDVDVideoCodec::VC_NONE ||
+                     iDecoderState == CDVDVideoCodec::VC_BUFFER)
+              {
+                iDecoderState = pVideoCodec->GetPicture(&picture);
+              }
+              pVideoCodec->SetCodecControl(0);
+            }
+
+            if (iDecoderState == CDVDVideoCodec::VC_PICTURE)
+            {
+              if(!(picture.iFlags & DVP_FLAG_DROPPED))
+                break;
+            }
 
-          if (iDecoderState == CDVDVideoCodec::VC_PICTURE)
+          } while (abort_index--);
+        };
+
+        decodeFrame();
+
+        // streams without keyframes (e.g. h264 with recovery points only) never
+        // produce a picture when non-keyframes are discarded, decode them in full
+        if ((iDecoderState != CDVDVideoCodec::VC_PICTURE || (picture.iFlags & DVP_FLAG_DROPPED)) &&
+            !endOfStream)
+        {
+          CLog::Log(LOGDEBUG, "%s - no keyframe decoded in %s after %d packets, decoding all frames", __FUNCTION__, redactPath.c_str(), packetsTried);
+          if (picture.videoBuffer)
           {
-            if(!(picture.iFlags & DVP_FLAG_DROPPED))
-              break;
+            picture.videoBuffer->Release();
+            picture.videoBuffer = nullptr;
           }
+          delete pVideoCodec;
 
-        } while (abort_index--);
+          keyframesOnly = false;
+          hint.codecOptions = CODEC_FORCE_SOFTWARE;
+          iDecoderState = CDVDVideoCodec::VC_NONE;
+          pVideoCodec = CDVDFactoryCodec::CreateVideoCodec(hint, *pProcessInfo);
+          if (pVideoCodec && pDemuxer->SeekTime(nSeekTo, true))
+            decodeFrame();
+        }
 
         if (iDecoderState == CDVDVideoCodec::VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
         {
@@ -280,7 +330,7 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
 
               details.width = nWidth;
               details.height = nHeight;
-              CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
+              CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, cachedPath);
               bOk = true;
             }
             av_free(pOutBuf);
@@ -301,7 +351,7 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
   if(!bOk)
   {
     XFILE::CFile file;
-    if(file.OpenForWrite(CTextureCache::GetCachedPath(details.file)))
+    if(file.OpenForWrite(cachedPath))
       file.Close();
   }
 
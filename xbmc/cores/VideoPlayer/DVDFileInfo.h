@@ -35,6 +35,7 @@ class CDVDFileInfo
 {
 public:
   // Extract a thumbnail image from the media at strPath, optionally populating a streamdetails class with the data
+  // The thumbnail is written to details.file, relative to the thumbnail folder unless it's a full path
   static bool ExtractThumb(const std::string &strPath,
                            CTextureDetails &details,
                            CStreamDetails *pStreamDetails, int pos=-1);
@@ -19,18 +19,16 @@
  */
 
 #include "DVDSubtitleLineCollection.h"
-#include <stddef.h>
 
+#include <algorithm>
 
-CDVDSubtitleLineCollection::CDVDSubtitleLineCollection()
+namespace
 {
-  m_pHead = NULL;
-  m_pCurrent = NULL;
-  m_pTail = NULL;
-
-  m_iSize = 0;
+const size_t INDEX_BLOCK_SIZE = 64;
 }
 
+CDVDSubtitleLineCollection::CDVDSubtitleLineCollection() = default;
+
 CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
 {
   Clear();
@@ -38,85 +36,65 @@ CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
 
 void CDVDSubtitleLineCollection::Add(CDVDOverlay* pOverlay)
 {
-  ListElement* pElement = new ListElement;
-  pElement->pOverlay = pOverlay;
-  pElement->pNext = NULL;
+  m_overlays.push_back(pOverlay);
+  m_indexValid = false;
+}
 
-  if (!m_pHead)
-  {
-    m_pHead = m_pTail = pElement;
-    m_pCurrent = m_pHead;
-  }
-  else
+void CDVDSubtitleLineCollection::Sort()
+{
+  std::stable_sort(m_overlays.begin(), m_overlays.end(), [](const CDVDOverlay* a, const CDVDOverlay* b)
   {
-    m_pTail->pNext = pElement;
-    m_pTail = pElement;
-  }
-
-  m_iSize++;
+    return a->iPTSStartTime < b->iPTSStartTime;
+  });
+  m_indexValid = false;
 }
 
-void CDVDSubtitleLineCollection::Sort()
+void CDVDSubtitleLineCollection::BuildIndex()
 {
-  if (!m_pHead || !m_pHead->pNext)
-    return;
-  
-  for (ListElement* p1 = m_pHead; p1->pNext != NULL; p1 = p1->pNext)
+  m_blockStop.assign((m_overlays.size() + INDEX_BLOCK_SIZE - 1) / INDEX_BLOCK_SIZE, 0.0);
+  for (size_t i = 0; i < m_overlays.size(); i++)
   {
-    for (ListElement* p2 = p1->pNext; p2 != NULL; p2 = p2->pNext)
-    {
-      if (p1->pOverlay->iPTSStartTime > p2->pOverlay->iPTSStartTime)
-      {
-        CDVDOverlay* temp = p1->pOverlay;
-        p1->pOverlay = p2->pOverlay;
-        p2->pOverlay = temp;
-      }
-    }
+    double& stop = m_blockStop[i / INDEX_BLOCK_SIZE];
+    if (i % INDEX_BLOCK_SIZE == 0 || m_overlays[i]->iPTSStopTime > stop)
+      stop = m_overlays[i]->iPTSStopTime;
   }
+  m_indexValid = true;
 }
 
 CDVDOverlay* CDVDSubtitleLineCollection::Get(double iPts)
 {
-  CDVDOverlay* pOverlay = NULL;
+  if (!m_indexValid)
+    BuildIndex();
 
-  if (m_pCurrent)
+  while (m_current < m_overlays.size())
   {
-    while (m_pCurrent && m_pCurrent->pOverlay->iPTSStopTime < iPts)
+    if (m_current % INDEX_BLOCK_SIZE == 0 && m_blockStop[m_current / INDEX_BLOCK_SIZE] < iPts)
+      m_current += INDEX_BLOCK_SIZE;
+    else if (m_overlays[m_current]->iPTSStopTime < iPts)
+      m_current++;
+    else
     {
-      m_pCurrent = m_pCurrent->pNext;
-    }
-
-    if (m_pCurrent)
-    {
-      pOverlay = m_pCurrent->pOverlay;
-
-      // advance to the next overlay
-      m_pCurrent = m_pCurrent->pNext;
+      // return it and advance to the next overlay
+      return m_overlays[m_current++];
     }
   }
-  return pOverlay;
+
+  m_current = m_overlays.size();
+  return NULL;
 }
 
 void CDVDSubtitleLineCollection::Reset()
 {
-  m_pCurrent = m_pHead;
+  m_current = 0;
 }
 
 void CDVDSubtitleLineCollection::Clear()
 {
-  ListElement* pElement = NULL;
-
-  while (m_pHead)
-  {
-    pElement = m_pHead;
-    m_pHead = pElement->pNext;
-
-    pElement->pOverlay->Release();
-    delete pElement;
-  }
+  for (CDVDOverlay* overlay : m_overlays)
+    overlay->Release();
 
-  m_pTail    = NULL;
-  m_pHead    = NULL;
-  m_pCurrent = NULL;
-  m_iSize    = 0;
+  m_overlays.clear();
+  m_blockStop.clear();
+  m_indexValid = false;
+  m_current = 0;
 }
@@ -40,7 +40,8 @@ bool CDVDSubtitleParserSSA::Open(CDVDStreamInfo &hints)
   if (!CDVDSubtitleParserText::Open())
     return false;
 
-  std::string buffer = m_pStream->m_stringstream.str();
+  // libass parses the buffer in place, it is not needed afterwards
+  std::string buffer = m_pStream->TakeBuffer();
   if(!m_libass->CreateTrack((char*) buffer.c_str(), buffer.length()))
     return false;
 
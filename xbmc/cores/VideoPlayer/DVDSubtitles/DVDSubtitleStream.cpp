@@ -18,6 +18,7 @@
  *
  */
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 
@@ -57,45 +58,43 @@ bool CDVDSubtitleStream::Open(const std::string& strFile)
 
     static const size_t chunksize = 64 * 1024;
 
+    // read into the string that is kept, so valid UTF-8 is never copied
+    std::string content(buf.get(), totalread);
+    buf.clear();
+
+    int64_t length = pInputStream->GetLength();
+    if (length > 0)
+      content.reserve(static_cast<size_t>(length) + chunksize);
+
     int read;
     do
     {
-      if (totalread == buf.size())
-        buf.resize(buf.size() + chunksize);
-
-      read = pInputStream->Read((uint8_t*)buf.get() + totalread, buf.size() - totalread);
-      if (read > 0)
-        totalread += read;
+      size_t size = content.size();
+      content.resize(size + chunksize);
+      read = pInputStream->Read(reinterpret_cast<uint8_t*>(&content[size]), chunksize);
+      content.resize(size + std::max(read, 0));
     } while (read > 0);
 
-    if (!totalread)
+    if (content.empty())
       return false;
 
-    std::string tmpStr(buf.get(), totalread);
-    buf.clear();
-
-    std::string enc(CCharsetDetection::GetBomEncoding(tmpStr));
-    if (enc == "UTF-8" || (enc.empty() && CUtf8Utils::isValidUtf8(tmpStr)))
-      m_stringstream << tmpStr;
-    else if (!enc.empty())
-    {
-      std::string converted;
-      g_charsetConverter.ToUtf8(enc, tmpStr, converted);
-      if (converted.empty())
-        return false;
-
-      m_stringstream << converted;
-    }
+    std::string enc(CCharsetDetection::GetBomEncoding(content));
+    if (enc == "UTF-8" || (enc.empty() && CUtf8Utils::isValidUtf8(content)))
+      m_buffer = std::move(content);
     else
     {
       std::string converted;
-      g_charsetConverter.subtitleCharsetToUtf8(tmpStr, converted);
+      if (!enc.empty())
+        g_charsetConverter.ToUtf8(enc, content, converted);
+      else
+        g_charsetConverter.subtitleCharsetToUtf8(content, converted);
       if (converted.empty())
         return false;
 
-      m_stringstream << converted;
+      m_buffer = std::move(converted);
     }
 
+    m_position = 0;
     return true;
   }
 
@@ -131,37 +130,62 @@ bool CDVDSubtitleStream::IsIncompatible(CDVDInputStream* pInputStream, XUTILS::a
 
 int CDVDSubtitleStream::Read(char* buf, int buf_size)
 {
-  return (int)m_stringstream.readsome(buf, buf_size);
+  if (buf_size <= 0 || m_position >= m_buffer.size())
+    return 0;
+
+  size_t size = std::min(static_cast<size_t>(buf_size), m_buffer.size() - m_position);
+  memcpy(buf, m_buffer.data() + m_position, size);
+  m_position += size;
+  return static_cast<int>(size);
 }
 
 long CDVDSubtitleStream::Seek(long offset, int whence)
 {
+  int64_t position;
   switch (whence)
   {
     case SEEK_CUR:
-    {
-      m_stringstream.seekg(offset, std::ios::cur);
+      position = static_cast<int64_t>(m_position) + offset;
       break;
-    }
     case SEEK_END:
-    {
-      m_stringstream.seekg(offset, std::ios::end);
+      position = static_cast<int64_t>(m_buffer.size()) + offset;
       break;
-    }
     case SEEK_SET:
-    {
-      m_stringstream.seekg(offset, std::ios::beg);
+      position = offset;
       break;
-    }
+    default:
+      return -1;
   }
-  return (int)m_stringstream.tellg();
+
+  if (position < 0 || position > static_cast<int64_t>(m_buffer.size()))
+    return -1;
+
+  m_position = static_cast<size_t>(position);
+  return static_cast<long>(m_position);
 }
 
 char* CDVDSubtitleStream::ReadLine(char* buf, int iLen)
 {
-  if (m_stringstream.getline(buf, iLen))
-    return buf;
-  else
+  if (iLen <= 0 || m_position >= m_buffer.size())
     return NULL;
+
+  const char* start = m_buffer.data() + m_position;
+  size_t remaining = m_buffer.size() - m_position;
+  const char* end = static_cast<const char*>(memchr(start, '\n', remaining));
+  size_t length = end ? end - start : remaining;
+  m_position += end ? length + 1 : length;
+
+  // overlong lines are cut, reading continues with the next line
+  size_t size = std::min(length, static_cast<size_t>(iLen - 1));
+  memcpy(buf, start, size);
+  buf[size] = '\0';
+  return buf;
 }
 
+std::string CDVDSubtitleStream::TakeBuffer()
+{
+  std::string buffer = std::move(m_buffer);
+  m_buffer.clear();
+  m_position = 0;
+  return buffer;
+}
@@ -23,7 +23,6 @@
 #include "utils/auto_buffer.h"
 
 #include <string>
-#include <sstream>
 
 class CDVDInputStream;
 
@@ -49,6 +48,12 @@ public:
   char* ReadLine(char* pBuffer, int iLen);
   //wchar* ReadLineW(wchar* pBuffer, int iLen) { return NULL; };
 
-  std::stringstream m_stringstream;
+  /*! \brief Hand the UTF-8 content over to the caller, the stream is empty afterwards
+   */
+  std::string TakeBuffer();
+
+private:
+  std::string m_buffer;
+  size_t m_position = 0;
 };
 
@@ -103,6 +103,7 @@ bool CDVDSubtitlesLibass::DecodeHeader(char* data, int size)
   }
 
   ass_process_codec_private(m_track, data, size);
+  m_eventCount = m_track->n_events;
   return true;
 }
 
@@ -116,6 +117,7 @@ bool CDVDSubtitlesLibass::DecodeDemuxPkt(char* data, int size, double start, dou
   }
 
   ass_process_chunk(m_track, data, size, DVD_TIME_TO_MSEC(start), DVD_TIME_TO_MSEC(duration));
+  m_eventCount = m_track->n_events;
   return true;
 }
 
@@ -134,6 +136,8 @@ bool CDVDSubtitlesLibass::CreateTrack(char* buf, size_t size)
   if(m_track == NULL)
     return false;
 
+  m_eventCount = m_track->n_events;
+
   return true;
 }
 
@@ -170,9 +174,6 @@ ASS_Event* CDVDSubtitlesLibass::GetEvents()
 
 int CDVDSubtitlesLibass::GetNrOfEvents()
 {
-  CSingleLock lock(m_section);
-  if(!m_track)
-    return 0;
-  return m_track->n_events;
+  return m_eventCount;
 }
 
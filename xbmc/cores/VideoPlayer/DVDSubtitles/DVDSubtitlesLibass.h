@@ -25,6 +25,8 @@
 
 #include <ass/ass.h>
 
+#include <atomic>
+
  /** Wrapper for Libass **/
 
 class CDVDSubtitlesLibass : public IDVDResourceCounted<CDVDSubtitlesLibass>
@@ -36,6 +38,8 @@ public:
   ASS_Image* RenderImage(int frameWidth, int frameHeight, int videoWidth, int videoHeight, double pts, int useMargin = 0, double position = 0.0, int* changes = NULL);
   ASS_Event* GetEvents();
 
+  /*! \brief Number of events in the track, does not wait for a frame being rendered
+   */
   int GetNrOfEvents();
 
   bool DecodeHeader(char* data, int size);
@@ -47,5 +51,6 @@ private:
   ASS_Track* m_track = nullptr;
   ASS_Renderer* m_renderer = nullptr;
   CCriticalSection m_section;
+  std::atomic<int> m_eventCount{0};
 };
 
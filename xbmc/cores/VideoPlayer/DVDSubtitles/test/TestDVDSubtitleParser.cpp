@@ -0,0 +1,169 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/DVDStreamInfo.h"
+#include "cores/VideoPlayer/DVDSubtitles/DVDFactorySubtitle.h"
+#include "cores/VideoPlayer/DVDSubtitles/DVDSubtitleParser.h"
+#include "cores/VideoPlayer/DVDSubtitles/DVDSubtitleStream.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+
+namespace
+{
+// every entry is shown for 1.5 seconds, one entry every 2 seconds
+std::string GenerateSubrip(int entries)
+{
+  std::string srt;
+  srt.reserve(entries * 80);
+  for (int i = 0; i < entries; i++)
+  {
+    int start = i * 2000;
+    int stop = start + 1500;
+    srt += StringUtils::Format("%d\r\n%02d:%02d:%02d,%03d --> %02d:%02d:%02d,%03d\r\n",
+                               i + 1,
+                               start / 3600000, start / 60000 % 60, start / 1000 % 60, start % 1000,
+                               stop / 3600000, stop / 60000 % 60, stop / 1000 % 60, stop % 1000);
+    srt += StringUtils::Format("Line %d of the generated subtitle\r\n<i>second line</i>\r\n\r\n", i + 1);
+  }
+  return srt;
+}
+
+XFILE::CFile* WriteTempFile(const std::string& content)
+{
+  XFILE::CFile* file = XBMC_CREATETEMPFILE(".srt");
+  if (!file)
+    return nullptr;
+  file->Close();
+  if (!file->OpenForWrite(XBMC_TEMPFILEPATH(file), true) ||
+      file->Write(content.c_str(), content.size()) != static_cast<ssize_t>(content.size()))
+  {
+    XBMC_DELETETEMPFILE(file);
+    return nullptr;
+  }
+  file->Close();
+  return file;
+}
+
+// seeks to spread out positions and returns how often the parser didn't
+// return the entry shown there, it returns the first entry not over yet
+int LookupEntries(CDVDSubtitleParser& parser, int entries, int lookups)
+{
+  int mismatches = 0;
+  for (int i = 0; i < lookups; i++)
+  {
+    int entry = static_cast<int>((static_cast<int64_t>(i) * 7919) % entries);
+    double pts = (entry * 2000.0 + 500) * (DVD_TIME_BASE / 1000);
+    parser.Reset();
+    CDVDOverlay* overlay = parser.Parse(pts);
+    if (!overlay || overlay->iPTSStartTime != entry * 2000.0 * (DVD_TIME_BASE / 1000))
+      mismatches++;
+    if (overlay)
+      overlay->Release();
+  }
+  return mismatches;
+}
+}
+
+TEST(TestDVDSubtitleStream, ReadLine)
+{
+  XFILE::CFile* file;
+  ASSERT_NE(nullptr, file = WriteTempFile("first\nsecond line that is too long\n\nlast"));
+
+  CDVDSubtitleStream stream;
+  ASSERT_TRUE(stream.Open(XBMC_TEMPFILEPATH(file)));
+
+  char line[12];
+  ASSERT_NE(nullptr, stream.ReadLine(line, sizeof(line)));
+  EXPECT_STREQ("first", line);
+  ASSERT_NE(nullptr, stream.ReadLine(line, sizeof(line)));
+  EXPECT_STREQ("second line", line);
+  ASSERT_NE(nullptr, stream.ReadLine(line, sizeof(line)));
+  EXPECT_STREQ("", line);
+  ASSERT_NE(nullptr, stream.ReadLine(line, sizeof(line)));
+  EXPECT_STREQ("last", line);
+  EXPECT_EQ(nullptr, stream.ReadLine(line, sizeof(line)));
+
+  EXPECT_EQ(6, stream.Seek(6, SEEK_SET));
+  EXPECT_EQ(6, stream.Read(line, 6));
+  EXPECT_EQ(0, memcmp(line, "second", 6));
+  EXPECT_EQ(-1, stream.Seek(1, SEEK_END));
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
+TEST(TestDVDSubtitleParser, LargeSubrip)
+{
+  const int entries = 5000;
+
+  XFILE::CFile* file;
+  ASSERT_NE(nullptr, file = WriteTempFile(GenerateSubrip(entries)));
+  std::string path = XBMC_TEMPFILEPATH(file);
+
+  std::unique_ptr<CDVDSubtitleParser> parser(CDVDFactorySubtitle::CreateParser(path));
+  ASSERT_NE(nullptr, parser);
+  CDVDStreamInfo hints;
+  ASSERT_TRUE(parser->Open(hints));
+
+  EXPECT_EQ(0, LookupEntries(*parser, entries, 500));
+
+  parser->Dispose();
+  parser.reset();
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
+// load time and lookup rate of a large file, run with --gtest_also_run_disabled_tests
+TEST(TestDVDSubtitleParser, DISABLED_Benchmark)
+{
+  const int entries = 50000;
+  const int lookups = 2000;
+
+  XFILE::CFile* file;
+  ASSERT_NE(nullptr, file = WriteTempFile(GenerateSubrip(entries)));
+  std::string path = XBMC_TEMPFILEPATH(file);
+
+  auto start = std::chrono::steady_clock::now();
+  std::unique_ptr<CDVDSubtitleParser> parser(CDVDFactorySubtitle::CreateParser(path));
+  ASSERT_NE(nullptr, parser);
+  CDVDStreamInfo hints;
+  ASSERT_TRUE(parser->Open(hints));
+  auto load = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+  start = std::chrono::steady_clock::now();
+  EXPECT_EQ(0, LookupEntries(*parser, entries, lookups));
+  auto lookup = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+  RecordProperty("Entries", entries);
+  RecordProperty("LoadMilliseconds", static_cast<int>(load.count()));
+  RecordProperty("LookupsPerSecond", static_cast<int>(lookups * 1000000.0 / std::max<int64_t>(lookup.count(), 1)));
+
+  parser->Dispose();
+  parser.reset();
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
@@ -38,6 +38,7 @@
 
 #include "DVDFileInfo.h"
 
+#include "utils/FrameTrace.h"
 #include "utils/LangCodeExpander.h"
 #include "input/Key.h"
 #include "guilib/LocalizeStrings.h"
@@ -61,6 +62,7 @@
 #include "GUIUserMessages.h"
 #include "settings/Settings.h"
 #include "settings/MediaSettings.h"
+#include "settings/lib/SettingsManager.h"
 #include "utils/log.h"
 #include "utils/StreamDetails.h"
 #include "utils/StreamUtils.h"
@@ -695,6 +697,7 @@ CVideoPlayer::CVideoPlayer(IPlayerCallback& callback)
 
   m_displayLost = false;
   m_error = false;
+  m_parseCaptions = CServiceBroker::GetSettings().GetBoolHandle(CSettings::SETTING_SUBTITLES_PARSECAPTIONS);
   CServiceBroker::GetWinSystem()->Register(this);
 }
 
@@ -798,6 +801,9 @@ void CVideoPlayer::OnStartup()
   m_CurrentTeletext.Clear();
   m_CurrentRadioRDS.Clear();
 
+  m_settingLookups = CServiceBroker::GetSettings().GetSettingsManager()->GetLookupCount();
+  m_settingLookupsStart = XbmcThreads::SystemClockMillis();
+
   CUtil::ClearTempFonts();
 }
 
@@ -1058,6 +1064,8 @@ void CVideoPlayer::OpenDefaultStreams(bool reset)
 
 bool CVideoPlayer::ReadPacket(DemuxPacket*& packet, CDemuxStream*& stream)
 {
+  FRAME_TRACE_ZONE("CVideoPlayer::ReadPacket");
+
 
   // check if we should read from subtitle demuxer
   if (m_pSubtitleDemuxer && m_VideoPlayerSubtitle->AcceptsData())
@@ -1606,7 +1614,7 @@ void CVideoPlayer::Process()
     CheckBetterStream(m_CurrentRadioRDS, pStream);
 
     // demux video stream
-    if (CServiceBroker::GetSettings().GetBool(CSettings::SETTING_SUBTITLES_PARSECAPTIONS) && CheckIsCurrent(m_CurrentVideo, pStream, pPacket))
+    if (m_parseCaptions->GetValue() && CheckIsCurrent(m_CurrentVideo, pStream, pPacket))
     {
       if (m_pCCDemuxer)
       {
@@ -1669,6 +1677,8 @@ bool CVideoPlayer::CheckIsCurrent(CCurrentStream& current, CDemuxStream* stream,
 
 void CVideoPlayer::ProcessPacket(CDemuxStream* pStream, DemuxPacket* pPacket)
 {
+  FRAME_TRACE_ZONE("CVideoPlayer::ProcessPacket");
+
   // process packet if it belongs to selected stream.
   // for dvd's don't allow automatic opening of streams*/
 
@@ -2530,6 +2540,11 @@ void CVideoPlayer::OnExit()
   CFFmpegLog::ClearLogLevel();
   m_bStop = true;
 
+  unsigned int elapsed = XbmcThreads::SystemClockMillis() - m_settingLookupsStart;
+  uint64_t lookups = CServiceBroker::GetSettings().GetSettingsManager()->GetLookupCount() - m_settingLookups;
+  CLog::Log(LOGDEBUG, "CVideoPlayer::OnExit - %" PRIu64 " setting lookups in %u ms (%.1f/s)",
+            lookups, elapsed, elapsed > 0 ? lookups * 1000.0 / elapsed : 0.0);
+
   bool error = m_error;
   bool abort = m_bAbortRequest;
   m_outboundEvents->Submit([=]() {
@@ -2544,6 +2559,8 @@ void CVideoPlayer::OnExit()
 
 void CVideoPlayer::HandleMessages()
 {
+  FRAME_TRACE_ZONE("CVideoPlayer::HandleMessages");
+
   CDVDMsg* pMsg;
 
   while (m_messenger.Get(&pMsg, 0) == MSGQ_OK)
@@ -41,6 +41,7 @@
 #include "threads/Thread.h"
 #include "utils/StreamDetails.h"
 #include "guilib/DispResource.h"
+#include "settings/SettingHandle.h"
 
 #ifdef TARGET_RASPBERRY_PI
 #include "OMXCore.h"
@@ -593,6 +594,13 @@ protected:
 
   std::atomic<bool> m_displayLost;
 
+  // settings read for every demuxed packet
+  SettingBoolHandlePtr m_parseCaptions;
+
+  // string keyed settings lookups at startup, logged on exit
+  uint64_t m_settingLookups = 0;
+  unsigned int m_settingLookupsStart = 0;
+
   //@todo remove!
   // RPI specific stuff
   // omxplayer variables
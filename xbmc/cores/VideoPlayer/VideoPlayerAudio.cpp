@@ -26,6 +26,7 @@
 #include "cores/VideoPlayer/Interface/Addon/DemuxPacket.h"
 #include "settings/Settings.h"
 #include "system.h"
+#include "utils/FrameTrace.h"
 #include "utils/log.h"
 #include "utils/MathUtils.h"
 #include "cores/AudioEngine/Interfaces/AE.h"
@@ -431,6 +432,8 @@ void CVideoPlayerAudio::Process()
 
 bool CVideoPlayerAudio::ProcessDecoderOutput(DVDAudioFrame &audioframe)
 {
+  FRAME_TRACE_ZONE("CVideoPlayerAudio::ProcessDecoderOutput");
+
   if (audioframe.nb_frames <= audioframe.framesOut)
   {
     m_pAudioCodec->GetData(audioframe);
@@ -22,6 +22,7 @@
 #include "windowing/WinSystem.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
+#include "utils/FrameTrace.h"
 #include "utils/MathUtils.h"
 #include "VideoPlayerVideo.h"
 #include "DVDCodecs/DVDFactoryCodec.h"
@@ -600,6 +601,8 @@ void CVideoPlayerVideo::Process()
 
 bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
 {
+  FRAME_TRACE_ZONE("CVideoPlayerVideo::ProcessDecoderOutput");
+
   CDVDVideoCodec::VCReturn decoderState = m_pVideoCodec->GetPicture(&m_picture);
 
   if (decoderState == CDVDVideoCodec::VC_BUFFER)
@@ -830,6 +833,8 @@ void CVideoPlayerVideo::ProcessOverlays(const VideoPicture* pSource, double pts)
 
 CVideoPlayerVideo::EOutputState CVideoPlayerVideo::OutputPicture(const VideoPicture* pPicture)
 {
+  FRAME_TRACE_ZONE("CVideoPlayerVideo::OutputPicture");
+
   m_bAbortOutput = false;
 
   if (m_processInfo.GetVideoStereoMode() != pPicture->stereoMode)
@@ -29,6 +29,7 @@
 #include "VideoShaders/ShaderFormats.h"
 #include "cores/IPlayer.h"
 #include "cores/VideoPlayer/Process/VideoBuffer.h"
+#include "settings/SettingHandle.h"
 
 #define MAX_FIELDS 3
 #define NUM_BUFFERS 6
@@ -136,4 +137,8 @@ protected:
   AVPixelFormat m_format = AV_PIX_FMT_NONE;
 
   CVideoSettings m_videoSettings;
+
+  // settings read for every rendered frame
+  SettingIntHandlePtr m_errorInAspect;
+  SettingIntHandlePtr m_stretch43;
 };
@@ -0,0 +1,281 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "OverlayPrerenderer.h"
+#include "OverlayRendererUtil.h"
+#include "cores/VideoPlayer/DVDSubtitles/DVDSubtitlesLibass.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+
+#include <cmath>
+
+using namespace OVERLAY;
+
+namespace
+{
+// number of frames rendered ahead of the one on screen
+const int PRERENDER_FRAMES = 8;
+}
+
+class CLibassPrerenderer::CState : public std::enable_shared_from_this<CLibassPrerenderer::CState>
+{
+public:
+  ~CState();
+
+  std::shared_ptr<SQuads> Get(CDVDSubtitlesLibass* libass, const SParams& params, double pts);
+  void Flush();
+
+private:
+  void Reset(CDVDSubtitlesLibass* libass, const SParams& params);
+  void Schedule();
+  void Prerender();
+  std::shared_ptr<SQuads> Render(CDVDSubtitlesLibass* libass, const SParams& params, double pts, unsigned int generation);
+
+  CCriticalSection m_section;
+  CDVDSubtitlesLibass* m_libass = nullptr;
+  SParams m_params = {};
+  int m_events = 0;
+  unsigned int m_generation = 0;
+  CPrerenderedFrames m_frames;
+  bool m_jobActive = false;
+
+  // libass only keeps the images of the frame it rendered last
+  CCriticalSection m_renderSection;
+  std::shared_ptr<SQuads> m_last;
+  unsigned int m_lastGeneration = 0;
+};
+
+CLibassPrerenderer::CState::~CState()
+{
+  if (m_libass)
+    m_libass->Release();
+}
+
+void CLibassPrerenderer::CState::Reset(CDVDSubtitlesLibass* libass, const SParams& params)
+{
+  if (m_libass)
+    m_libass->Release();
+  m_libass = libass ? libass->Acquire() : nullptr;
+  m_params = params;
+  m_events = libass ? libass->GetNrOfEvents() : 0;
+  m_frames = CPrerenderedFrames();
+  m_generation++;
+}
+
+void CLibassPrerenderer::CState::Flush()
+{
+  CSingleLock lock(m_section);
+  Reset(nullptr, SParams());
+}
+
+std::shared_ptr<SQuads> CLibassPrerenderer::CState::Get(CDVDSubtitlesLibass* libass, const SParams& params, double pts)
+{
+  CSingleLock lock(m_section);
+
+  int events = libass->GetNrOfEvents();
+  if (libass != m_libass || !(params == m_params))
+    Reset(libass, params);
+  else if (events != m_events)
+  {
+    // events demuxed after the frames ahead were rendered
+    m_events = events;
+    m_frames.Clear();
+    m_generation++;
+  }
+
+  m_frames.SetCurrent(pts);
+
+  std::shared_ptr<SQuads> quads = m_frames.Find(pts);
+  if (!quads)
+  {
+    unsigned int generation = m_generation;
+    lock.Leave();
+    quads = Render(libass, params, pts, generation);
+    lock.Enter();
+    if (generation == m_generation)
+      m_frames.Add(pts, quads);
+  }
+
+  Schedule();
+  return quads;
+}
+
+void CLibassPrerenderer::CState::Schedule()
+{
+  if (m_jobActive || !m_libass || m_frames.GetAhead(1) == DVD_NOPTS_VALUE)
+    return;
+
+  for (int i = 1; i <= PRERENDER_FRAMES; i++)
+  {
+    if (!m_frames.Has(m_frames.GetAhead(i)))
+    {
+      m_jobActive = true;
+      std::shared_ptr<CState> state = shared_from_this();
+      CJobManager::GetInstance().Submit([state]() {
+        state->Prerender();
+      }, CJob::PRIORITY_HIGH);
+      return;
+    }
+  }
+}
+
+void CLibassPrerenderer::CState::Prerender()
+{
+  CSingleLock lock(m_section);
+
+  for (int i = 1; i <= PRERENDER_FRAMES && m_libass; i++)
+  {
+    // follow the render thread, it may have moved on meanwhile
+    double pts = m_frames.GetAhead(i);
+    if (pts == DVD_NOPTS_VALUE)
+      break;
+    if (m_frames.Has(pts))
+      continue;
+
+    CDVDSubtitlesLibass* libass = m_libass->Acquire();
+    SParams params = m_params;
+    unsigned int generation = m_generation;
+    lock.Leave();
+
+    std::shared_ptr<SQuads> quads = Render(libass, params, pts, generation);
+    libass->Release();
+
+    lock.Enter();
+    if (generation != m_generation)
+      break;
+    m_frames.Add(pts, quads);
+  }
+
+  m_jobActive = false;
+}
+
+std::shared_ptr<SQuads> CLibassPrerenderer::CState::Render(CDVDSubtitlesLibass* libass, const SParams& params, double pts, unsigned int generation)
+{
+  CSingleLock lock(m_renderSection);
+
+  int changes = 0;
+  ASS_Image* images = libass->RenderImage(params.frameWidth, params.frameHeight,
+                                          params.videoWidth, params.videoHeight,
+                                          pts, params.useMargin, params.position, &changes);
+
+  // unchanged since the last frame, share its bitmaps
+  if (changes == 0 && m_last && m_lastGeneration == generation)
+    return m_last;
+
+  std::shared_ptr<SQuads> quads = std::make_shared<SQuads>();
+  convert_quad(images, *quads, params.frameWidth);
+
+  m_last = quads;
+  m_lastGeneration = generation;
+  return quads;
+}
+
+void CPrerenderedFrames::SetCurrent(double pts)
+{
+  if (m_current != DVD_NOPTS_VALUE && pts > m_current && pts - m_current < DVD_TIME_BASE)
+    m_interval = pts - m_current;
+  m_current = pts;
+
+  m_frames.erase(m_frames.begin(), m_frames.lower_bound(pts - GetTolerance()));
+}
+
+double CPrerenderedFrames::GetAhead(int count) const
+{
+  if (m_current == DVD_NOPTS_VALUE || m_interval <= 0.0)
+    return DVD_NOPTS_VALUE;
+  return m_current + count * m_interval;
+}
+
+std::shared_ptr<SQuads> CPrerenderedFrames::Find(double pts) const
+{
+  auto it = FindFrame(pts);
+  if (it == m_frames.end())
+    return std::shared_ptr<SQuads>();
+  return it->second;
+}
+
+bool CPrerenderedFrames::Has(double pts) const
+{
+  return FindFrame(pts) != m_frames.end();
+}
+
+void CPrerenderedFrames::Add(double pts, std::shared_ptr<SQuads> quads)
+{
+  m_frames[pts] = quads;
+}
+
+void CPrerenderedFrames::Clear()
+{
+  m_frames.clear();
+}
+
+CPrerenderedFrames::FrameMap::const_iterator CPrerenderedFrames::FindFrame(double pts) const
+{
+  double tolerance = GetTolerance();
+  auto it = m_frames.lower_bound(pts - tolerance);
+  if (it == m_frames.end() || it->first > pts + tolerance)
+    return m_frames.end();
+
+  // take the closer one if two frames are within reach
+  auto next = std::next(it);
+  if (next != m_frames.end() && std::abs(next->first - pts) < std::abs(it->first - pts))
+    return next;
+  return it;
+}
+
+double CPrerenderedFrames::GetTolerance() const
+{
+  // until the interval is known only the exact frame matches
+  if (m_interval <= 0.0)
+    return DVD_MSEC_TO_TIME(1) / 2;
+  return m_interval / 2;
+}
+
+bool CLibassPrerenderer::SParams::operator==(const SParams& other) const
+{
+  return frameWidth == other.frameWidth &&
+         frameHeight == other.frameHeight &&
+         videoWidth == other.videoWidth &&
+         videoHeight == other.videoHeight &&
+         useMargin == other.useMargin &&
+         position == other.position;
+}
+
+CLibassPrerenderer::CLibassPrerenderer()
+  : m_state(std::make_shared<CState>())
+{
+}
+
+CLibassPrerenderer::~CLibassPrerenderer()
+{
+  // a running job keeps the state alive until it finishes
+  m_state->Flush();
+}
+
+std::shared_ptr<SQuads> CLibassPrerenderer::Get(CDVDSubtitlesLibass* libass, const SParams& params, double pts)
+{
+  return m_state->Get(libass, params, pts);
+}
+
+void CLibassPrerenderer::Flush()
+{
+  m_state->Flush();
+}
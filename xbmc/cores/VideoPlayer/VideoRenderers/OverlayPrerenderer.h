@@ -0,0 +1,118 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <memory>
+
+class CDVDSubtitlesLibass;
+
+namespace OVERLAY {
+
+  struct SQuads;
+
+  /*! \brief Frames rendered ahead, looked up by presentation time.
+
+   The pts of consecutive video frames jitter by a millisecond or so, so a
+   frame is found for any pts within half a frame interval of the pts it was
+   rendered for.
+   */
+  class CPrerenderedFrames
+  {
+  public:
+    /*! \brief Set the pts of the frame on screen and drop the frames before it
+     */
+    void SetCurrent(double pts);
+
+    /*! \brief Get the pts of a frame following the one on screen
+     \param count number of frames ahead
+     \return the expected pts, DVD_NOPTS_VALUE as long as the frame interval is unknown
+     */
+    double GetAhead(int count) const;
+
+    /*! \brief Get the frame rendered for a pts
+     \return the frame, nullptr if none was rendered for it
+     */
+    std::shared_ptr<SQuads> Find(double pts) const;
+
+    bool Has(double pts) const;
+    void Add(double pts, std::shared_ptr<SQuads> quads);
+
+    /*! \brief Drop all frames but keep the frame interval
+     */
+    void Clear();
+
+  private:
+    typedef std::map<double, std::shared_ptr<SQuads>> FrameMap;
+
+    FrameMap::const_iterator FindFrame(double pts) const;
+    double GetTolerance() const;
+
+    FrameMap m_frames;
+    double m_current = DVD_NOPTS_VALUE;
+    double m_interval = 0.0;
+  };
+
+  /*! \brief Renders libass subtitles ahead of the render thread.
+
+   The frames following the last requested pts are rendered on a worker and
+   kept as packed glyph bitmaps, so the render thread only has to upload them.
+   A frame libass reports as unchanged shares the bitmaps of its predecessor.
+   */
+  class CLibassPrerenderer
+  {
+  public:
+    struct SParams
+    {
+      int frameWidth;
+      int frameHeight;
+      int videoWidth;
+      int videoHeight;
+      int useMargin;
+      double position;
+
+      bool operator==(const SParams& other) const;
+    };
+
+    CLibassPrerenderer();
+    ~CLibassPrerenderer();
+
+    /*! \brief Get the glyph bitmaps of a frame, rendering them now if the worker has not done so yet
+     \param libass the subtitle track to render
+     \param params frame geometry the bitmaps are rendered for
+     \param pts presentation time of the frame
+     \return the bitmaps, count is 0 if there is nothing to display. Equal pointers mean equal content
+     */
+    std::shared_ptr<SQuads> Get(CDVDSubtitlesLibass* libass, const SParams& params, double pts);
+
+    /*! \brief Drop all rendered frames and the reference to the subtitle track
+     */
+    void Flush();
+
+  private:
+    class CState;
+    std::shared_ptr<CState> m_state;
+  };
+
+}
@@ -63,6 +63,10 @@ CRenderer::CRenderer()
 {
   m_font = "__subtitle__";
   m_fontBorder = "__subtitleborder__";
+  m_subtitleAlign = CServiceBroker::GetSettings().GetIntHandle(CSettings::SETTING_SUBTITLES_ALIGN);
+  m_subtitleColor = CServiceBroker::GetSettings().GetIntHandle(CSettings::SETTING_SUBTITLES_COLOR);
+  m_subtitleHeight = CServiceBroker::GetSettings().GetIntHandle(CSettings::SETTING_SUBTITLES_HEIGHT);
+  m_subtitleStyle = CServiceBroker::GetSettings().GetIntHandle(CSettings::SETTING_SUBTITLES_STYLE);
 }
 
 CRenderer::~CRenderer()
@@ -100,6 +104,7 @@ void CRenderer::Flush()
     Release(m_buffers[i]);
 
   ReleaseCache();
+  m_prerenderer.Flush();
 
   g_fontManager.Unload(m_font);
   g_fontManager.Unload(m_fontBorder);
@@ -118,6 +123,7 @@ void CRenderer::ReleaseCache()
     delete overlay.second;
   }
   m_textureCache.clear();
+  m_quadsCache.clear();
   m_textureid++;
 }
 
@@ -142,6 +148,7 @@ void CRenderer::ReleaseUnused()
     if (!found)
     {
       delete it->second;
+      m_quadsCache.erase(it->first);
       it = m_textureCache.erase(it);
     }
     else
@@ -170,7 +177,7 @@ void CRenderer::Render(int idx)
 
   float total_height = 0.0f;
   float cur_height = 0.0f;
-  int subalign = CServiceBroker::GetSettings().GetInt(CSettings::SETTING_SUBTITLES_ALIGN);
+  int subalign = m_subtitleAlign->GetValue();
   for (std::vector<COverlay*>::iterator it = render.begin(); it != render.end(); ++it)
   {
     COverlay* o = nullptr;
@@ -178,9 +185,9 @@ void CRenderer::Render(int idx)
     if (text)
     {
       text->PrepareRender(CServiceBroker::GetSettings().GetString(CSettings::SETTING_SUBTITLES_FONT),
-                          CServiceBroker::GetSettings().GetInt(CSettings::SETTING_SUBTITLES_COLOR),
-                          CServiceBroker::GetSettings().GetInt(CSettings::SETTING_SUBTITLES_HEIGHT),
-                          CServiceBroker::GetSettings().GetInt(CSettings::SETTING_SUBTITLES_STYLE),
+                          m_subtitleColor->GetValue(),
+                          m_subtitleHeight->GetValue(),
+                          m_subtitleStyle->GetValue(),
                           m_font, m_fontBorder);
       o = text;
     }
@@ -332,7 +339,7 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
   int targetHeight = MathUtils::round_int(m_rv.Height());
   int useMargin;
 
-  int subalign = CServiceBroker::GetSettings().GetInt(CSettings::SETTING_SUBTITLES_ALIGN);
+  int subalign = m_subtitleAlign->GetValue();
   if(subalign == SUBTITLE_ALIGN_BOTTOM_OUTSIDE
   || subalign == SUBTITLE_ALIGN_TOP_OUTSIDE
   ||(subalign == SUBTITLE_ALIGN_MANUAL && g_advancedSettings.m_videoAssFixedWorks))
@@ -353,12 +360,15 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
   }
   else
     position = 0.0;
-  int changes = 0;
-  ASS_Image* images = o->m_libass->RenderImage(targetWidth, targetHeight, videoWidth, videoHeight, pts, useMargin, position, &changes);
+
+  // the glyphs are rendered ahead on a worker, only the texture is created here
+  CLibassPrerenderer::SParams params = { targetWidth, targetHeight, videoWidth, videoHeight, useMargin, position };
+  std::shared_ptr<SQuads> quads = m_prerenderer.Get(o->m_libass, params, pts);
 
   if(o->m_textureid)
   {
-    if(changes == 0)
+    std::map<unsigned int, std::shared_ptr<SQuads>>::iterator itQuads = m_quadsCache.find(o->m_textureid);
+    if (itQuads != m_quadsCache.end() && itQuads->second == quads)
     {
       std::map<unsigned int, COverlay*>::iterator it = m_textureCache.find(o->m_textureid);
       if (it != m_textureCache.end())
@@ -368,9 +378,9 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
 
   COverlay *overlay = NULL;
 #if defined(HAS_GL) || defined(HAS_GLES)
-  overlay = new COverlayGlyphGL(images, targetWidth, targetHeight);
+  overlay = new COverlayGlyphGL(*quads, targetWidth, targetHeight);
 #elif defined(HAS_DX)
-  overlay = new COverlayQuadsDX(images, targetWidth, targetHeight);
+  overlay = new COverlayQuadsDX(*quads, targetWidth, targetHeight);
 #endif
   // scale to video dimensions
   if (overlay)
@@ -381,6 +391,7 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
     overlay->m_y = ((float)videoHeight - targetHeight) / 2 / videoHeight;
   }
   m_textureCache[m_textureid] = overlay;
+  m_quadsCache[m_textureid] = quads;
   o->m_textureid = m_textureid;
   m_textureid++;
   return overlay;
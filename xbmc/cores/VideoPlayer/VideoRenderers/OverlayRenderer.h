@@ -23,9 +23,12 @@
 
 #include "threads/CriticalSection.h"
 #include "BaseRenderer.h"
+#include "OverlayPrerenderer.h"
+#include "settings/SettingHandle.h"
 
 #include <vector>
 #include <map>
+#include <memory>
 
 class CDVDOverlay;
 class CDVDOverlayImage;
@@ -112,8 +115,14 @@ namespace OVERLAY {
     CCriticalSection m_section;
     std::vector<SElement> m_buffers[NUM_BUFFERS];
     std::map<unsigned int, COverlay*> m_textureCache;
+    std::map<unsigned int, std::shared_ptr<SQuads>> m_quadsCache;
+    CLibassPrerenderer m_prerenderer;
     static unsigned int m_textureid;
     CRect m_rv, m_rs, m_rd;
     std::string m_font, m_fontBorder;
+    SettingIntHandlePtr m_subtitleAlign;
+    SettingIntHandlePtr m_subtitleColor;
+    SettingIntHandlePtr m_subtitleHeight;
+    SettingIntHandlePtr m_subtitleStyle;
   };
 }
@@ -272,7 +272,7 @@ COverlayTextureGL::COverlayTextureGL(CDVDOverlaySpu* o)
   m_pma    = !!USE_PREMULTIPLIED_ALPHA;
 }
 
-COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
+COverlayGlyphGL::COverlayGlyphGL(const SQuads& quads, int width, int height)
 {
   m_vertex = NULL;
   m_width  = 1.0;
@@ -283,8 +283,7 @@ COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
   m_y      = 0.0f;
   m_texture = 0;
 
-  SQuads quads;
-  if(!convert_quad(images, quads, width))
+  if (quads.count == 0)
     return;
 
   glGenTextures(1, &m_texture);
@@ -23,6 +23,7 @@
 #include "RenderFactory.h"
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
 #include "windowing/GraphicContext.h"
+#include "utils/FrameTrace.h"
 #include "utils/MathUtils.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
@@ -290,6 +291,8 @@ bool CRenderManager::IsPresenting()
 
 void CRenderManager::FrameMove()
 {
+  FRAME_TRACE_ZONE("CRenderManager::FrameMove");
+
   bool firstFrame = false;
   UpdateResolution();
 
@@ -693,6 +696,8 @@ RESOLUTION CRenderManager::GetResolution()
 
 void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
 {
+  FRAME_TRACE_ZONE("CRenderManager::Render");
+
   CSingleExit exitLock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
   {
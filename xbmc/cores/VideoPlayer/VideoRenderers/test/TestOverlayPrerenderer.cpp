@@ -0,0 +1,95 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/VideoRenderers/OverlayPrerenderer.h"
+#include "cores/VideoPlayer/VideoRenderers/OverlayRendererUtil.h"
+
+#include "gtest/gtest.h"
+
+using namespace OVERLAY;
+
+namespace
+{
+// pts deltas of 23.976 fps video as demuxers deliver them
+const double FRAME_DELTAS[] = { DVD_MSEC_TO_TIME(41), DVD_MSEC_TO_TIME(42), DVD_MSEC_TO_TIME(42) };
+}
+
+TEST(TestPrerenderedFrames, FindsFramesRenderedAheadForJitteredPts)
+{
+  CPrerenderedFrames frames;
+  double pts = DVD_SEC_TO_TIME(10) + 123;
+  frames.SetCurrent(pts);
+  pts += FRAME_DELTAS[0];
+  frames.SetCurrent(pts);
+
+  for (int frame = 0; frame < 100; frame++)
+  {
+    // what the worker does after each frame
+    for (int i = 1; i <= 8; i++)
+    {
+      double ahead = frames.GetAhead(i);
+      ASSERT_NE(DVD_NOPTS_VALUE, ahead);
+      if (!frames.Has(ahead))
+        frames.Add(ahead, std::make_shared<SQuads>());
+    }
+
+    pts += FRAME_DELTAS[frame % 3] + (frame % 2 ? 300 : -300);
+    frames.SetCurrent(pts);
+    EXPECT_TRUE(frames.Has(pts)) << "frame " << frame;
+  }
+}
+
+TEST(TestPrerenderedFrames, DoesNotMatchNeighbouringFrames)
+{
+  CPrerenderedFrames frames;
+  double pts = DVD_SEC_TO_TIME(1);
+  frames.SetCurrent(pts);
+  pts += FRAME_DELTAS[0];
+  frames.SetCurrent(pts);
+
+  std::shared_ptr<SQuads> next = std::make_shared<SQuads>();
+  std::shared_ptr<SQuads> afterNext = std::make_shared<SQuads>();
+  frames.Add(pts + FRAME_DELTAS[0], next);
+  frames.Add(pts + 2 * FRAME_DELTAS[0], afterNext);
+
+  EXPECT_FALSE(frames.Has(pts));
+  EXPECT_EQ(next, frames.Find(pts + FRAME_DELTAS[1]));
+  EXPECT_EQ(afterNext, frames.Find(pts + 2 * FRAME_DELTAS[2]));
+  EXPECT_FALSE(frames.Has(pts + 3 * FRAME_DELTAS[0]));
+}
+
+TEST(TestPrerenderedFrames, DropsFramesBehindCurrent)
+{
+  CPrerenderedFrames frames;
+  double pts = DVD_SEC_TO_TIME(1);
+  frames.SetCurrent(pts);
+  frames.SetCurrent(pts + FRAME_DELTAS[0]);
+  frames.Add(pts + 2 * FRAME_DELTAS[0], std::make_shared<SQuads>());
+
+  frames.SetCurrent(pts + 2 * FRAME_DELTAS[0]);
+  EXPECT_TRUE(frames.Has(pts + 2 * FRAME_DELTAS[0]));
+  frames.SetCurrent(pts + 3 * FRAME_DELTAS[0]);
+  EXPECT_FALSE(frames.Has(pts + 2 * FRAME_DELTAS[0]));
+
+  frames.Add(pts + 4 * FRAME_DELTAS[0], std::make_shared<SQuads>());
+  frames.Clear();
+  EXPECT_FALSE(frames.Has(pts + 4 * FRAME_DELTAS[0]));
+  EXPECT_NE(DVD_NOPTS_VALUE, frames.GetAhead(1));
+}
@@ -0,0 +1,194 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AudioPrefetcher.h"
+#include "AudioDecoder.h"
+#include "FileItem.h"
+#include "URL.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+
+#include <atomic>
+
+#define PREFETCH_TAKE_TIMEOUT 3000 /* ms to wait for a prefetch in progress before opening the item inline */
+
+struct CAudioPrefetcher::SEntry
+{
+  enum State
+  {
+    QUEUED,  ///< the job has not started yet
+    RUNNING, ///< the job owns the entry until m_done is set
+    TAKEN    ///< the item was taken before the job started, the job does nothing
+  };
+
+  explicit SEntry(const CFileItem& item) : m_item(item), m_done(true) {}
+
+  CFileItem m_item;
+  std::unique_ptr<CAudioDecoder> m_decoder; ///< owned by the job until m_done is set
+  CEvent m_done;
+  std::atomic<int> m_state{QUEUED};
+  std::atomic<bool> m_abort{false};
+};
+
+CAudioPrefetcher::CAudioPrefetcher() = default;
+
+CAudioPrefetcher::~CAudioPrefetcher()
+{
+  Clear();
+}
+
+std::string CAudioPrefetcher::GetKey(const CFileItem& item)
+{
+  return item.GetDynPath() + "|" + std::to_string(item.m_lStartOffset);
+}
+
+void CAudioPrefetcher::Prefetch(const std::vector<CFileItem>& items)
+{
+  std::map<std::string, std::shared_ptr<SEntry>> entries;
+  std::vector<std::shared_ptr<SEntry>> submit;
+
+  CSingleLock lock(m_section);
+  for (const auto& item : items)
+  {
+    std::string key = GetKey(item);
+    auto it = m_entries.find(key);
+    if (it != m_entries.end())
+    {
+      entries[key] = it->second;
+      m_entries.erase(it);
+    }
+    else if (entries.find(key) == entries.end())
+    {
+      auto entry = std::make_shared<SEntry>(item);
+      entry->m_done.Reset();
+      entries[key] = entry;
+      submit.push_back(entry);
+    }
+  }
+
+  // whatever is left is not upcoming anymore
+  for (auto& it : m_entries)
+    it.second->m_abort = true;
+
+  m_entries.swap(entries);
+  lock.Leave();
+
+  for (auto& entry : submit)
+  {
+    CLog::Log(LOGDEBUG, "CAudioPrefetcher::Prefetch - prefetching %s", CURL::GetRedacted(entry->m_item.GetDynPath()).c_str());
+    CJobManager::GetInstance().Submit([entry]() {
+      Run(entry);
+    }, CJob::PRIORITY_NORMAL);
+  }
+}
+
+void CAudioPrefetcher::Run(const std::shared_ptr<SEntry>& entry)
+{
+  int state = SEntry::QUEUED;
+  if (!entry->m_state.compare_exchange_strong(state, SEntry::RUNNING))
+    return;
+
+  std::unique_ptr<CAudioDecoder> decoder(new CAudioDecoder());
+
+  if (!entry->m_abort && decoder->Create(entry->m_item, entry->m_item.m_lStartOffset))
+  {
+    // fill the pcm buffer, it is bounded by the decoder so this stops on its own
+    while (!entry->m_abort)
+    {
+      int status = decoder->GetStatus();
+      if (status != STATUS_QUEUING)
+        break;
+      int result = decoder->ReadSamples(PACKET_SIZE);
+      if (result == RET_ERROR)
+      {
+        decoder.reset();
+        break;
+      }
+      else if (result == RET_SLEEP)
+        XbmcThreads::ThreadSleep(1);
+    }
+  }
+  else
+    decoder.reset();
+
+  if (entry->m_abort)
+    decoder.reset();
+
+  entry->m_decoder = std::move(decoder);
+  entry->m_done.Set();
+}
+
+std::unique_ptr<CAudioDecoder> CAudioPrefetcher::Take(const CFileItem& item)
+{
+  std::shared_ptr<SEntry> entry;
+  {
+    CSingleLock lock(m_section);
+    auto it = m_entries.find(GetKey(item));
+    if (it == m_entries.end())
+      return nullptr;
+    entry = it->second;
+    m_entries.erase(it);
+  }
+
+  // nothing to wait for if the job did not start yet, was cancelled or never
+  // queued. Open the item inline instead of waiting behind other jobs.
+  int state = SEntry::QUEUED;
+  if (entry->m_state.compare_exchange_strong(state, SEntry::TAKEN))
+  {
+    CLog::Log(LOGDEBUG, "CAudioPrefetcher::Take - prefetch of %s did not start", CURL::GetRedacted(item.GetDynPath()).c_str());
+    return nullptr;
+  }
+
+  if (!entry->m_done.WaitMSec(PREFETCH_TAKE_TIMEOUT))
+  {
+    // the job drops its decoder once it sees the abort
+    entry->m_abort = true;
+    CLog::Log(LOGWARNING, "CAudioPrefetcher::Take - timed out waiting for prefetch of %s", CURL::GetRedacted(item.GetDynPath()).c_str());
+    return nullptr;
+  }
+
+  if (entry->m_decoder)
+    CLog::Log(LOGDEBUG, "CAudioPrefetcher::Take - using prefetched decoder for %s", CURL::GetRedacted(item.GetDynPath()).c_str());
+  return std::move(entry->m_decoder);
+}
+
+bool CAudioPrefetcher::WaitForPrefetch(const CFileItem& item, unsigned int timeout)
+{
+  std::shared_ptr<SEntry> entry;
+  {
+    CSingleLock lock(m_section);
+    auto it = m_entries.find(GetKey(item));
+    if (it == m_entries.end())
+      return false;
+    entry = it->second;
+  }
+  return entry->m_done.WaitMSec(timeout);
+}
+
+void CAudioPrefetcher::Clear()
+{
+  CSingleLock lock(m_section);
+  for (auto& it : m_entries)
+    it.second->m_abort = true;
+  m_entries.clear();
+}
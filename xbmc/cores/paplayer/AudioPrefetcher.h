@@ -0,0 +1,79 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+
+class CAudioDecoder;
+class CFileItem;
+
+/*!
+ \brief Opens and pre-decodes upcoming playlist items on worker threads.
+
+ Every prefetched item gets its own CAudioDecoder that is created and filled
+ up to the size of its PCM buffer, so a later QueueNextFile only has to take
+ over the decoder instead of waiting on open and seek latency of the source.
+ */
+class CAudioPrefetcher
+{
+public:
+  CAudioPrefetcher();
+  ~CAudioPrefetcher();
+
+  /*!
+   \brief Make the given items the prefetched set.
+   Items not in the set anymore are dropped, new ones are submitted to the job manager.
+   */
+  void Prefetch(const std::vector<CFileItem>& items);
+
+  /*!
+   \brief Take over the decoder prefetched for the given item.
+   Waits a bounded time for a prefetch in progress, a prefetch that did not start yet is dropped.
+   \return the prepared decoder or nullptr if the item has to be opened by the caller
+   */
+  std::unique_ptr<CAudioDecoder> Take(const CFileItem& item);
+
+  /*!
+   \brief Drop all prefetched decoders.
+   */
+  void Clear();
+
+private:
+  friend class TestAudioPrefetcherHelper;
+  struct SEntry;
+
+  static std::string GetKey(const CFileItem& item);
+  static void Run(const std::shared_ptr<SEntry>& entry);
+
+  /*!
+   \brief Wait for the prefetch job of the given item to finish, it is not taken.
+   \return false if the item is not prefetched or the job did not finish in time
+   */
+  bool WaitForPrefetch(const CFileItem& item, unsigned int timeout);
+
+  CCriticalSection m_section;
+  std::map<std::string, std::shared_ptr<SEntry>> m_entries;
+};
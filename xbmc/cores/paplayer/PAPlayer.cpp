@@ -20,12 +20,15 @@
 
 #include "PAPlayer.h"
 #include "CodecFactory.h"
+#include "PlayListPlayer.h"
 #include "ServiceBroker.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "music/tags/MusicInfoTag.h"
+#include "playlists/PlayList.h"
 #include "utils/log.h"
 #include "utils/JobManager.h"
+#include "utils/URIUtils.h"
 #include "video/Bookmark.h"
 
 #include "cores/AudioEngine/Interfaces/AE.h"
@@ -38,6 +41,8 @@
 #define TIME_TO_CACHE_NEXT_FILE 5000 /* 5 seconds before end of song, start caching the next song */
 #define FAST_XFADE_TIME           80 /* 80 milliseconds */
 #define MAX_SKIP_XFADE_TIME     2000 /* max 2 seconds crossfade on track skip */
+#define PREFETCH_ITEMS             1 /* number of upcoming playlist items to open and pre-decode */
+#define TIME_TO_PREFETCH_NEXT_FILE 30000 /* 30 seconds before end of song, start prefetching the next song */
 
 // PAP: Psycho-acoustic Audio Player
 // Supporting all open  audio codec standards.
@@ -196,7 +201,7 @@ void PAPlayer::CloseAllStreams(bool fade/* = true */)
         si->m_stream = NULL;
       }
 
-      si->m_decoder.Destroy();
+      si->m_decoder->Destroy();
       delete si;
     }
 
@@ -212,7 +217,7 @@ void PAPlayer::CloseAllStreams(bool fade/* = true */)
         si->m_stream = nullptr;
       }
 
-      si->m_decoder.Destroy();
+      si->m_decoder->Destroy();
       delete si;
     }
     m_currentStream = nullptr;
@@ -335,7 +340,14 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
 
   StreamInfo *si = new StreamInfo();
   si->m_fileItem = file;
-  if (!si->m_decoder.Create(file, si->m_fileItem.m_lStartOffset))
+  si->m_decoder = m_prefetcher.Take(file);
+  if (!si->m_decoder)
+  {
+    si->m_decoder.reset(new CAudioDecoder());
+    if (!si->m_decoder->Create(file, si->m_fileItem.m_lStartOffset))
+      si->m_decoder.reset();
+  }
+  if (!si->m_decoder)
   {
     CLog::Log(LOGWARNING, "PAPlayer::QueueNextFileEx - Failed to create the decoder");
 
@@ -347,17 +359,17 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
   }
 
   /* decode until there is data-available */
-  si->m_decoder.Start();
-  while (si->m_decoder.GetDataSize(true) == 0)
+  si->m_decoder->Start();
+  while (si->m_decoder->GetDataSize(true) == 0)
   {
-    int status = si->m_decoder.GetStatus();
+    int status = si->m_decoder->GetStatus();
     if (status == STATUS_ENDED   ||
         status == STATUS_NO_FILE ||
-        si->m_decoder.ReadSamples(PACKET_SIZE) == RET_ERROR)
+        si->m_decoder->ReadSamples(PACKET_SIZE) == RET_ERROR)
     {
       CLog::Log(LOGINFO, "PAPlayer::QueueNextFileEx - Error reading samples");
 
-      si->m_decoder.Destroy();
+      si->m_decoder->Destroy();
       // advance playlist
       AdvancePlaylistOnError(si->m_fileItem);
       m_callback.OnQueueNextItem();
@@ -373,7 +385,7 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
   UpdateCrossfadeTime(si->m_fileItem);
 
   /* init the streaminfo struct */
-  si->m_audioFormat = si->m_decoder.GetFormat();
+  si->m_audioFormat = si->m_decoder->GetFormat();
   si->m_startOffset = file.m_lStartOffset;
   si->m_endOffset = file.m_lEndOffset;
   si->m_bytesPerSample = CAEUtil::DataFormatToBits(si->m_audioFormat.m_dataFormat) >> 3;
@@ -388,7 +400,7 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
   si->m_fadeOutTriggered = false;
   si->m_isSlaved = false;
 
-  si->m_decoderTotal = si->m_decoder.TotalTime();
+  si->m_decoderTotal = si->m_decoder->TotalTime();
   int64_t streamTotalTime = si->m_decoderTotal;
   if (si->m_endOffset)
     streamTotalTime = si->m_endOffset - si->m_startOffset;
@@ -401,12 +413,18 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
       si->m_prepareNextAtFrame = (int)((streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS) * si->m_audioFormat.m_sampleRate / 1000.0f);
   }
 
+  // keep prefetched files closed until the end of this one is near
+  si->m_prefetchAtFrame = -1;
+  if (streamTotalTime > 0)
+    si->m_prefetchAtFrame = (int)(std::max<int64_t>(streamTotalTime - TIME_TO_PREFETCH_NEXT_FILE - m_defaultCrossfadeMS, 0) * si->m_audioFormat.m_sampleRate / 1000.0f);
+  si->m_prefetchTriggered = false;
+
   if (m_currentStream && ((m_currentStream->m_audioFormat.m_dataFormat == AE_FMT_RAW) || (si->m_audioFormat.m_dataFormat == AE_FMT_RAW)))
   {
     m_currentStream->m_prepareTriggered = false;
     m_currentStream->m_waitOnDrain = true;
     m_currentStream->m_prepareNextAtFrame = 0;
-    si->m_decoder.Destroy();
+    si->m_decoder->Destroy();
     delete si;
     return false;
   }
@@ -420,7 +438,7 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
   {
     CLog::Log(LOGINFO, "PAPlayer::QueueNextFileEx - Error preparing stream");
     
-    si->m_decoder.Destroy();
+    si->m_decoder->Destroy();
     // advance playlist
     AdvancePlaylistOnError(si->m_fileItem);
     m_callback.OnQueueNextItem();
@@ -437,12 +455,46 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
   return true;
 }
 
+void PAPlayer::PrefetchUpcoming()
+{
+  std::vector<CFileItem> items;
+  PLAYLIST::CPlayListPlayer &playlistPlayer = CServiceBroker::GetPlaylistPlayer();
+  int playlist = playlistPlayer.GetCurrentPlaylist();
+  if (playlist == PLAYLIST_MUSIC && !playlistPlayer.RepeatedOne(playlist))
+  {
+    std::string currentPath;
+    {
+      CSingleLock lock(m_streamsLock);
+      if (m_currentStream)
+        currentPath = m_currentStream->m_fileItem.GetDynPath();
+    }
+
+    const PLAYLIST::CPlayList &list = playlistPlayer.GetPlaylist(playlist);
+    for (int offset = 1; offset <= PREFETCH_ITEMS; offset++)
+    {
+      int song = playlistPlayer.GetNextSong(offset);
+      if (song < 0 || song >= list.size())
+        break;
+
+      // skip what cannot or should not be opened twice: cue sheet tracks of the
+      // playing file, cd drives and live streams
+      const CFileItem &item = *list[song];
+      if (item.GetDynPath() == currentPath || item.IsCDDA() || item.IsInternetStream() ||
+          !HandlesType(URIUtils::GetExtension(item.GetDynPath())))
+        continue;
+
+      items.push_back(item);
+    }
+  }
+  m_prefetcher.Prefetch(items);
+}
+
 void PAPlayer::UpdateStreamInfoPlayNextAtFrame(StreamInfo *si, unsigned int crossFadingTime)
 {
   // if no crossfading or cue sheet, wait for eof
   if (si && (crossFadingTime || si->m_endOffset))
   {
-    int64_t streamTotalTime = si->m_decoder.TotalTime();
+    int64_t streamTotalTime = si->m_decoder->TotalTime();
     if (si->m_endOffset)
       streamTotalTime = si->m_endOffset - si->m_startOffset;
     if (streamTotalTime < crossFadingTime)
@@ -473,7 +525,7 @@ inline bool PAPlayer::PrepareStream(StreamInfo *si)
 
   si->m_stream->SetVolume(si->m_volume);
   float peak = 1.0;
-  float gain = si->m_decoder.GetReplayGain(peak);
+  float gain = si->m_decoder->GetReplayGain(peak);
   if (peak * gain <= 1.0)
     // No clipping protection needed
     si->m_stream->SetReplayGain(gain);
@@ -495,10 +547,10 @@ inline bool PAPlayer::PrepareStream(StreamInfo *si)
   /* fill the stream's buffer */
   while(si->m_stream->IsBuffering())
   {
-    int status = si->m_decoder.GetStatus();
+    int status = si->m_decoder->GetStatus();
     if (status == STATUS_ENDED   ||
         status == STATUS_NO_FILE ||
-        si->m_decoder.ReadSamples(PACKET_SIZE) == RET_ERROR)
+        si->m_decoder->ReadSamples(PACKET_SIZE) == RET_ERROR)
     {
       CLog::Log(LOGINFO, "PAPlayer::PrepareStream - Stream Finished");
       break;
@@ -527,6 +579,7 @@ bool PAPlayer::CloseFile(bool reopen)
 
   /* wait for the thread to terminate */
   StopThread(true);//true - wait for end of thread
+  m_prefetcher.Clear();
 
   // wait for any pending jobs to complete
   {
@@ -560,6 +613,12 @@ void PAPlayer::Process()
       m_signalSpeedChange = false;
     }
 
+    if (m_prefetchPending)
+    {
+      m_prefetchPending = false;
+      PrefetchUpcoming();
+    }
+
     double freeBufferTime = 0.0;
     ProcessStreams(freeBufferTime);
 
@@ -667,7 +726,7 @@ inline void PAPlayer::ProcessStreams(double &freeBufferTime)
 
       /* unregister the audio callback */
       si->m_stream->UnRegisterAudioCallback();
-      si->m_decoder.Destroy();      
+      si->m_decoder->Destroy();      
       si->m_stream->Drain(false);
       m_finishing.push_back(si);
       return;
@@ -676,6 +735,13 @@ inline void PAPlayer::ProcessStreams(double &freeBufferTime)
     if (!si->m_started)
       continue;
 
+    // is it time to prefetch the upcoming streams?
+    if (si->m_prefetchAtFrame >= 0 && !si->m_prefetchTriggered && si->m_framesSent >= si->m_prefetchAtFrame)
+    {
+      si->m_prefetchTriggered = true;
+      m_prefetchPending = true;
+    }
+
     // is it time to prepare the next stream?
     if (si->m_prepareNextAtFrame > 0 && !si->m_prepareTriggered && si->m_framesSent >= si->m_prepareNextAtFrame)
     {
@@ -762,13 +828,13 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &freeBufferTime)
       SetSpeed(1);
     }
 
-    si->m_decoder.Seek(time);
+    si->m_decoder->Seek(time);
   }
 
-  int status = si->m_decoder.GetStatus();
+  int status = si->m_decoder->GetStatus();
   if (status == STATUS_ENDED   ||
       status == STATUS_NO_FILE ||
-      si->m_decoder.ReadSamples(PACKET_SIZE) == RET_ERROR ||
+      si->m_decoder->ReadSamples(PACKET_SIZE) == RET_ERROR ||
       ((si->m_endOffset) && (si->m_framesSent / si->m_audioFormat.m_sampleRate >= (si->m_endOffset - si->m_startOffset) / 1000)))
   {
     if (si == m_currentStream && si->m_nextFileItem)
@@ -786,7 +852,7 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &freeBufferTime)
       si->m_fileItem = *si->m_nextFileItem;
       si->m_nextFileItem.reset();
 
-      int64_t streamTotalTime = si->m_decoder.TotalTime() - si->m_startOffset;
+      int64_t streamTotalTime = si->m_decoder->TotalTime() - si->m_startOffset;
       if (si->m_endOffset)
         streamTotalTime = si->m_endOffset - si->m_startOffset;
 
@@ -795,6 +861,11 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &freeBufferTime)
       if (streamTotalTime >= TIME_TO_CACHE_NEXT_FILE + m_defaultCrossfadeMS)
         si->m_prepareNextAtFrame = (int)((streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS) * si->m_audioFormat.m_sampleRate / 1000.0f);
 
+      si->m_prefetchAtFrame = -1;
+      if (streamTotalTime > 0)
+        si->m_prefetchAtFrame = (int)(std::max<int64_t>(streamTotalTime - TIME_TO_PREFETCH_NEXT_FILE - m_defaultCrossfadeMS, 0) * si->m_audioFormat.m_sampleRate / 1000.0f);
+      si->m_prefetchTriggered = false;
+
       si->m_prepareTriggered = false;
       si->m_playNextAtFrame = 0;
       si->m_playNextTriggered = false;
@@ -845,14 +916,14 @@ bool PAPlayer::QueueData(StreamInfo *si)
 
   if (si->m_audioFormat.m_dataFormat != AE_FMT_RAW)
   {
-    unsigned int samples = std::min(si->m_decoder.GetDataSize(false), space / si->m_bytesPerSample);
+    unsigned int samples = std::min(si->m_decoder->GetDataSize(false), space / si->m_bytesPerSample);
     if (!samples)
       return true;
 
     // we want complete frames
     samples -= samples % si->m_audioFormat.m_channelLayout.Count();
 
-    uint8_t* data = (uint8_t*)si->m_decoder.GetData(samples);
+    uint8_t* data = (uint8_t*)si->m_decoder->GetData(samples);
     if (!data)
     {
       CLog::Log(LOGERROR, "PAPlayer::QueueData - Failed to get data from the decoder");
@@ -869,7 +940,7 @@ bool PAPlayer::QueueData(StreamInfo *si)
       return true;
 
     int size;
-    uint8_t *data = si->m_decoder.GetRawData(size);
+    uint8_t *data = si->m_decoder->GetRawData(size);
     if (data && size)
     {
       int added = si->m_stream->AddData(&data, 0, size, 0);
@@ -882,7 +953,7 @@ bool PAPlayer::QueueData(StreamInfo *si)
     }
   }
 
-  const ICodec* codec = si->m_decoder.GetCodec();
+  const ICodec* codec = si->m_decoder->GetCodec();
   m_playerGUIData.m_cacheLevel = codec ? codec->GetCacheLevel() : 0; //update for GUI
 
   return true;
@@ -971,7 +1042,7 @@ void PAPlayer::SetTotalTimeInternal(int64_t time)
   if (!m_currentStream)
     return;
   
-  m_currentStream->m_decoder.SetTotalTime(time);
+  m_currentStream->m_decoder->SetTotalTime(time);
   UpdateGUIData(m_currentStream);
 }
 
@@ -998,7 +1069,7 @@ int64_t PAPlayer::GetTotalTime64()
   if (!m_currentStream)
     return 0;
 
-  int64_t total = m_currentStream->m_decoder.TotalTime();
+  int64_t total = m_currentStream->m_decoder->TotalTime();
   if (m_currentStream->m_endOffset)
     total = m_currentStream->m_endOffset;
   total -= m_currentStream->m_startOffset;
@@ -1098,16 +1169,16 @@ void PAPlayer::UpdateGUIData(StreamInfo *si)
 
   m_playerGUIData.m_sampleRate    = si->m_audioFormat.m_sampleRate;
   m_playerGUIData.m_channelCount  = si->m_audioFormat.m_channelLayout.Count();
-  m_playerGUIData.m_canSeek       = si->m_decoder.CanSeek();
+  m_playerGUIData.m_canSeek       = si->m_decoder->CanSeek();
 
-  const ICodec* codec = si->m_decoder.GetCodec();
+  const ICodec* codec = si->m_decoder->GetCodec();
 
   m_playerGUIData.m_audioBitrate = codec ? codec->m_bitRate : 0;
   strncpy(m_playerGUIData.m_codec,codec ? codec->m_CodecName.c_str() : "",20);
   m_playerGUIData.m_cacheLevel   = codec ? codec->GetCacheLevel() : 0;
   m_playerGUIData.m_bitsPerSample = (codec && codec->m_bitsPerCodedSample) ? codec->m_bitsPerCodedSample : si->m_bytesPerSample << 3;
 
-  int64_t total = si->m_decoder.TotalTime();
+  int64_t total = si->m_decoder->TotalTime();
   if (si->m_endOffset)
     total = m_currentStream->m_endOffset;
   total -= m_currentStream->m_startOffset;
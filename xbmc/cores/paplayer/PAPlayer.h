@@ -22,12 +22,14 @@
 
 #include <atomic>
 #include <list>
+#include <memory>
 #include <vector>
 
 #include "FileItem.h"
 #include "cores/IPlayer.h"
 #include "threads/Thread.h"
 #include "AudioDecoder.h"
+#include "AudioPrefetcher.h"
 #include "threads/CriticalSection.h"
 #include "utils/Job.h"
 
@@ -96,7 +98,7 @@ private:
   {
     CFileItem m_fileItem;
     std::unique_ptr<CFileItem> m_nextFileItem;
-    CAudioDecoder m_decoder;             /* the stream decoder */
+    std::unique_ptr<CAudioDecoder> m_decoder; /* the stream decoder */
     int64_t m_startOffset;               /* the stream start offset */
     int64_t m_endOffset;                 /* the stream end offset */
     int64_t m_decoderTotal = 0;
@@ -109,6 +111,8 @@ private:
     int m_framesSent;                    /* number of frames sent to the stream */
     int m_prepareNextAtFrame;            /* when to prepare the next stream */
     bool m_prepareTriggered;             /* if the next stream has been prepared */
+    int m_prefetchAtFrame = -1;          /* when to prefetch the upcoming streams, -1 for never */
+    bool m_prefetchTriggered = false;    /* if the upcoming streams have been prefetched */
     int m_playNextAtFrame;               /* when to start playing the next stream */
     bool m_playNextTriggered;            /* if this stream has started the next one */
     bool m_fadeOutTriggered;             /* if the stream has been told to fade out */
@@ -144,6 +148,8 @@ private:
   int64_t             m_newForcedPlayerTime;
   int64_t             m_newForcedTotalTime;
   std::unique_ptr<CProcessInfo> m_processInfo;
+  CAudioPrefetcher    m_prefetcher;          /* opens and pre-decodes upcoming items */
+  std::atomic_bool    m_prefetchPending{false}; /* set when the end of the current stream is near */
 
   bool QueueNextFileEx(const CFileItem &file, bool fadeIn);
   void SoftStart(bool wait = false);
@@ -155,6 +161,7 @@ private:
   bool QueueData(StreamInfo *si);
   int64_t GetTotalTime64();
   void UpdateCrossfadeTime(const CFileItem& file);
+  void PrefetchUpcoming();
   void UpdateStreamInfoPlayNextAtFrame(StreamInfo *si, unsigned int crossFadingTime);
   void UpdateGUIData(StreamInfo *si);
   int64_t GetTimeInternal();
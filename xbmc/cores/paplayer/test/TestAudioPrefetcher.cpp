@@ -0,0 +1,149 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/paplayer/AudioDecoder.h"
+#include "cores/paplayer/AudioPrefetcher.h"
+#include "FileItem.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "threads/SystemClock.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace
+{
+void Put16(std::vector<uint8_t>& data, uint16_t value)
+{
+  data.push_back(value & 0xff);
+  data.push_back(value >> 8);
+}
+
+void Put32(std::vector<uint8_t>& data, uint32_t value)
+{
+  Put16(data, value & 0xffff);
+  Put16(data, value >> 16);
+}
+
+// writes a silent 16 bit stereo wav of the given length
+bool WriteWav(const std::string& path, unsigned int seconds)
+{
+  const uint32_t sampleRate = 44100;
+  const uint32_t dataSize = seconds * sampleRate * 4;
+
+  std::vector<uint8_t> data;
+  data.insert(data.end(), { 'R', 'I', 'F', 'F' });
+  Put32(data, 36 + dataSize);
+  data.insert(data.end(), { 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ' });
+  Put32(data, 16);
+  Put16(data, 1);
+  Put16(data, 2);
+  Put32(data, sampleRate);
+  Put32(data, sampleRate * 4);
+  Put16(data, 4);
+  Put16(data, 16);
+  data.insert(data.end(), { 'd', 'a', 't', 'a' });
+  Put32(data, dataSize);
+  data.resize(data.size() + dataSize, 0);
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true))
+    return false;
+  bool ok = file.Write(data.data(), data.size()) == static_cast<ssize_t>(data.size());
+  file.Close();
+  return ok;
+}
+
+class TestAudioPrefetcher : public testing::Test
+{
+protected:
+  TestAudioPrefetcher()
+  {
+    m_path = CSpecialProtocol::TranslatePath("special://temp/prefetch.wav");
+    WriteWav(m_path, 3);
+  }
+
+  ~TestAudioPrefetcher() override
+  {
+    XFILE::CFile::Delete(m_path);
+  }
+
+  std::string m_path;
+};
+}
+
+class TestAudioPrefetcherHelper
+{
+public:
+  static bool WaitForPrefetch(CAudioPrefetcher& prefetcher, const CFileItem& item, unsigned int timeout)
+  {
+    return prefetcher.WaitForPrefetch(item, timeout);
+  }
+};
+
+TEST_F(TestAudioPrefetcher, TakesPrefetchedDecoder)
+{
+  CAudioPrefetcher prefetcher;
+  CFileItem item(m_path, false);
+  prefetcher.Prefetch({ item });
+  ASSERT_TRUE(TestAudioPrefetcherHelper::WaitForPrefetch(prefetcher, item, 10000));
+
+  std::unique_ptr<CAudioDecoder> decoder = prefetcher.Take(item);
+  ASSERT_NE(nullptr, decoder.get());
+  EXPECT_NE(STATUS_NO_FILE, decoder->GetStatus());
+
+  // an item is only handed out once
+  EXPECT_EQ(nullptr, prefetcher.Take(item).get());
+}
+
+TEST_F(TestAudioPrefetcher, NotPrefetched)
+{
+  CAudioPrefetcher prefetcher;
+  EXPECT_EQ(nullptr, prefetcher.Take(CFileItem(m_path, false)).get());
+}
+
+TEST_F(TestAudioPrefetcher, DroppedItemsAreNotTaken)
+{
+  CAudioPrefetcher prefetcher;
+  CFileItem item(m_path, false);
+  CFileItem other(CSpecialProtocol::TranslatePath("special://temp/other.wav"), false);
+
+  prefetcher.Prefetch({ item });
+  prefetcher.Prefetch({ other });
+  EXPECT_EQ(nullptr, prefetcher.Take(item).get());
+
+  prefetcher.Prefetch({ item });
+  prefetcher.Clear();
+  EXPECT_EQ(nullptr, prefetcher.Take(item).get());
+}
+
+TEST_F(TestAudioPrefetcher, MissingFileDoesNotBlock)
+{
+  CAudioPrefetcher prefetcher;
+  CFileItem item(CSpecialProtocol::TranslatePath("special://temp/missing.wav"), false);
+  prefetcher.Prefetch({ item });
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  EXPECT_EQ(nullptr, prefetcher.Take(item).get());
+  EXPECT_LT(XbmcThreads::SystemClockMillis() - start, 5000u);
+}
@@ -157,6 +157,10 @@ CDatabase::CDatabase() :
   m_sqlite = true;
   m_bMultiWrite = false;
   m_multipleExecute = false;
+  m_batch = false;
+  m_batchItem = false;
+  m_savepointDepth = 0;
+  m_batchTransaction = false;
 }
 
 CDatabase::~CDatabase(void)
@@ -529,6 +533,10 @@ void CDatabase::Close()
     return;
   }
 
+  // don't lose writes of an open batch
+  if (InBatch())
+    EndBatch();
+
   m_openCount = 0;
   m_multipleExecute = false;
 
@@ -583,6 +591,18 @@ void CDatabase::Interrupt()
 
 void CDatabase::BeginTransaction()
 {
+  if (m_batchItem)
+  {
+    // the item transaction is only started by the first write so that no
+    // lock is held while the caller is busy with other things
+    if (m_batchTransaction)
+    {
+      ExecuteSavepoint(StringUtils::Format("SAVEPOINT sp%u", ++m_savepointDepth));
+      return;
+    }
+    m_batchTransaction = true;
+  }
+
   try
   {
     if (NULL != m_pDB.get())
@@ -592,10 +612,20 @@ void CDatabase::BeginTransaction()
   {
     CLog::Log(LOGERROR, "database:begintransaction failed");
   }
+
+  if (m_batchTransaction)
+    ExecuteSavepoint(StringUtils::Format("SAVEPOINT sp%u", ++m_savepointDepth));
 }
 
 bool CDatabase::CommitTransaction()
 {
+  if (m_batchTransaction)
+  {
+    if (m_savepointDepth == 0)
+      return true;
+    return ExecuteSavepoint(StringUtils::Format("RELEASE SAVEPOINT sp%u", m_savepointDepth--));
+  }
+
   try
   {
     if (NULL != m_pDB.get())
@@ -611,6 +641,17 @@ bool CDatabase::CommitTransaction()
 
 void CDatabase::RollbackTransaction()
 {
+  if (m_batchTransaction)
+  {
+    if (m_savepointDepth > 0)
+    {
+      ExecuteSavepoint(StringUtils::Format("ROLLBACK TO SAVEPOINT sp%u", m_savepointDepth));
+      ExecuteSavepoint(StringUtils::Format("RELEASE SAVEPOINT sp%u", m_savepointDepth--));
+    }
+    ClearBatchCache();
+    return;
+  }
+
   try
   {
     if (NULL != m_pDB.get())
@@ -620,11 +661,81 @@ void CDatabase::RollbackTransaction()
   {
     CLog::Log(LOGERROR, "database:rollbacktransaction failed");
   }
+
+  if (InBatch())
+    ClearBatchCache();
+}
+
+bool CDatabase::ExecuteSavepoint(const std::string &statement)
+{
+  try
+  {
+    if (NULL == m_pDB.get())
+      return false;
+
+    // use a dataset of our own so we don't clobber a query in progress on m_pDS/m_pDS2
+    std::unique_ptr<dbiplus::Dataset> ds(m_pDB->CreateDataset());
+    ds->exec(statement);
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "database:%s failed", statement.c_str());
+  }
+  return false;
+}
+
+bool CDatabase::BeginBatch()
+{
+  if (InBatch() || NULL == m_pDB.get())
+    return false;
+
+  m_batch = true;
+  m_batchItem = false;
+  m_savepointDepth = 0;
+  m_batchTransaction = false;
+  return true;
+}
+
+void CDatabase::BeginBatchItem()
+{
+  if (InBatch())
+    m_batchItem = true;
+}
+
+bool CDatabase::BatchItemDone()
+{
+  if (!m_batchItem)
+    return true;
+
+  m_batchItem = false;
+  if (!m_batchTransaction)
+    return true;
+
+  if (m_savepointDepth > 0)
+  {
+    CLog::Log(LOGWARNING, "%s - committing with %u nested transactions still open", __FUNCTION__, m_savepointDepth);
+    m_savepointDepth = 0;
+  }
+
+  m_batchTransaction = false;
+  return CommitTransaction();
+}
+
+bool CDatabase::EndBatch()
+{
+  if (!InBatch())
+    return false;
+
+  bool ret = BatchItemDone();
+  m_batch = false;
+  ClearBatchCache();
+  return ret;
 }
 
 bool CDatabase::InTransaction()
 {
-  if (NULL != m_pDB.get()) return false;
+  if (NULL == m_pDB.get()) return false;
   return m_pDB->in_transaction();
 }
 
@@ -87,6 +87,47 @@ public:
   virtual bool CommitTransaction();
   void RollbackTransaction();
   bool InTransaction();
+
+  /*!
+   * @brief Start writing many items. While a batch is open, derived classes
+   *        may cache the ids they look up, and the writes of each item can be
+   *        grouped with BeginBatchItem() and BatchItemDone().
+   * @return true if the batch was started, false if one is already open.
+   * @sa BeginBatchItem, BatchItemDone, EndBatch
+   */
+  bool BeginBatch();
+
+  /*!
+   * @brief Group the writes of one item into a single transaction. Until
+   *        BatchItemDone(), the first BeginTransaction() starts the item
+   *        transaction and BeginTransaction(), CommitTransaction() and
+   *        RollbackTransaction() map to savepoints within it, so the writes
+   *        keep their all-or-nothing semantics without paying for their own
+   *        commit. The database is locked for other writers until
+   *        BatchItemDone(), so don't access files or the network in between.
+   * @sa BeginBatch, BatchItemDone
+   */
+  void BeginBatchItem();
+
+  /*!
+   * @brief Commit the writes of the item started with BeginBatchItem().
+   * @return True if the writes were committed or there were none, false otherwise.
+   * @sa BeginBatchItem
+   */
+  bool BatchItemDone();
+
+  /*!
+   * @brief Commit the writes of an open item and close the batch.
+   * @return True if the pending writes were committed, false otherwise.
+   * @sa BeginBatch
+   */
+  virtual bool EndBatch();
+
+  /*!
+   * @brief Whether a batch started with BeginBatch() is open.
+   */
+  bool InBatch() const { return m_batch; }
+
   void CopyDB(const std::string& latestDb);
   void DropAnalytics();
 
@@ -217,6 +258,11 @@ protected:
 
   bool BuildSQL(const std::string &strQuery, const Filter &filter, std::string &strSQL);
 
+  /*! \brief Drop any ids cached for the duration of a batch.
+   Called when writes within the batch have been rolled back and when the batch is closed.
+   */
+  virtual void ClearBatchCache() {};
+
   bool m_sqlite; ///< \brief whether we use sqlite (defaults to true)
 
   std::unique_ptr<dbiplus::Database> m_pDB;
@@ -230,10 +276,16 @@ protected:
 private:
   void InitSettings(DatabaseSettings &dbSettings);
   void UpdateVersionNumber();
+  bool ExecuteSavepoint(const std::string &statement);
 
   bool m_bMultiWrite; /*!< True if there are any queries in the queue, false otherwise */
   unsigned int m_openCount;
 
   bool m_multipleExecute;
   std::vector<std::string> m_multipleQueries;
+
+  bool m_batch; /*!< True if a batch is open, false otherwise */
+  bool m_batchItem; /*!< True if the writes of an item are being grouped, false otherwise */
+  unsigned int m_savepointDepth; /*!< number of nested transactions open within the item transaction */
+  bool m_batchTransaction; /*!< True if the item transaction has been started, false otherwise */
 };
@@ -0,0 +1,136 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+
+#include "dbwrappers/Database.h"
+#include "dbwrappers/dataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+
+#include "gtest/gtest.h"
+
+class CTestDatabase : public CDatabase
+{
+protected:
+  void CreateTables() override
+  {
+    m_pDS->exec("CREATE TABLE item (idItem integer primary key, strName text)\n");
+  }
+  void CreateAnalytics() override {}
+  int GetSchemaVersion() const override { return 1; }
+  const char *GetBaseDBName() const override { return "TestBatch"; }
+};
+
+class TestDatabaseBatch : public ::testing::Test
+{
+protected:
+  DatabaseSettings settings;
+  CTestDatabase database;
+  CTestDatabase other;  ///< a second connection that only sees committed writes
+
+  void SetUp() override
+  {
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+    XFILE::CFile::Delete(settings.host + "TestBatch.db");
+
+    ASSERT_TRUE(database.Connect("TestBatch", settings, true));
+    ASSERT_TRUE(other.Connect("TestBatch", settings, false));
+  }
+
+  void TearDown() override
+  {
+    database.Close();
+    other.Close();
+    XFILE::CFile::Delete(settings.host + "TestBatch.db");
+  }
+
+  void AddItem(const std::string &name)
+  {
+    database.BeginTransaction();
+    EXPECT_TRUE(database.ExecuteQuery(database.PrepareSQL("INSERT INTO item (strName) VALUES ('%s')", name.c_str())));
+    EXPECT_TRUE(database.CommitTransaction());
+  }
+
+  int CommittedItems()
+  {
+    return atoi(other.GetSingleValue("SELECT COUNT(*) FROM item").c_str());
+  }
+};
+
+TEST_F(TestDatabaseBatch, ItemWritesShareOneTransaction)
+{
+  EXPECT_TRUE(database.BeginBatch());
+  EXPECT_FALSE(database.BeginBatch());
+
+  database.BeginBatchItem();
+  EXPECT_FALSE(database.InTransaction());
+  AddItem("a");
+  AddItem("b");
+  EXPECT_TRUE(database.InTransaction());
+  EXPECT_EQ(0, CommittedItems());
+
+  EXPECT_TRUE(database.BatchItemDone());
+  EXPECT_FALSE(database.InTransaction());
+  EXPECT_EQ(2, CommittedItems());
+
+  EXPECT_TRUE(database.EndBatch());
+  EXPECT_FALSE(database.InBatch());
+}
+
+TEST_F(TestDatabaseBatch, RollbackOnlyUndoesItsOwnWrites)
+{
+  database.BeginBatch();
+  database.BeginBatchItem();
+  AddItem("a");
+
+  database.BeginTransaction();
+  database.ExecuteQuery("INSERT INTO item (strName) VALUES ('b')");
+  database.RollbackTransaction();
+  EXPECT_TRUE(database.InTransaction());
+
+  EXPECT_TRUE(database.BatchItemDone());
+  EXPECT_EQ(1, CommittedItems());
+  EXPECT_EQ("a", other.GetSingleValue("item", "strName"));
+  database.EndBatch();
+}
+
+TEST_F(TestDatabaseBatch, WritesOutsideItemsAreNotHeld)
+{
+  database.BeginBatch();
+  AddItem("a");
+  EXPECT_FALSE(database.InTransaction());
+  EXPECT_EQ(1, CommittedItems());
+  database.EndBatch();
+}
+
+TEST_F(TestDatabaseBatch, EndBatchCommitsOpenItem)
+{
+  database.BeginBatch();
+  database.BeginBatchItem();
+  AddItem("a");
+  EXPECT_EQ(0, CommittedItems());
+
+  EXPECT_TRUE(database.EndBatch());
+  EXPECT_FALSE(database.InTransaction());
+  EXPECT_EQ(1, CommittedItems());
+}
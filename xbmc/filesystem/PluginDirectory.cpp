@@ -18,6 +18,8 @@
  *
  */
 
+#include <algorithm>
+
 #include "Application.h"
 #include "threads/SystemClock.h"
 #include "PluginDirectory.h"
@@ -27,6 +29,9 @@
 #include "addons/IAddon.h"
 #include "interfaces/generic/ScriptInvocationManager.h"
 #include "threads/SingleLock.h"
+#include "guilib/GUIComponent.h"
+#include "guilib/GUIMessage.h"
+#include "GUIUserMessages.h"
 #include "guilib/GUIWindowManager.h"
 #include "dialogs/GUIDialogBusy.h"
 #include "settings/Settings.h"
@@ -45,6 +50,13 @@ using namespace KODI::MESSAGING;
 std::map<int, CPluginDirectory *> CPluginDirectory::globalHandles;
 int CPluginDirectory::handleCounter = 0;
 CCriticalSection CPluginDirectory::m_handleLock;
+std::map<std::string, CPluginDirectory::CachedListing> CPluginDirectory::listingCache;
+CCriticalSection CPluginDirectory::m_listingCacheLock;
+
+// Maximum number of plugin listings kept in memory
+#define PLUGIN_LISTING_CACHE_SIZE 50
+// Maximum time a plugin may ask us to keep (or refresh) a listing for, in seconds
+#define PLUGIN_LISTING_MAX_CACHE_TIME 86400
 
 CPluginDirectory::CScriptObserver::CScriptObserver(int scriptId, CEvent &event) :
   CThread("scriptobs"), m_scriptId(scriptId), m_event(event)
@@ -75,6 +87,8 @@ CPluginDirectory::CPluginDirectory()
   , m_cancelled(false)
   , m_success(false)
   , m_totalItems(0)
+  , m_cacheTime(0)
+  , m_staleTime(0)
 {
   m_listItems = new CFileItemList;
   m_fileResult = new CFileItem;
@@ -142,6 +156,8 @@ bool CPluginDirectory::StartScript(const std::string& strPath, bool retrievingDi
   m_cancelled = false;
   m_success = false;
   m_totalItems = 0;
+  m_cacheTime = 0;
+  m_staleTime = 0;
 
   // setup our parameters to send the script
   std::string strHandle = StringUtils::Format("%i", handle);
@@ -225,7 +241,8 @@ bool CPluginDirectory::AddItems(int handle, const CFileItemList *items, int tota
   return !dir->m_cancelled;
 }
 
-void CPluginDirectory::EndOfDirectory(int handle, bool success, bool replaceListing, bool cacheToDisc)
+void CPluginDirectory::EndOfDirectory(int handle, bool success, bool replaceListing, bool cacheToDisc,
+                                      int cacheTime /* = 0 */, int staleTime /* = 0 */)
 {
   CSingleLock lock(m_handleLock);
   CPluginDirectory *dir = dirFromHandle(handle);
@@ -235,6 +252,10 @@ void CPluginDirectory::EndOfDirectory(int handle, bool success, bool replaceList
   // set cache to disc
   dir->m_listItems->SetCacheToDisc(cacheToDisc ? CFileItemList::CACHE_IF_SLOW : CFileItemList::CACHE_NEVER);
 
+  // how long we may serve this listing without running the plugin again
+  dir->m_cacheTime = std::min(std::max(cacheTime, 0), PLUGIN_LISTING_MAX_CACHE_TIME);
+  dir->m_staleTime = std::min(std::max(staleTime, 0), PLUGIN_LISTING_MAX_CACHE_TIME);
+
   dir->m_success = success;
   dir->m_listItems->SetReplaceListing(replaceListing);
 
@@ -434,7 +455,20 @@ void CPluginDirectory::AddSortMethod(int handle, SORT_METHOD sortMethod, const s
 bool CPluginDirectory::GetDirectory(const CURL& url, CFileItemList& items)
 {
   const std::string pathToUrl(url.Get());
+
+  // serve listings the plugin allowed us to cache without running it
+  const std::string key = GetCacheKey(pathToUrl);
+  bool stale = false;
+  if (!key.empty() && GetCachedListing(key, items, stale))
+  {
+    if (stale)
+      RefreshCachedListing(pathToUrl, key);
+    return true;
+  }
+
   bool success = StartScript(pathToUrl, true, false);
+  if (success && !key.empty())
+    CacheListing(key);
 
   // append the items to the list
   items.Assign(*m_listItems, true); // true to keep the current items
@@ -591,3 +625,120 @@ float CPluginDirectory::GetProgress() const
     return (m_listItems->Size() * 100.0f) / m_totalItems;
   return 0.0f;
 }
+
+std::string CPluginDirectory::GetCacheKey(const std::string& strPath)
+{
+  // a new version of the plugin may list things differently
+  AddonPtr addon;
+  if (!CServiceBroker::GetAddonMgr().GetAddon(CURL(strPath).GetHostName(), addon, ADDON_UNKNOWN))
+    return "";
+  return strPath + "|" + addon->Version().asString();
+}
+
+bool CPluginDirectory::GetCachedListing(const std::string& key, CFileItemList& items, bool& stale)
+{
+  std::shared_ptr<const CFileItemList> cachedItems;
+  {
+    CSingleLock lock(m_listingCacheLock);
+    auto it = listingCache.find(key);
+    if (it == listingCache.end())
+      return false;
+
+    const CachedListing& listing = it->second;
+    unsigned int age = XbmcThreads::SystemClockMillis() - listing.created;
+    if (age >= listing.cacheTime + listing.staleTime)
+    {
+      listingCache.erase(it);
+      return false;
+    }
+
+    stale = age >= listing.cacheTime;
+    // a refresh is already on its way
+    if (stale && listing.refreshing)
+      stale = false;
+    cachedItems = listing.items;
+  }
+
+  CLog::Log(LOGDEBUG, "%s - using cached listing of %s%s", __FUNCTION__, cachedItems->GetPath().c_str(), stale ? " (stale)" : "");
+
+  // windows modify the items they show, so hand out copies
+  CFileItemList copy;
+  copy.Copy(*cachedItems);
+  items.Assign(copy, true);
+  return true;
+}
+
+void CPluginDirectory::RefreshCachedListing(const std::string& strPath, const std::string& key)
+{
+  {
+    CSingleLock lock(m_listingCacheLock);
+    auto it = listingCache.find(key);
+    if (it == listingCache.end() || it->second.refreshing)
+      return;
+    it->second.refreshing = true;
+  }
+
+  CJobManager::GetInstance().Submit([strPath, key]() {
+    CPluginDirectory dir;
+    if (dir.StartScript(strPath, true, false))
+    {
+      dir.CacheListing(key);
+
+      // let the window showing the stale listing pick up the new one
+      CGUIMessage message(GUI_MSG_NOTIFY_ALL, 0, 0, GUI_MSG_UPDATE_PATH);
+      message.SetStringParam(strPath);
+      CServiceBroker::GetGUI()->GetWindowManager().SendThreadMessage(message);
+    }
+    else
+    {
+      // run the plugin the next time the listing is requested
+      CSingleLock lock(m_listingCacheLock);
+      listingCache.erase(key);
+    }
+  });
+}
+
+void CPluginDirectory::ClearCachedListing(const std::string& strPath)
+{
+  const std::string prefix = strPath + "|";
+
+  CSingleLock lock(m_listingCacheLock);
+  for (auto it = listingCache.begin(); it != listingCache.end();)
+  {
+    if (StringUtils::StartsWith(it->first, prefix))
+      it = listingCache.erase(it);
+    else
+      ++it;
+  }
+}
+
+void CPluginDirectory::CacheListing(const std::string& key)
+{
+  CSingleLock lock(m_listingCacheLock);
+  if (m_cacheTime <= 0)
+  {
+    listingCache.erase(key);
+    return;
+  }
+
+  std::shared_ptr<CFileItemList> items(new CFileItemList);
+  items->Copy(*m_listItems);
+
+  CachedListing& listing = listingCache[key];
+  listing.items = items;
+  listing.created = XbmcThreads::SystemClockMillis();
+  listing.cacheTime = m_cacheTime * 1000;
+  listing.staleTime = m_staleTime * 1000;
+  listing.refreshing = false;
+
+  while (listingCache.size() > PLUGIN_LISTING_CACHE_SIZE)
+  {
+    auto oldest = listingCache.begin();
+    for (auto it = listingCache.begin(); it != listingCache.end(); ++it)
+    {
+      if (it->second.created < oldest->second.created)
+        oldest = it;
+    }
+    listingCache.erase(oldest);
+  }
+}
@@ -23,6 +23,7 @@
 #include "SortFileItem.h"
 
 #include <atomic>
+#include <memory>
 #include <string>
 #include <map>
 #include "threads/CriticalSection.h"
@@ -55,7 +56,8 @@ public:
   // callbacks from python
   static bool AddItem(int handle, const CFileItem *item, int totalItems);
   static bool AddItems(int handle, const CFileItemList *items, int totalItems);
-  static void EndOfDirectory(int handle, bool success, bool replaceListing, bool cacheToDisc);
+  static void EndOfDirectory(int handle, bool success, bool replaceListing, bool cacheToDisc,
+                             int cacheTime = 0, int staleTime = 0);
   static void AddSortMethod(int handle, SORT_METHOD sortMethod, const std::string &label2Mask);
   static std::string GetSetting(int handle, const std::string &key);
   static void SetSetting(int handle, const std::string &key, const std::string &value);
@@ -64,11 +66,37 @@ public:
   static void SetResolvedUrl(int handle, bool success, const CFileItem* resultItem);
   static void SetLabel2(int handle, const std::string& ident);
 
+  /*! \brief Drop the cached listing of the given plugin path, e.g. when the
+   user explicitly refreshes it.
+   */
+  static void ClearCachedListing(const std::string& strPath);
+
 private:
+  friend class TestPluginDirectoryHelper;
+
   ADDON::AddonPtr m_addon;
   bool StartScript(const std::string& strPath, bool retrievingDir, bool resume);
   bool WaitOnScriptResult(const std::string &scriptPath, int scriptId, const std::string &scriptName, bool retrievingDir);
 
+  /*! \brief A listing the plugin allowed us to cache through endOfDirectory()
+   */
+  struct CachedListing
+  {
+    std::shared_ptr<const CFileItemList> items;
+    unsigned int created;   ///< time the listing was stored, in ms
+    unsigned int cacheTime; ///< time the listing is served without running the plugin, in ms
+    unsigned int staleTime; ///< time after cacheTime the listing is served while being refreshed, in ms
+    bool refreshing;
+  };
+
+  static std::string GetCacheKey(const std::string& strPath);
+  static bool GetCachedListing(const std::string& key, CFileItemList& items, bool& stale);
+  static void RefreshCachedListing(const std::string& strPath, const std::string& key);
+  void CacheListing(const std::string& key);
+
+  static std::map<std::string, CachedListing> listingCache;
+  static CCriticalSection m_listingCacheLock;
+
   static std::map<int,CPluginDirectory*> globalHandles;
   static int getNewHandle(CPluginDirectory *cp);
   static void removeHandle(int handle);
@@ -83,6 +111,8 @@ private:
   std::atomic<bool> m_cancelled;
   bool          m_success;      // set by script in EndOfDirectory
   int    m_totalItems;   // set by script in AddDirectoryItem
+  int    m_cacheTime;    // set by script in EndOfDirectory, in seconds
+  int    m_staleTime;    // set by script in EndOfDirectory, in seconds
 
   class CScriptObserver : public CThread
   {
@@ -0,0 +1,185 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "filesystem/PluginDirectory.h"
+#include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <climits>
+#include <memory>
+#include <string>
+
+namespace XFILE
+{
+class TestPluginDirectoryHelper
+{
+public:
+  static void Cache(const std::string& key, int cacheTime, int staleTime)
+  {
+    CPluginDirectory dir;
+    dir.m_listItems->SetPath(key);
+    dir.m_listItems->Add(std::make_shared<CFileItem>(key + "item", false));
+    dir.m_cacheTime = cacheTime;
+    dir.m_staleTime = staleTime;
+    dir.CacheListing(key);
+  }
+
+  static bool Get(const std::string& key, bool& stale)
+  {
+    CFileItemList items;
+    return CPluginDirectory::GetCachedListing(key, items, stale) && items.Size() == 1;
+  }
+
+  // makes the listing look older than it is
+  static void Age(const std::string& key, unsigned int ms)
+  {
+    CSingleLock lock(CPluginDirectory::m_listingCacheLock);
+    CPluginDirectory::listingCache[key].created -= ms;
+  }
+
+  static void SetRefreshing(const std::string& key)
+  {
+    CSingleLock lock(CPluginDirectory::m_listingCacheLock);
+    CPluginDirectory::listingCache[key].refreshing = true;
+  }
+
+  static bool Has(const std::string& key)
+  {
+    CSingleLock lock(CPluginDirectory::m_listingCacheLock);
+    return CPluginDirectory::listingCache.find(key) != CPluginDirectory::listingCache.end();
+  }
+
+  static size_t Size()
+  {
+    CSingleLock lock(CPluginDirectory::m_listingCacheLock);
+    return CPluginDirectory::listingCache.size();
+  }
+
+  static void Clear()
+  {
+    CSingleLock lock(CPluginDirectory::m_listingCacheLock);
+    CPluginDirectory::listingCache.clear();
+  }
+
+  static void EndOfDirectory(int cacheTime, int staleTime, int& storedCacheTime, int& storedStaleTime)
+  {
+    CPluginDirectory dir;
+    int handle = CPluginDirectory::getNewHandle(&dir);
+    CPluginDirectory::EndOfDirectory(handle, true, false, false, cacheTime, staleTime);
+    CPluginDirectory::removeHandle(handle);
+    storedCacheTime = dir.m_cacheTime;
+    storedStaleTime = dir.m_staleTime;
+  }
+};
+}
+
+using namespace XFILE;
+
+class TestPluginDirectory : public testing::Test
+{
+protected:
+  TestPluginDirectory() { TestPluginDirectoryHelper::Clear(); }
+  ~TestPluginDirectory() override { TestPluginDirectoryHelper::Clear(); }
+};
+
+TEST_F(TestPluginDirectory, ListingExpires)
+{
+  const std::string key = "plugin://plugin.test/|1.0.0";
+  bool stale = true;
+
+  TestPluginDirectoryHelper::Cache(key, 10, 0);
+  EXPECT_TRUE(TestPluginDirectoryHelper::Get(key, stale));
+  EXPECT_FALSE(stale);
+
+  TestPluginDirectoryHelper::Age(key, 10 * 1000);
+  EXPECT_FALSE(TestPluginDirectoryHelper::Get(key, stale));
+  EXPECT_FALSE(TestPluginDirectoryHelper::Has(key));
+}
+
+TEST_F(TestPluginDirectory, StaleListingIsRefreshedOnce)
+{
+  const std::string key = "plugin://plugin.test/|1.0.0";
+  bool stale = false;
+
+  TestPluginDirectoryHelper::Cache(key, 10, 60);
+  TestPluginDirectoryHelper::Age(key, 20 * 1000);
+  EXPECT_TRUE(TestPluginDirectoryHelper::Get(key, stale));
+  EXPECT_TRUE(stale);
+
+  // while a refresh is running the listing is served without starting another one
+  TestPluginDirectoryHelper::SetRefreshing(key);
+  EXPECT_TRUE(TestPluginDirectoryHelper::Get(key, stale));
+  EXPECT_FALSE(stale);
+
+  TestPluginDirectoryHelper::Age(key, 60 * 1000);
+  EXPECT_FALSE(TestPluginDirectoryHelper::Get(key, stale));
+}
+
+TEST_F(TestPluginDirectory, NotCacheable)
+{
+  const std::string key = "plugin://plugin.test/|1.0.0";
+  bool stale;
+
+  TestPluginDirectoryHelper::Cache(key, 10, 0);
+  // a listing that isn't cacheable anymore replaces the cached one
+  TestPluginDirectoryHelper::Cache(key, 0, 0);
+  EXPECT_FALSE(TestPluginDirectoryHelper::Get(key, stale));
+}
+
+TEST_F(TestPluginDirectory, EvictsOldestListing)
+{
+  const int count = 51;
+  for (int i = 0; i < count; i++)
+  {
+    const std::string key = StringUtils::Format("plugin://plugin.test/%i/|1.0.0", i);
+    TestPluginDirectoryHelper::Cache(key, 10, 0);
+    TestPluginDirectoryHelper::Age(key, (count - i) * 10);
+  }
+
+  EXPECT_EQ(50u, TestPluginDirectoryHelper::Size());
+  EXPECT_FALSE(TestPluginDirectoryHelper::Has("plugin://plugin.test/0/|1.0.0"));
+  EXPECT_TRUE(TestPluginDirectoryHelper::Has("plugin://plugin.test/1/|1.0.0"));
+  EXPECT_TRUE(TestPluginDirectoryHelper::Has("plugin://plugin.test/50/|1.0.0"));
+}
+
+TEST_F(TestPluginDirectory, ClearCachedListing)
+{
+  TestPluginDirectoryHelper::Cache("plugin://plugin.test/|1.0.0", 10, 0);
+  TestPluginDirectoryHelper::Cache("plugin://plugin.test/sub/|1.0.0", 10, 0);
+
+  CPluginDirectory::ClearCachedListing("plugin://plugin.test/");
+  EXPECT_FALSE(TestPluginDirectoryHelper::Has("plugin://plugin.test/|1.0.0"));
+  EXPECT_TRUE(TestPluginDirectoryHelper::Has("plugin://plugin.test/sub/|1.0.0"));
+}
+
+TEST_F(TestPluginDirectory, CacheTimesAreClamped)
+{
+  int cacheTime, staleTime;
+  TestPluginDirectoryHelper::EndOfDirectory(INT_MAX, INT_MAX, cacheTime, staleTime);
+  EXPECT_EQ(86400, cacheTime);
+  EXPECT_EQ(86400, staleTime);
+
+  TestPluginDirectoryHelper::EndOfDirectory(-1, INT_MIN, cacheTime, staleTime);
+  EXPECT_EQ(0, cacheTime);
+  EXPECT_EQ(0, staleTime);
+}
@@ -22,6 +22,7 @@
 
 #include <utility>
 
+#include "GUITextLayout.h"
 #include "addons/Skin.h"
 #include "filesystem/SpecialProtocol.h"
 #include "utils/log.h"
@@ -47,6 +48,8 @@ void CGUIColorManager::Clear()
 void CGUIColorManager::Load(const std::string &colorFile)
 {
   Clear();
+  // cached layouts hold colors resolved with the old color map
+  CGUITextLayout::ClearLayoutCache();
 
   // load the global color map if it exists
   CXBMCTinyXML xmlDoc;
@@ -19,12 +19,23 @@
  */
 
 #include "GUIControlProfiler.h"
+
+#include <algorithm>
+#include <inttypes.h>
+
+#include "GUIComponent.h"
+#include "GUIInfoManager.h"
+#include "GUITextLayout.h"
+#include "ServiceBroker.h"
 #include "utils/XBMCTinyXML.h"
 #include "utils/TimeUtils.h"
 #include "utils/StringUtils.h"
 
 bool CGUIControlProfiler::m_bIsRunning = false;
 
+// number of conditions reported in the results, ordered by cost
+static const size_t MAX_PROFILED_CONDITIONS = 50;
+
 CGUIControlProfilerItem::CGUIControlProfilerItem(CGUIControlProfiler *pProfiler, CGUIControlProfilerItem *pParent, CGUIControl *pControl)
 : m_pProfiler(pProfiler), m_pParent(pParent), m_pControl(pControl), m_visTime(0), m_renderTime(0), m_i64VisStart(0), m_i64RenderStart(0)
 {
@@ -229,7 +240,8 @@ CGUIControlProfilerItem *CGUIControlProfilerItem::FindOrAddControl(CGUIControl *
 }
 
 CGUIControlProfiler::CGUIControlProfiler(void)
-: m_ItemHead(NULL, NULL, NULL), m_pLastItem(NULL), m_iMaxFrameCount(200), m_iFrameCount(0)
+: m_ItemHead(NULL, NULL, NULL), m_pLastItem(NULL), m_iMaxFrameCount(200), m_iFrameCount(0),
+  m_layoutCacheHits(0), m_layoutCacheMisses(0)
 // m_bIsRunning(false), no isRunning because it is static
 {
   m_fPerfScale = 100000.0f / CurrentHostFrequency();
@@ -252,6 +264,10 @@ void CGUIControlProfiler::Start(void)
   m_bIsRunning = true;
   m_pLastItem = NULL;
   m_ItemHead.Reset(this);
+  // the layout cache counts since startup, remember where this run started
+  CGUITextLayout::GetLayoutCacheStats(m_layoutCacheHits, m_layoutCacheMisses);
+  CServiceBroker::GetGUI()->GetInfoManager().ResetInfoBoolProfiles();
+  INFO::InfoBool::SetProfiling(true);
 }
 
 void CGUIControlProfiler::BeginVisibility(CGUIControl *pControl)
@@ -319,6 +335,12 @@ void CGUIControlProfiler::EndFrame(void)
       m_ItemHead.m_renderTime += p->m_renderTime;
     }
 
+    uint64_t hits, misses;
+    CGUITextLayout::GetLayoutCacheStats(hits, misses);
+    m_layoutCacheHits = hits - m_layoutCacheHits;
+    m_layoutCacheMisses = misses - m_layoutCacheMisses;
+    INFO::InfoBool::SetProfiling(false);
+
     m_bIsRunning = false;
     if (SaveResults())
       m_ItemHead.Reset(this);
@@ -340,6 +362,47 @@ bool CGUIControlProfiler::SaveResults(void)
   root->SetAttribute("timeunit", "ms");
   doc.LinkEndChild(root);
 
+  TiXmlElement *layoutCache = new TiXmlElement("textlayoutcache");
+  str = StringUtils::Format("%" PRIu64, m_layoutCacheHits);
+  layoutCache->SetAttribute("hits", str.c_str());
+  str = StringUtils::Format("%" PRIu64, m_layoutCacheMisses);
+  layoutCache->SetAttribute("misses", str.c_str());
+  uint64_t lookups = m_layoutCacheHits + m_layoutCacheMisses;
+  if (lookups)
+  {
+    str = StringUtils::Format("%.0f", 100.0 * m_layoutCacheHits / lookups);
+    layoutCache->SetAttribute("hitrate", str.c_str());
+  }
+  root->LinkEndChild(layoutCache);
+
+  // the most expensive conditions, time includes that of any conditions they depend on
+  std::vector<INFO::InfoPtr> bools;
+  CServiceBroker::GetGUI()->GetInfoManager().GetInfoBools(bools);
+  bools.erase(std::remove_if(bools.begin(), bools.end(),
+                             [](const INFO::InfoPtr &info) { return info->GetEvaluationCount() == 0; }),
+              bools.end());
+  std::sort(bools.begin(), bools.end(), [](const INFO::InfoPtr &left, const INFO::InfoPtr &right)
+  {
+    return left->GetEvaluationTime() > right->GetEvaluationTime();
+  });
+  if (bools.size() > MAX_PROFILED_CONDITIONS)
+    bools.resize(MAX_PROFILED_CONDITIONS);
+
+  TiXmlElement *conditions = new TiXmlElement("conditions");
+  for (const auto &info : bools)
+  {
+    TiXmlElement *condition = new TiXmlElement("condition");
+    condition->SetAttribute("context", info->GetContext());
+    str = StringUtils::Format("%u", info->GetEvaluationCount());
+    condition->SetAttribute("evaluations", str.c_str());
+    // Note time is stored in 1/100 milliseconds but reported in ms
+    str = StringUtils::Format("%.2f", m_fPerfScale * info->GetEvaluationTime() / 100.0f);
+    condition->SetAttribute("time", str.c_str());
+    condition->LinkEndChild(new TiXmlText(info->GetExpression().c_str()));
+    conditions->LinkEndChild(condition);
+  }
+  root->LinkEndChild(conditions);
+
   m_ItemHead.SaveToXML(root);
   return doc.SaveFile(m_strOutputFile);
 }
@@ -93,6 +93,8 @@ private:
   std::string m_strOutputFile;
   int m_iMaxFrameCount;
   int m_iFrameCount;
+  uint64_t m_layoutCacheHits;   //!< text layout cache hits during the run
+  uint64_t m_layoutCacheMisses; //!< text layout cache misses during the run
 };
 
 #define GUIPROFILER_VISIBILITY_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginVisibility(x); }
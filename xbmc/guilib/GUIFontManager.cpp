@@ -27,6 +27,7 @@
 #include "addons/FontResource.h"
 #include "GUIFontTTF.h"
 #include "GUIFont.h"
+#include "GUITextLayout.h"
 #include "utils/XMLUtils.h"
 #include "GUIControlFactory.h"
 #include "filesystem/Directory.h"
@@ -170,6 +171,9 @@ CGUIFont* GUIFontManager::LoadTTF(const std::string& strFontName, const std::str
   CGUIFont *pNewFont = new CGUIFont(strFontName, iStyle, textColor, shadowColor, lineSpacing, (float)iSize, pFontFile);
   m_vecFonts.push_back(pNewFont);
 
+  // get the glyphs most text needs ready before the first frame shows them
+  pFontFile->PrewarmCharacters(iStyle);
+
   // Store the original TTF font info in case we need to reload it in a different resolution
   OrigFontInfo fontInfo;
   fontInfo.size = iSize;
@@ -195,6 +199,12 @@ bool GUIFontManager::OnMessage(CGUIMessage &message)
     return true;
   }
 
+  if (message.GetParam1() == GUI_MSG_FONT_GLYPHS_READY)
+  { // controls showing placeholders aren't dirty by themselves
+    CServiceBroker::GetGUI()->GetWindowManager().MarkDirty();
+    return true;
+  }
+
   if (message.GetParam1() == GUI_MSG_RENDERER_RESET)
   { // our device has been reset - we have to reload our ttf fonts, and send
     // a message to controls that we have done so
@@ -221,6 +231,9 @@ void GUIFontManager::ReloadTTFFonts(void)
   if (!m_vecFonts.size())
     return;   // we haven't even loaded fonts in yet
 
+  // cached layouts were measured with the old font files
+  CGUITextLayout::ClearLayoutCache();
+
   for (unsigned int i = 0; i < m_vecFonts.size(); i++)
   {
     CGUIFont* font = m_vecFonts[i];
@@ -250,6 +263,7 @@ void GUIFontManager::ReloadTTFFonts(void)
     }
 
     font->SetFont(pFontFile);
+    pFontFile->PrewarmCharacters(font->GetStyle());
   }
 }
 
@@ -259,6 +273,7 @@ void GUIFontManager::Unload(const std::string& strFontName)
   {
     if (StringUtils::EqualsNoCase((*iFont)->GetFontName(), strFontName))
     {
+      CGUITextLayout::ClearLayoutCache();
       delete (*iFont);
       m_vecFonts.erase(iFont);
       return;
@@ -340,6 +355,8 @@ CGUIFont* GUIFontManager::GetDefaultFont(bool border)
 
 void GUIFontManager::Clear()
 {
+  CGUITextLayout::ClearLayoutCache();
+
   for (int i = 0; i < (int)m_vecFonts.size(); ++i)
   {
     CGUIFont* pFont = m_vecFonts[i];
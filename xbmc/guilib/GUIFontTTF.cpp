@@ -21,6 +21,9 @@
 #include "GUIFont.h"
 #include "GUIFontTTF.h"
 #include "GUIFontManager.h"
+#include "GUIComponent.h"
+#include "GUIMessage.h"
+#include "GUIWindowManager.h"
 #include "Texture.h"
 #include "windowing/GraphicContext.h"
 #include "ServiceBroker.h"
@@ -31,11 +34,17 @@
 #include "windowing/WinSystem.h"
 #include "URL.h"
 #include "filesystem/File.h"
+#include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
+#include "utils/JobManager.h"
+#include "utils/TimeUtils.h"
 
+#include <atomic>
+#include <deque>
 #include <math.h>
 #include <memory>
 #include <queue>
+#include <unordered_set>
 
 // stuff for freetype
 #include <ft2build.h>
@@ -45,6 +54,7 @@
 #endif
 
 #include FT_FREETYPE_H
+#include FT_ADVANCES_H
 #include FT_GLYPH_H
 #include FT_OUTLINE_H
 #include FT_STROKER_H
@@ -58,10 +68,60 @@
 #endif
 
 #define CHARS_PER_TEXTURE_LINE 20 // number of characters to cache per texture line
-#define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
 #define GLYPH_STRENGTH_BOLD 24
 #define GLYPH_STRENGTH_LIGHT -48
 
+namespace
+{
+// characters rasterised ahead of time by PrewarmCharacters(): printable ascii and latin-1
+const wchar_t PREWARM_RANGES[][2] = { { 0x20, 0x7e }, { 0xa0, 0xff } };
+
+FT_Pos GetBorderStrength(FT_Face face)
+{
+  FT_Pos strength = FT_MulFix(face->units_per_EM, face->size->metrics.y_scale) / 12;
+  if (strength < 128)
+    strength = 128;
+  return strength;
+}
+
+// advance of a glyph without loading it, close enough to lay out text until the glyph is rasterised
+float GetPlaceholderAdvance(FT_Face face, wchar_t letter, uint32_t style)
+{
+  FT_Fixed advance;
+  if (FT_Get_Advance(face, FT_Get_Char_Index(face, letter), FT_LOAD_TARGET_LIGHT, &advance))
+    return 0.0f;
+
+  // emboldening moves the right edge by half the strength, see SetGlyphStrength()
+  FT_Pos pos = advance >> 10;
+  FT_Pos strength = FT_MulFix(face->units_per_EM, face->size->metrics.y_scale);
+  if (style & FONT_STYLE_BOLD)
+    pos += strength / GLYPH_STRENGTH_BOLD / 2;
+  if (style & FONT_STYLE_LIGHT)
+    pos += strength / GLYPH_STRENGTH_LIGHT / 2;
+  return (float)MathUtils::round_int((float)pos / 64);
+}
+}
+
+class CGUIFontTTFBase::CPrerenderedGlyphs
+{
+public:
+  CPrerenderedGlyphs(const std::string &fileName, float height, float aspect, bool border)
+    : m_fileName(fileName), m_height(height), m_aspect(aspect), m_border(border) {}
+
+  const std::string m_fileName;
+  const float m_height;
+  const float m_aspect;
+  const bool m_border;
+
+  CCriticalSection m_critSection;
+  std::unordered_map<character_t, GlyphBitmap> m_glyphs;
+  std::deque<character_t> m_queue;            // glyphs waiting for the worker
+  std::unordered_set<character_t> m_requested; // queued, being rasterised or failed to rasterise
+  bool m_running = false;
+  bool m_cancelled = false;
+  std::atomic<bool> m_placeholdersReady{false}; // set once glyphs drawn as placeholders are ready
+};
+
 
 class CFreeTypeLibrary
 {
@@ -88,6 +148,14 @@ public:
       return NULL;
     }
 
+    return LoadFace(m_library, filename, size, aspect, memoryBuf);
+  }
+
+  /*! \brief load a face from the given library.
+   Freetype objects are not thread safe, so worker threads use their own library with this.
+   */
+  static FT_Face LoadFace(FT_Library library, const std::string &filename, float size, float aspect, XUTILS::auto_buffer& memoryBuf)
+  {
     FT_Face face;
 
     // ok, now load the font face
@@ -106,11 +174,11 @@ public:
       XFILE::CFile f;
       if (f.LoadFile(realFile, memoryBuf) <= 0)
         return NULL;
-      if (FT_New_Memory_Face(m_library, (const FT_Byte*)memoryBuf.get(), memoryBuf.size(), 0, &face) != 0)
+      if (FT_New_Memory_Face(library, (const FT_Byte*)memoryBuf.get(), memoryBuf.size(), 0, &face) != 0)
         return NULL;
     }
 #ifndef TARGET_WINDOWS
-    else if (FT_New_Face( m_library, realFile.GetFileName().c_str(), 0, &face ))
+    else if (FT_New_Face( library, realFile.GetFileName().c_str(), 0, &face ))
       return NULL;
 #endif // ! TARGET_WINDOWS
 
@@ -164,8 +232,6 @@ XBMC_GLOBAL_REF(CFreeTypeLibrary, g_freeTypeLibrary); // our freetype library
 CGUIFontTTFBase::CGUIFontTTFBase(const std::string& strFileName) : m_staticCache(*this), m_dynamicCache(*this)
 {
   m_texture = NULL;
-  m_char = NULL;
-  m_maxChars = 0;
   m_nestedBeginCount = 0;
 
   m_vertex.reserve(4*1024);
@@ -177,13 +243,15 @@ CGUIFontTTFBase::CGUIFontTTFBase(const std::string& strFileName) : m_staticCache
   m_referenceCount = 0;
   m_originX = m_originY = 0.0f;
   m_cellBaseLine = m_cellHeight = 0;
-  m_numChars = 0;
   m_posX = m_posY = 0;
   m_textureHeight = m_textureWidth = 0;
   m_textureScaleX = m_textureScaleY = 0.0;
   m_ellipsesWidth = m_height = 0.0f;
   m_color = 0;
   m_nTexture = 0;
+  m_aspect = 1.0f;
+  m_border = false;
+  m_prewarmedStyles = 0;
 
   m_renderSystem = CServiceBroker::GetRenderSystem();
 }
@@ -214,11 +282,9 @@ void CGUIFontTTFBase::ClearCharacterCache()
   DeleteHardwareTexture();
 
   m_texture = NULL;
-  delete[] m_char;
-  m_char = new Character[CHAR_CHUNK];
+  m_chars.clear();
+  m_textureLines.clear();
   memset(m_charquick, 0, sizeof(m_charquick));
-  m_numChars = 0;
-  m_maxChars = CHAR_CHUNK;
   // set the posX and posY so that our texture will be created on first character write.
   m_posX = m_textureWidth;
   m_posY = -(int)GetTextureLineHeight();
@@ -229,15 +295,22 @@ void CGUIFontTTFBase::Clear()
 {
   delete(m_texture);
   m_texture = NULL;
-  delete[] m_char;
+  m_chars.clear();
+  m_textureLines.clear();
   memset(m_charquick, 0, sizeof(m_charquick));
-  m_char = NULL;
-  m_maxChars = 0;
-  m_numChars = 0;
   m_posX = 0;
   m_posY = 0;
   m_nestedBeginCount = 0;
 
+  if (m_prerendered)
+  {
+    // any glyphs still being rasterised are dropped by the worker
+    CSingleLock lock(m_prerendered->m_critSection);
+    m_prerendered->m_cancelled = true;
+  }
+  m_prerendered.reset();
+  m_prewarmedStyles = 0;
+
   if (m_face)
     g_freeTypeLibrary.ReleaseFont(m_face);
   m_face = NULL;
@@ -288,9 +361,7 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
      add on the strength of any border - the non-bordered font needs
      aligning with the bordered font by utilising GetTextBaseLine()
      */
-    FT_Pos strength = FT_MulFix( m_face->units_per_EM, m_face->size->metrics.y_scale) / 12;
-    if (strength < 128)
-      strength = 128;
+    FT_Pos strength = GetBorderStrength(m_face);
 
     cellDescender -= strength;
     cellAscender  += strength;
@@ -309,14 +380,14 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
   m_cellHeight   = cellAscender - cellDescender;
 
   m_height = height;
+  m_aspect = aspect;
+  m_border = border;
 
   delete(m_texture);
   m_texture = NULL;
-  delete[] m_char;
-  m_char = NULL;
-
-  m_maxChars = 0;
-  m_numChars = 0;
+  m_chars.clear();
+  m_textureLines.clear();
+  memset(m_charquick, 0, sizeof(m_charquick));
 
   m_strFilename = strFilename;
 
@@ -342,6 +413,13 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
 
 void CGUIFontTTFBase::Begin()
 {
+  // cached vertices still show placeholders for glyphs that are ready now
+  if (m_nestedBeginCount == 0 && m_prerendered && m_prerendered->m_placeholdersReady.exchange(false))
+  {
+    m_staticCache.Flush();
+    m_dynamicCache.Flush();
+  }
+
   if (m_nestedBeginCount == 0 && m_texture != NULL && FirstBegin())
   {
     m_vertexTrans.clear();
@@ -620,60 +698,62 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   if (letter == L'\r')
     return NULL;
 
+  Character *ch = NULL;
+
   // quick access to ascii chars
   if (letter < 255)
   {
-    character_t ch = (style << 8) | letter;
-    if (ch < LOOKUPTABLE_SIZE && m_charquick[ch])
-      return m_charquick[ch];
+    character_t quick = (style << 8) | letter;
+    if (quick < LOOKUPTABLE_SIZE)
+      ch = m_charquick[quick];
   }
 
   // letters are stored based on style and letter
-  character_t ch = (style << 16) | letter;
+  character_t letterAndStyle = (style << 16) | letter;
 
-  int low = 0;
-  int high = m_numChars - 1;
-  while (low <= high)
+  if (!ch)
   {
-    int mid = (low + high) >> 1;
-    if (ch > m_char[mid].letterAndStyle)
-      low = mid + 1;
-    else if (ch < m_char[mid].letterAndStyle)
-      high = mid - 1;
-    else
-      return &m_char[mid];
+    auto it = m_chars.find(letterAndStyle);
+    if (it != m_chars.end())
+      ch = &it->second;
   }
-  // if we get to here, then low is where we should insert the new character
 
-  // increase the size of the buffer if we need it
-  if (m_numChars >= m_maxChars)
-  { // need to increase the size of the buffer
-    Character *newTable = new Character[m_maxChars + CHAR_CHUNK];
-    if (m_char)
-    {
-      memcpy(newTable, m_char, low * sizeof(Character));
-      memcpy(newTable + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
-      delete[] m_char;
-    }
-    m_char = newTable;
-    m_maxChars += CHAR_CHUNK;
+  if (ch && ch->placeholder)
+  {
+    // swap the placeholder for the real glyph once it has been rasterised
+    if (!HasPrerenderedGlyph(letterAndStyle))
+      return ch;
+    m_chars.erase(letterAndStyle);
+    ch = NULL;
+  }
 
+  if (ch)
+  {
+    if (ch->textureLine != NO_TEXTURE_LINE)
+      m_textureLines[ch->textureLine].lastUsed = CTimeUtils::GetFrameTime();
+    return ch;
   }
-  else
-  { // just move the data along as necessary
-    memmove(m_char + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
+
+  // characters beyond the prewarmed ones, like CJK, are rasterised on a worker thread
+  // instead of stalling the render thread, a blank glyph of the same advance stands in
+  if (letter > 0xff)
+  {
+    Character placeholder;
+    if (DeferCharacter(letter, style, &placeholder))
+      return &m_chars.emplace(letterAndStyle, placeholder).first->second;
   }
+
   // render the character to our texture
   // must End() as we can't render text to our texture during a Begin(), End() block
+  Character newChar;
   unsigned int nestedBeginCount = m_nestedBeginCount;
   m_nestedBeginCount = 1;
   if (nestedBeginCount) End();
-  if (!CacheCharacter(letter, style, m_char + low))
+  if (!CacheCharacter(letter, style, &newChar))
   { // unable to cache character - try clearing them all out and starting over
-    CLog::Log(LOGDEBUG, "%s: Unable to cache character.  Clearing character cache of %i characters", __FUNCTION__, m_numChars);
+    CLog::Log(LOGDEBUG, "%s: Unable to cache character.  Clearing character cache of %i characters", __FUNCTION__, static_cast<int>(m_chars.size()));
     ClearCharacterCache();
-    low = 0;
-    if (!CacheCharacter(letter, style, m_char + low))
+    if (!CacheCharacter(letter, style, &newChar))
     {
       CLog::Log(LOGERROR, "%s: Unable to cache character (out of memory?)", __FUNCTION__);
       if (nestedBeginCount) Begin();
@@ -684,111 +764,351 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   if (nestedBeginCount) Begin();
   m_nestedBeginCount = nestedBeginCount;
 
-  // fixup quick access
-  memset(m_charquick, 0, sizeof(m_charquick));
-  for(int i=0;i<m_numChars;i++)
-  {
-    if ((m_char[i].letterAndStyle & 0xffff) < 255)
-    {
-      character_t ch = ((m_char[i].letterAndStyle & 0xffff0000) >> 8) | (m_char[i].letterAndStyle & 0xff);
-      m_charquick[ch] = m_char+i;
-    }
-  }
+  // map nodes are stable, so the quick access table can point straight into it
+  ch = &m_chars.emplace(letterAndStyle, newChar).first->second;
+  if (ch->textureLine != NO_TEXTURE_LINE)
+    m_textureLines[ch->textureLine].chars.push_back(letterAndStyle);
+  if (letter < 255)
+    m_charquick[(style << 8) | letter] = ch;
 
-  return m_char + low;
+  return ch;
 }
 
-bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
+bool CGUIFontTTFBase::RenderGlyph(FT_Face face, FT_Stroker stroker, wchar_t letter, uint32_t style, GlyphBitmap &glyph)
 {
-  int glyph_index = FT_Get_Char_Index( m_face, letter );
+  int glyph_index = FT_Get_Char_Index( face, letter );
 
-  FT_Glyph glyph = NULL;
-  if (FT_Load_Glyph( m_face, glyph_index, FT_LOAD_TARGET_LIGHT ))
+  FT_Glyph ftGlyph = NULL;
+  if (FT_Load_Glyph( face, glyph_index, FT_LOAD_TARGET_LIGHT ))
   {
     CLog::Log(LOGDEBUG, "%s Failed to load glyph %x", __FUNCTION__, static_cast<uint32_t>(letter));
     return false;
   }
   // make bold if applicable
   if (style & FONT_STYLE_BOLD)
-    SetGlyphStrength(m_face->glyph, GLYPH_STRENGTH_BOLD);
+    SetGlyphStrength(face->glyph, GLYPH_STRENGTH_BOLD);
   // and italics if applicable
   if (style & FONT_STYLE_ITALICS)
-    ObliqueGlyph(m_face->glyph);
+    ObliqueGlyph(face->glyph);
   // and light if applicable
   if (style & FONT_STYLE_LIGHT)
-    SetGlyphStrength(m_face->glyph, GLYPH_STRENGTH_LIGHT);
+    SetGlyphStrength(face->glyph, GLYPH_STRENGTH_LIGHT);
   // grab the glyph
-  if (FT_Get_Glyph(m_face->glyph, &glyph))
+  if (FT_Get_Glyph(face->glyph, &ftGlyph))
   {
     CLog::Log(LOGDEBUG, "%s Failed to get glyph %x", __FUNCTION__, static_cast<uint32_t>(letter));
     return false;
   }
-  if (m_stroker)
-    FT_Glyph_StrokeBorder(&glyph, m_stroker, 0, 1);
+  if (stroker)
+    FT_Glyph_StrokeBorder(&ftGlyph, stroker, 0, 1);
   // render the glyph
-  if (FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, NULL, 1))
+  if (FT_Glyph_To_Bitmap(&ftGlyph, FT_RENDER_MODE_NORMAL, NULL, 1))
   {
     CLog::Log(LOGDEBUG, "%s Failed to render glyph %x to a bitmap", __FUNCTION__, static_cast<uint32_t>(letter));
+    FT_Done_Glyph(ftGlyph);
     return false;
   }
-  FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)glyph;
-  FT_Bitmap bitmap = bitGlyph->bitmap;
-  bool isEmptyGlyph = (bitmap.width == 0 || bitmap.rows == 0);
+  FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)ftGlyph;
+  const FT_Bitmap& bitmap = bitGlyph->bitmap;
+
+  glyph.left = bitGlyph->left;
+  glyph.top = bitGlyph->top;
+  glyph.width = bitmap.width;
+  glyph.rows = bitmap.rows;
+  glyph.advance = (float)MathUtils::round_int( (float)face->glyph->advance.x / 64 );
+
+  // store the rows tightly packed, whatever the pitch freetype chose
+  glyph.pixels.resize(glyph.width * glyph.rows);
+  const unsigned char* source = bitmap.buffer;
+  if (bitmap.pitch < 0)
+    source -= (glyph.rows - 1) * bitmap.pitch;
+  for (unsigned int y = 0; y < glyph.rows; y++)
+  {
+    memcpy(glyph.pixels.data() + y * glyph.width, source, glyph.width);
+    source += bitmap.pitch;
+  }
 
-  if (!isEmptyGlyph)
+  // free the glyph
+  FT_Done_Glyph(ftGlyph);
+
+  return true;
+}
+
+bool CGUIFontTTFBase::HasPrerenderedGlyph(character_t letterAndStyle)
+{
+  if (!m_prerendered)
+    return false;
+
+  CSingleLock lock(m_prerendered->m_critSection);
+  return m_prerendered->m_glyphs.find(letterAndStyle) != m_prerendered->m_glyphs.end();
+}
+
+bool CGUIFontTTFBase::TakePrerenderedGlyph(character_t letterAndStyle, GlyphBitmap &glyph)
+{
+  if (!m_prerendered)
+    return false;
+
+  CSingleLock lock(m_prerendered->m_critSection);
+  auto it = m_prerendered->m_glyphs.find(letterAndStyle);
+  if (it == m_prerendered->m_glyphs.end())
+    return false;
+
+  glyph = std::move(it->second);
+  m_prerendered->m_glyphs.erase(it);
+  // rasterise it again should its texture line be evicted
+  m_prerendered->m_requested.erase(letterAndStyle);
+  return true;
+}
+
+void CGUIFontTTFBase::PrewarmCharacters(uint32_t style)
+{
+  style &= FONT_STYLE_BOLD | FONT_STYLE_ITALICS | FONT_STYLE_LIGHT;
+  if (!m_face || (m_prewarmedStyles & (1 << style)))
+    return;
+  m_prewarmedStyles |= 1 << style;
+
+  std::vector<character_t> letters;
+  for (const auto& range : PREWARM_RANGES)
   {
-    if (bitGlyph->left < 0)
-      m_posX += -bitGlyph->left;
+    for (wchar_t letter = range[0]; letter <= range[1]; letter++)
+      letters.push_back((style << 16) | letter);
+  }
+  RasteriseGlyphs(letters);
+}
 
-    // check we have enough room for the character.
-    // cast-fest is here to avoid warnings due to freeetype version differences (signedness of width).
-    if (static_cast<int>(m_posX + bitGlyph->left + bitmap.width) > static_cast<int>(m_textureWidth))
-    { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
-      m_posX = 0;
-      m_posY += GetTextureLineHeight();
-      if (bitGlyph->left < 0)
-        m_posX += -bitGlyph->left;
-
-      if(m_posY + GetTextureLineHeight() >= m_textureHeight)
-      {
-        // create the new larger texture
-        unsigned int newHeight = m_posY + GetTextureLineHeight();
-        // check for max height
-        if (newHeight > m_renderSystem->GetMaxTextureSize())
-        {
-          CLog::Log(LOGDEBUG, "%s: New cache texture is too large (%u > %u pixels long)", __FUNCTION__, newHeight, m_renderSystem->GetMaxTextureSize());
-          FT_Done_Glyph(glyph);
-          return false;
-        }
+void CGUIFontTTFBase::RasteriseGlyphs(const std::vector<character_t> &letters)
+{
+  if (!m_face)
+    return;
 
-        CBaseTexture* newTexture = NULL;
-        newTexture = ReallocTexture(newHeight);
-        if(newTexture == NULL)
-        {
-          FT_Done_Glyph(glyph);
-          CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
-          return false;
-        }
-        m_texture = newTexture;
+  if (!m_prerendered)
+    m_prerendered = std::make_shared<CPrerenderedGlyphs>(m_strFilename, m_height, m_aspect, m_border);
+
+  CSingleLock lock(m_prerendered->m_critSection);
+  for (character_t letterAndStyle : letters)
+  {
+    if (m_prerendered->m_glyphs.find(letterAndStyle) == m_prerendered->m_glyphs.end() &&
+        m_prerendered->m_requested.insert(letterAndStyle).second)
+      m_prerendered->m_queue.push_back(letterAndStyle);
+  }
+
+  // a running worker picks up the new glyphs
+  if (m_prerendered->m_running || m_prerendered->m_queue.empty())
+    return;
+  m_prerendered->m_running = true;
+  lock.Leave();
+
+  std::shared_ptr<CPrerenderedGlyphs> prerendered = m_prerendered;
+  CJobManager::GetInstance().Submit([prerendered]()
+  {
+    RasteriseQueuedGlyphs(prerendered);
+  });
+}
+
+void CGUIFontTTFBase::RasteriseQueuedGlyphs(const std::shared_ptr<CPrerenderedGlyphs> &prerendered)
+{
+  FT_Library library = NULL;
+  FT_Face face = NULL;
+  FT_Stroker stroker = NULL;
+  XUTILS::auto_buffer memoryBuf;
+  if (FT_Init_FreeType(&library) == 0)
+  {
+    face = CFreeTypeLibrary::LoadFace(library, prerendered->m_fileName, prerendered->m_height, prerendered->m_aspect, memoryBuf);
+    if (face && prerendered->m_border && FT_Stroker_New(library, &stroker) == 0)
+      FT_Stroker_Set(stroker, GetBorderStrength(face), FT_STROKER_LINECAP_ROUND, FT_STROKER_LINEJOIN_ROUND, 0);
+  }
+
+  unsigned int count = 0;
+  bool placeholdersReady = false;
+  CSingleLock lock(prerendered->m_critSection);
+  while (face && !prerendered->m_cancelled && !prerendered->m_queue.empty())
+  {
+    character_t letterAndStyle = prerendered->m_queue.front();
+    prerendered->m_queue.pop_front();
+    lock.Leave();
+
+    // a glyph that fails stays requested, its placeholder is kept
+    GlyphBitmap glyph;
+    bool rendered = RenderGlyph(face, stroker, (wchar_t)(letterAndStyle & 0xffff), letterAndStyle >> 16, glyph);
+
+    lock.Enter();
+    if (rendered && !prerendered->m_cancelled)
+    {
+      prerendered->m_glyphs.emplace(letterAndStyle, std::move(glyph));
+      placeholdersReady |= (letterAndStyle & 0xffff) > 0xff;
+      count++;
+    }
+  }
+  // glyphs queued without a face are dropped, they are requested again with the next font load
+  prerendered->m_queue.clear();
+  prerendered->m_running = false;
+  lock.Leave();
+
+  if (stroker)
+    FT_Stroker_Done(stroker);
+  if (face)
+    FT_Done_Face(face);
+  if (library)
+    FT_Done_FreeType(library);
+
+  CLog::Log(LOGDEBUG, "CGUIFontTTFBase::RasteriseQueuedGlyphs: prepared %u glyphs of %s", count, prerendered->m_fileName.c_str());
+
+  if (placeholdersReady)
+  {
+    prerendered->m_placeholdersReady = true;
+    CGUIComponent *gui = CServiceBroker::GetGUI();
+    if (gui)
+    {
+      CGUIMessage msg(GUI_MSG_NOTIFY_ALL, 0, 0, GUI_MSG_FONT_GLYPHS_READY);
+      gui->GetWindowManager().SendThreadMessage(msg);
+    }
+  }
+}
+
+bool CGUIFontTTFBase::DeferCharacter(wchar_t letter, uint32_t style, Character *ch)
+{
+  character_t letterAndStyle = (style << 16) | letter;
+
+  // it is ready already, so it can be copied to the texture right away
+  if (!m_face || HasPrerenderedGlyph(letterAndStyle))
+    return false;
+
+  RasteriseGlyphs({ letterAndStyle });
+
+  ch->letterAndStyle = letterAndStyle;
+  ch->offsetX = 0;
+  ch->offsetY = 0;
+  ch->left = ch->top = ch->right = ch->bottom = 0;
+  ch->advance = GetPlaceholderAdvance(m_face, letter, style);
+  ch->textureLine = NO_TEXTURE_LINE;
+  ch->placeholder = true;
+  return true;
+}
+
+bool CGUIFontTTFBase::NextTextureLine()
+{
+  const unsigned int lineHeight = GetTextureLineHeight();
+  m_posX = 0;
+
+  // the first line is at zero, m_posY starts one line above it
+  unsigned int line = static_cast<unsigned int>(m_posY + static_cast<int>(lineHeight)) / lineHeight;
+  unsigned int newHeight = (line + 1) * lineHeight;
+
+  if (line >= m_textureLines.size() && newHeight <= m_renderSystem->GetMaxTextureSize())
+  {
+    m_posY = line * lineHeight;
+    if (newHeight >= m_textureHeight)
+    {
+      // create the new larger texture
+      CBaseTexture* newTexture = ReallocTexture(newHeight);
+      if (newTexture == NULL)
+      {
+        CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
+        return false;
       }
+      m_texture = newTexture;
+    }
+    m_textureLines.resize(line + 1);
+    return true;
+  }
+
+  // texture is as large as it may get - reuse the least recently used line, but never one
+  // that is used by the current frame as its vertices still refer to it
+  const unsigned int now = CTimeUtils::GetFrameTime();
+  unsigned int oldest = 0;
+  bool found = false;
+  for (unsigned int i = 0; i < m_textureLines.size(); i++)
+  {
+    if (m_textureLines[i].lastUsed != now &&
+        (!found || m_textureLines[i].lastUsed < m_textureLines[oldest].lastUsed))
+    {
+      oldest = i;
+      found = true;
+    }
+  }
+  if (!found)
+  {
+    CLog::Log(LOGDEBUG, "%s: Cache texture is full (%u pixels long) and all lines are in use", __FUNCTION__, m_textureHeight);
+    return false;
+  }
+
+  EvictTextureLine(oldest);
+  m_posY = oldest * lineHeight;
+  return true;
+}
+
+void CGUIFontTTFBase::EvictTextureLine(unsigned int line)
+{
+  TextureLine& textureLine = m_textureLines[line];
+  for (character_t letterAndStyle : textureLine.chars)
+  {
+    wchar_t letter = (wchar_t)(letterAndStyle & 0xffff);
+    if (letter < 255)
+      m_charquick[((letterAndStyle & 0xffff0000) >> 8) | letter] = NULL;
+    m_chars.erase(letterAndStyle);
+  }
+  textureLine.chars.clear();
+  textureLine.lastUsed = 0;
+
+  // blank the line so that filtering doesn't pick up remains of the old glyphs
+  const unsigned int y1 = line * GetTextureLineHeight();
+  const unsigned int y2 = std::min(y1 + GetTextureLineHeight(), m_textureHeight);
+  if (m_texture && y2 > y1)
+  {
+    std::vector<unsigned char> blank(m_textureWidth * (y2 - y1), 0);
+    FT_BitmapGlyphRec blankGlyph = {};
+    blankGlyph.bitmap.width = m_textureWidth;
+    blankGlyph.bitmap.rows = y2 - y1;
+    blankGlyph.bitmap.pitch = m_textureWidth;
+    blankGlyph.bitmap.buffer = blank.data();
+    CopyCharToTexture(&blankGlyph, 0, y1, m_textureWidth, y2);
+  }
+
+  // cached vertices may refer to the glyphs that were just dropped
+  m_staticCache.Flush();
+  m_dynamicCache.Flush();
+}
+
+bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
+{
+  GlyphBitmap glyph;
+  if (!TakePrerenderedGlyph((style << 16) | letter, glyph) &&
+      !RenderGlyph(m_face, m_stroker, letter, style, glyph))
+    return false;
+
+  bool isEmptyGlyph = (glyph.width == 0 || glyph.rows == 0);
+
+  if (!isEmptyGlyph)
+  {
+    if (glyph.left < 0)
+      m_posX += -glyph.left;
+
+    // check we have enough room for the character.
+    if (m_posX + glyph.left + static_cast<int>(glyph.width) > static_cast<int>(m_textureWidth))
+    { // no space - gotta drop to the next line (which means growing the texture or reusing an old line)
+      if (!NextTextureLine())
+        return false;
+      if (glyph.left < 0)
+        m_posX += -glyph.left;
     }
 
     if(m_texture == NULL)
     {
-      FT_Done_Glyph(glyph);
       CLog::Log(LOGDEBUG, "%s: no texture to cache character to", __FUNCTION__);
       return false;
     }
   }
   // set the character in our table
   ch->letterAndStyle = (style << 16) | letter;
-  ch->offsetX = (short)bitGlyph->left;
-  ch->offsetY = (short)m_cellBaseLine - bitGlyph->top;
+  ch->offsetX = (short)glyph.left;
+  ch->offsetY = (short)m_cellBaseLine - glyph.top;
   ch->left = isEmptyGlyph ? 0 : ((float)m_posX + ch->offsetX);
   ch->top = isEmptyGlyph ? 0 : ((float)m_posY + ch->offsetY);
-  ch->right = ch->left + bitmap.width;
-  ch->bottom = ch->top + bitmap.rows;
-  ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+  ch->right = ch->left + glyph.width;
+  ch->bottom = ch->top + glyph.rows;
+  ch->advance = glyph.advance;
+  ch->textureLine = NO_TEXTURE_LINE;
+  ch->placeholder = false;
 
   // we need only render if we actually have some pixels
   if (!isEmptyGlyph)
@@ -796,16 +1116,23 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
     // ensure our rect will stay inside the texture (it *should* but we need to be certain)
     unsigned int x1 = std::max(m_posX + ch->offsetX, 0);
     unsigned int y1 = std::max(m_posY + ch->offsetY, 0);
-    unsigned int x2 = std::min(x1 + bitmap.width, m_textureWidth);
-    unsigned int y2 = std::min(y1 + bitmap.rows, m_textureHeight);
-    CopyCharToTexture(bitGlyph, x1, y1, x2, y2);
-  
+    unsigned int x2 = std::min(x1 + glyph.width, m_textureWidth);
+    unsigned int y2 = std::min(y1 + glyph.rows, m_textureHeight);
+
+    FT_BitmapGlyphRec bitGlyph = {};
+    bitGlyph.left = glyph.left;
+    bitGlyph.top = glyph.top;
+    bitGlyph.bitmap.width = glyph.width;
+    bitGlyph.bitmap.rows = glyph.rows;
+    bitGlyph.bitmap.pitch = glyph.width;
+    bitGlyph.bitmap.buffer = glyph.pixels.data();
+    CopyCharToTexture(&bitGlyph, x1, y1, x2, y2);
+
     m_posX += spacing_between_characters_in_texture + (unsigned short)std::max(ch->right - ch->left + ch->offsetX, ch->advance);
-  }
-  m_numChars++;
 
-  // free the glyph
-  FT_Done_Glyph(glyph);
+    ch->textureLine = static_cast<unsigned short>(m_posY / GetTextureLineHeight());
+    m_textureLines[ch->textureLine].lastUsed = CTimeUtils::GetFrameTime();
+  }
 
   return true;
 }
@@ -981,8 +1308,8 @@ void CGUIFontTTFBase::SetGlyphStrength(FT_GlyphSlot slot, int glyphStrength)
     return;
 
   /* some reasonable strength */
-  FT_Pos strength = FT_MulFix( m_face->units_per_EM,
-                    m_face->size->metrics.y_scale ) / glyphStrength;
+  FT_Pos strength = FT_MulFix( slot->face->units_per_EM,
+                    slot->face->size->metrics.y_scale ) / glyphStrength;
 
   FT_BBox bbox_before, bbox_after;
   FT_Outline_Get_CBox( &slot->outline, &bbox_before );
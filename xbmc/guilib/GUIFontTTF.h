@@ -20,8 +20,10 @@
  *
  */
 
+#include <memory>
 #include <string>
 #include <stdint.h>
+#include <unordered_map>
 #include <vector>
 
 #include "utils/auto_buffer.h"
@@ -97,6 +99,15 @@ public:
 
   const std::string& GetFileName() const { return m_strFileName; };
 
+  /*! \brief Rasterise the commonly used characters of the given style on a worker thread.
+   The first frame that shows them then only has to copy the bitmaps into the glyph texture
+   instead of running freetype on the render thread. Calling it again for the same style is a no-op.
+   Characters beyond these are rasterised on a worker thread when they are first needed and
+   drawn blank until they are ready.
+   \param style the FONT_STYLE_BOLD, FONT_STYLE_ITALICS and FONT_STYLE_LIGHT bits to prepare
+   */
+  void PrewarmCharacters(uint32_t style);
+
 protected:
   struct Character
   {
@@ -104,7 +115,33 @@ protected:
     float left, top, right, bottom;
     float advance;
     character_t letterAndStyle;
+    unsigned short textureLine;
+    bool placeholder;             // blank stand-in until the glyph has been rasterised
   };
+
+  /*! \brief A rendered glyph, independent of the freetype objects used to create it
+   */
+  struct GlyphBitmap
+  {
+    int left = 0;
+    int top = 0;
+    unsigned int width = 0;
+    unsigned int rows = 0;
+    float advance = 0.0f;
+    std::vector<unsigned char> pixels;
+  };
+
+  /*! \brief Usage of a single line of the glyph texture, used to evict the least recently used line
+   once the texture has reached its maximum size.
+   */
+  struct TextureLine
+  {
+    unsigned int lastUsed = 0;
+    std::vector<character_t> chars;
+  };
+
+  class CPrerenderedGlyphs;
+
   void AddReference();
   void RemoveReference();
 
@@ -124,6 +161,14 @@ protected:
   // Stuff for pre-rendering for speed
   inline Character *GetCharacter(character_t letter);
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
+  bool DeferCharacter(wchar_t letter, uint32_t style, Character *ch);
+  static bool RenderGlyph(FT_Face face, FT_Stroker stroker, wchar_t letter, uint32_t style, GlyphBitmap &glyph);
+  void RasteriseGlyphs(const std::vector<character_t> &letters);
+  static void RasteriseQueuedGlyphs(const std::shared_ptr<CPrerenderedGlyphs> &prerendered);
+  bool HasPrerenderedGlyph(character_t letterAndStyle);
+  bool TakePrerenderedGlyph(character_t letterAndStyle, GlyphBitmap &glyph);
+  bool NextTextureLine();
+  void EvictTextureLine(unsigned int line);
   void RenderCharacter(float posX, float posY, const Character *ch, UTILS::Color color, bool roundX, std::vector<SVertex> &vertices);
   void ClearCharacterCache();
 
@@ -132,7 +177,7 @@ protected:
   virtual void DeleteHardwareTexture() = 0;
 
   // modifying glyphs
-  void SetGlyphStrength(FT_GlyphSlot slot, int glyphStrength);
+  static void SetGlyphStrength(FT_GlyphSlot slot, int glyphStrength);
   static void ObliqueGlyph(FT_GlyphSlot slot);
 
   CBaseTexture* m_texture;        // texture that holds our rendered characters (8bit alpha only)
@@ -150,13 +195,18 @@ protected:
 
   UTILS::Color m_color;
 
-  Character *m_char;                 // our characters
+  std::unordered_map<character_t, Character> m_chars; // our characters, keyed by style and letter
   Character *m_charquick[LOOKUPTABLE_SIZE];     // ascii chars (7 styles) here
-  int m_maxChars;                    // size of character array (can be incremented)
-  int m_numChars;                    // the current number of cached characters
+  std::vector<TextureLine> m_textureLines;       // usage of each line of the texture
+  static const unsigned short NO_TEXTURE_LINE = 0xffff; // textureLine of glyphs without pixels
 
   float m_ellipsesWidth;               // this is used every character (width of '.')
 
+  float m_aspect;
+  bool m_border;
+  std::shared_ptr<CPrerenderedGlyphs> m_prerendered; // glyphs rasterised on worker threads
+  uint32_t m_prewarmedStyles;                         // bit n set once style n has been requested
+
   unsigned int m_cellBaseLine;
   unsigned int m_cellHeight;
 
@@ -171,6 +171,11 @@
  */
 #define GUI_MSG_STATE_CHANGED  51
 
+ /*!
+ \brief Glyphs that were drawn as placeholders have been rasterised, the screen has to be redrawn
+ */
+#define GUI_MSG_FONT_GLYPHS_READY 52
+
 
 #define GUI_MSG_USER         1000
 
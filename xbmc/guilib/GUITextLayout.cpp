@@ -22,8 +22,135 @@
 #include "GUIFont.h"
 #include "GUIControl.h"
 #include "GUIColorManager.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/CharsetConverter.h"
 #include "utils/StringUtils.h"
+#include "windowing/GraphicContext.h"
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace
+{
+
+/*! \brief Layouts shared by all CGUITextLayout instances.
+ List containers create a layout per item, so the same strings get parsed and
+ wrapped over and over again while scrolling. This caches the result of
+ UpdateCommon() keyed on everything that influences it.
+ */
+class CGUITextLayoutCache
+{
+public:
+  struct Key
+  {
+    std::wstring text;
+    const CGUIFont *font;
+    float maxWidth;
+    float maxHeight;
+    float scaleX;  ///< GUI scale, the font measures text in scaled pixels
+    float scaleY;
+    UTILS::Color textColor;
+    bool wrap;
+    bool forceLTRReadingOrder;
+
+    bool operator==(const Key &right) const
+    {
+      return font == right.font && maxWidth == right.maxWidth && maxHeight == right.maxHeight &&
+             scaleX == right.scaleX && scaleY == right.scaleY && textColor == right.textColor && wrap == right.wrap &&
+             forceLTRReadingOrder == right.forceLTRReadingOrder && text == right.text;
+    }
+  };
+
+  struct KeyHash
+  {
+    size_t operator()(const Key &key) const
+    {
+      size_t hash = std::hash<std::wstring>()(key.text);
+      hash ^= std::hash<const void*>()(key.font) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+      hash ^= std::hash<float>()(key.maxWidth) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+      hash ^= std::hash<float>()(key.scaleX) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+      hash ^= std::hash<float>()(key.scaleY) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+      return hash;
+    }
+  };
+
+  struct Layout
+  {
+    std::vector<CGUIString> lines;
+    std::vector<UTILS::Color> colors;
+    float textWidth;
+    float textHeight;
+  };
+
+  static CGUITextLayoutCache& GetInstance()
+  {
+    // never destroyed, as the font manager clears it from its destructor
+    static CGUITextLayoutCache* cache = new CGUITextLayoutCache;
+    return *cache;
+  }
+
+  std::shared_ptr<const Layout> Lookup(const Key &key)
+  {
+    CSingleLock lock(m_critSection);
+    auto it = m_layouts.find(key);
+    if (it == m_layouts.end())
+    {
+      m_misses++;
+      return std::shared_ptr<const Layout>();
+    }
+    m_hits++;
+    // move to the front of the recently used list
+    m_lru.splice(m_lru.begin(), m_lru, it->second.second);
+    return it->second.first;
+  }
+
+  void Insert(const Key &key, std::shared_ptr<const Layout> layout)
+  {
+    CSingleLock lock(m_critSection);
+    auto it = m_layouts.find(key);
+    if (it != m_layouts.end())
+    {
+      it->second.first = layout;
+      return;
+    }
+    while (m_layouts.size() >= MAX_LAYOUTS)
+    {
+      m_layouts.erase(*m_lru.back());
+      m_lru.pop_back();
+    }
+    it = m_layouts.emplace(key, std::make_pair(layout, m_lru.end())).first;
+    m_lru.push_front(&it->first);
+    it->second.second = m_lru.begin();
+  }
+
+  void Clear()
+  {
+    CSingleLock lock(m_critSection);
+    m_layouts.clear();
+    m_lru.clear();
+  }
+
+  void GetStats(uint64_t &hits, uint64_t &misses)
+  {
+    CSingleLock lock(m_critSection);
+    hits = m_hits;
+    misses = m_misses;
+  }
+
+private:
+  static const size_t MAX_LAYOUTS = 2048;
+
+  typedef std::list<const Key*> LRUList;
+  CCriticalSection m_critSection;
+  std::unordered_map<Key, std::pair<std::shared_ptr<const Layout>, LRUList::iterator>, KeyHash> m_layouts;
+  LRUList m_lru; // most recently used first, points at the keys of m_layouts
+  uint64_t m_hits = 0;
+  uint64_t m_misses = 0;
+};
+
+}
 
 CGUIString::CGUIString(iString start, iString end, bool carriageReturn)
 {
@@ -238,13 +365,62 @@ bool CGUITextLayout::UpdateW(const std::wstring &text, float maxWidth /*= 0*/, b
 
 void CGUITextLayout::UpdateCommon(const std::wstring &text, float maxWidth, bool forceLTRReadingOrder)
 {
+  if (!m_font)
+  {
+    vecText parsedText;
+    std::vector<UTILS::Color> colors;
+    ParseText(text, 0, m_textColor, colors, parsedText);
+    UpdateStyled(parsedText, colors, maxWidth, forceLTRReadingOrder);
+    return;
+  }
+
+  CGUITextLayoutCache::Key key;
+  key.text = text;
+  key.font = m_font;
+  key.maxWidth = m_wrap ? maxWidth : 0; // only affects wrapped text
+  key.maxHeight = m_maxHeight;
+  const CGraphicContext &context = CServiceBroker::GetWinSystem()->GetGfxContext();
+  key.scaleX = context.GetGUIScaleX();
+  key.scaleY = context.GetGUIScaleY();
+  key.textColor = m_textColor;
+  key.wrap = m_wrap;
+  key.forceLTRReadingOrder = forceLTRReadingOrder;
+
+  CGUITextLayoutCache& cache = CGUITextLayoutCache::GetInstance();
+  std::shared_ptr<const CGUITextLayoutCache::Layout> layout = cache.Lookup(key);
+  if (layout)
+  {
+    m_lines = layout->lines;
+    m_colors = layout->colors;
+    m_textWidth = layout->textWidth;
+    m_textHeight = layout->textHeight;
+    return;
+  }
+
   // parse the text for style information
   vecText parsedText;
   std::vector<UTILS::Color> colors;
-  ParseText(text, m_font ? m_font->GetStyle() : 0, m_textColor, colors, parsedText);
+  ParseText(text, m_font->GetStyle(), m_textColor, colors, parsedText);
 
   // and update
   UpdateStyled(parsedText, colors, maxWidth, forceLTRReadingOrder);
+
+  std::shared_ptr<CGUITextLayoutCache::Layout> newLayout = std::make_shared<CGUITextLayoutCache::Layout>();
+  newLayout->lines = m_lines;
+  newLayout->colors = m_colors;
+  newLayout->textWidth = m_textWidth;
+  newLayout->textHeight = m_textHeight;
+  cache.Insert(key, newLayout);
+}
+
+void CGUITextLayout::ClearLayoutCache()
+{
+  CGUITextLayoutCache::GetInstance().Clear();
+}
+
+void CGUITextLayout::GetLayoutCacheStats(uint64_t &hits, uint64_t &misses)
+{
+  CGUITextLayoutCache::GetInstance().GetStats(hits, misses);
 }
 
 void CGUITextLayout::UpdateStyled(const vecText &text, const std::vector<UTILS::Color> &colors, float maxWidth, bool forceLTRReadingOrder)
@@ -111,6 +111,18 @@ public:
   static void DrawText(CGUIFont *font, float x, float y, UTILS::Color color, UTILS::Color shadowColor, const std::string &text, uint32_t align);
   static void Filter(std::string &text);
 
+  /*! \brief Drop all layouts from the cache shared by all text layouts.
+   Must be called whenever fonts or colors are (re)loaded, as cached layouts refer to
+   font objects and resolved colors.
+   */
+  static void ClearLayoutCache();
+
+  /*! \brief Returns the number of lookups in the shared layout cache since startup
+   \param hits [out] number of updates served from the cache
+   \param misses [out] number of updates that had to parse and wrap the text
+   */
+  static void GetLayoutCacheStats(uint64_t &hits, uint64_t &misses);
+
 protected:
   void LineBreakText(const vecText &text, std::vector<CGUIString> &lines);
   void WrapText(const vecText &text, float maxWidth);
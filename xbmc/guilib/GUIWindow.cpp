@@ -21,6 +21,7 @@
 #include "GUIWindow.h"
 #include "GUIComponent.h"
 #include "GUIWindowManager.h"
+#include "GUIWindowCache.h"
 #include "input/Key.h"
 #include "GUIControlFactory.h"
 #include "GUIControlGroup.h"
@@ -136,33 +137,75 @@ bool CGUIWindow::Load(const std::string& strFileName, bool bContainsPath)
 
 bool CGUIWindow::LoadXML(const std::string &strPath, const std::string &strLowerPath)
 {
-  // load window xml if we don't have it stored yet
-  if (!m_windowXMLRootElement)
+  CGUIWindowCache& windowCache = CServiceBroker::GetGUI()->GetWindowManager().GetWindowCache();
+  bool cacheable = windowCache.IsCacheable(strPath);
+
+  // conditions of a previous load don't apply to the tree we load now
+  m_xmlIncludeConditions.clear();
+
+  // skip parsing and resolving if the window was loaded before with the same include conditions
+  std::unique_ptr<TiXmlElement> preparedRoot;
+  if (cacheable)
+    preparedRoot = windowCache.GetResolvedXML(strPath, m_xmlIncludeConditions);
+
+  if (!preparedRoot)
   {
-    CXBMCTinyXML xmlDoc;
-    std::string strPathLower = strPath;
-    StringUtils::ToLower(strPathLower);
-    if (!xmlDoc.LoadFile(strPath) && !xmlDoc.LoadFile(strPathLower) && !xmlDoc.LoadFile(strLowerPath))
+    // load window xml if we don't have it stored yet
+    if (!m_windowXMLRootElement)
     {
-      CLog::Log(LOGERROR, "Unable to load window XML: %s. Line %d\n%s", strPath.c_str(), xmlDoc.ErrorRow(), xmlDoc.ErrorDesc());
-      SetID(WINDOW_INVALID);
-      return false;
-    }
+      std::string strPathLower = strPath;
+      StringUtils::ToLower(strPathLower);
+      std::unique_ptr<TiXmlElement> root;
+      if (cacheable)
+      {
+        int errorRow = 0;
+        std::string errorDesc;
+        root = windowCache.GetWindowXML(strPath, errorRow, errorDesc);
+        if (!root)
+          root = windowCache.GetWindowXML(strPathLower, errorRow, errorDesc);
+        if (!root && !strLowerPath.empty())
+          root = windowCache.GetWindowXML(strLowerPath, errorRow, errorDesc);
+        if (!root)
+        {
+          CLog::Log(LOGERROR, "Unable to load window XML: %s. Line %d\n%s", strPath.c_str(), errorRow, errorDesc.c_str());
+          SetID(WINDOW_INVALID);
+          return false;
+        }
+      }
+      else
+      {
+        CXBMCTinyXML xmlDoc;
+        if (!xmlDoc.LoadFile(strPath) && !xmlDoc.LoadFile(strPathLower) && !xmlDoc.LoadFile(strLowerPath))
+        {
+          CLog::Log(LOGERROR, "Unable to load window XML: %s. Line %d\n%s", strPath.c_str(), xmlDoc.ErrorRow(), xmlDoc.ErrorDesc());
+          SetID(WINDOW_INVALID);
+          return false;
+        }
+        root.reset(static_cast<TiXmlElement*>(xmlDoc.RootElement()->Clone()));
+      }
 
-    // xml need a <window> root element
-    if (!StringUtils::EqualsNoCase(xmlDoc.RootElement()->Value(), "window"))
-    {
-      CLog::Log(LOGERROR, "XML file %s does not contain a <window> root element", GetProperty("xmlfile").c_str());
-      return false;
+      // xml need a <window> root element
+      if (!StringUtils::EqualsNoCase(root->Value(), "window"))
+      {
+        CLog::Log(LOGERROR, "XML file %s does not contain a <window> root element", GetProperty("xmlfile").c_str());
+        return false;
+      }
+
+      // store XML for further processing if window's load type is LOAD_EVERY_TIME or a reload is needed
+      m_windowXMLRootElement = root.release();
     }
+    else
+      CLog::Log(LOGDEBUG, "Using already stored xml root node for %s", strPath.c_str());
 
-    // store XML for further processing if window's load type is LOAD_EVERY_TIME or a reload is needed
-    m_windowXMLRootElement = static_cast<TiXmlElement*>(xmlDoc.RootElement()->Clone());
+    preparedRoot = Prepare(m_windowXMLRootElement);
+    if (preparedRoot && cacheable)
+      windowCache.SetResolvedXML(strPath, *preparedRoot, m_xmlIncludeConditions);
   }
-  else
-    CLog::Log(LOGDEBUG, "Using already stored xml root node for %s", strPath.c_str());
 
-  return Load(Prepare(m_windowXMLRootElement).get());
+  if (cacheable)
+    windowCache.PreloadReachable(strPath);
+
+  return Load(preparedRoot.get());
 }
 
 std::unique_ptr<TiXmlElement> CGUIWindow::Prepare(TiXmlElement *pRootElement)
@@ -0,0 +1,304 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIWindowCache.h"
+
+#include <algorithm>
+#include <string.h>
+
+#include "GUIComponent.h"
+#include "GUIWindowManager.h"
+#include "ServiceBroker.h"
+#include "addons/Skin.h"
+#include "GUIInfoManager.h"
+#include "input/WindowTranslator.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/Variant.h"
+#include "utils/XBMCTinyXML.h"
+#include "utils/XMLBinaryCache.h"
+
+namespace
+{
+const char* WINDOW_ACTIONS[] = { "activatewindow(", "activatewindowandfocus(", "replacewindow(", "replacewindowandfocus(" };
+
+template<typename Entry>
+void EvictLeastRecentlyUsed(std::map<std::string, Entry>& entries, size_t maxEntries)
+{
+  while (entries.size() > maxEntries)
+  {
+    auto oldest = entries.begin();
+    for (auto it = entries.begin(); it != entries.end(); ++it)
+    {
+      if (it->second.lastUsed < oldest->second.lastUsed)
+        oldest = it;
+    }
+    entries.erase(oldest);
+  }
+}
+
+void GetWindowNames(const TiXmlElement& element, std::vector<std::string>& names)
+{
+  for (const TiXmlElement* child = element.FirstChildElement(); child; child = child->NextSiblingElement())
+  {
+    if (StringUtils::StartsWith(child->ValueStr(), "on") && child->FirstChild())
+    {
+      std::string actions = child->FirstChild()->ValueStr();
+      StringUtils::ToLower(actions);
+      for (const char* action : WINDOW_ACTIONS)
+      {
+        size_t pos = actions.find(action);
+        while (pos != std::string::npos)
+        {
+          pos += strlen(action);
+          size_t end = actions.find_first_of(",)", pos);
+          if (end == std::string::npos)
+            break;
+          std::string name = actions.substr(pos, end - pos);
+          StringUtils::Trim(name);
+          if (!name.empty())
+            names.push_back(name);
+          pos = actions.find(action, end);
+        }
+      }
+    }
+    GetWindowNames(*child, names);
+  }
+}
+}
+
+CGUIWindowCache::CGUIWindowCache()
+  : m_preloadOwner(std::make_shared<PreloadOwner>())
+{
+  m_preloadOwner->cache = this;
+}
+
+CGUIWindowCache::~CGUIWindowCache()
+{
+  {
+    CSingleLock lock(m_critSection);
+    m_preloadQueue.clear();
+  }
+  // a running preload job finishes its current file, one that did not start
+  // yet (or never will) finds the cache detached
+  CSingleLock lock(m_preloadOwner->critSection);
+  m_preloadOwner->cache = nullptr;
+}
+
+bool CGUIWindowCache::IsCacheable(const std::string& path) const
+{
+  return g_SkinInfo && URIUtils::PathHasParent(path, g_SkinInfo->Path());
+}
+
+std::unique_ptr<TiXmlElement> CGUIWindowCache::GetWindowXML(const std::string& path, int& errorRow, std::string& errorDesc)
+{
+  std::shared_ptr<const TiXmlElement> root;
+  {
+    CSingleLock lock(m_critSection);
+    auto it = m_parsed.find(path);
+    if (it != m_parsed.end())
+    {
+      it->second.lastUsed = ++m_useCounter;
+      root = it->second.root;
+    }
+  }
+
+  if (!root)
+  {
+    root = LoadWindowXML(path, errorRow, errorDesc);
+    if (!root)
+      return nullptr;
+    StoreWindowXML(path, root);
+  }
+  else
+    CLog::Log(LOGDEBUG, "CGUIWindowCache: using cached xml of %s", path.c_str());
+
+  // stored trees are never modified, so cloning them without holding the lock is fine
+  return std::unique_ptr<TiXmlElement>(static_cast<TiXmlElement*>(root->Clone()));
+}
+
+std::unique_ptr<TiXmlElement> CGUIWindowCache::GetResolvedXML(const std::string& path, std::map<INFO::InfoPtr, bool>& xmlIncludeConditions)
+{
+  std::shared_ptr<const TiXmlElement> root;
+  std::map<INFO::InfoPtr, bool> conditions;
+  {
+    CSingleLock lock(m_critSection);
+    auto it = m_resolved.find(path);
+    if (it == m_resolved.end())
+      return nullptr;
+    it->second.lastUsed = ++m_useCounter;
+    root = it->second.root;
+    conditions = it->second.conditions;
+  }
+
+  // evaluate the conditions without holding our lock, info bools may call into anything
+  if (CGUIInfoManager::ConditionsChangedValues(conditions))
+  {
+    CLog::Log(LOGDEBUG, "CGUIWindowCache: include conditions of %s changed", path.c_str());
+    return nullptr;
+  }
+
+  CLog::Log(LOGDEBUG, "CGUIWindowCache: using resolved xml of %s", path.c_str());
+  xmlIncludeConditions.insert(conditions.begin(), conditions.end());
+  return std::unique_ptr<TiXmlElement>(static_cast<TiXmlElement*>(root->Clone()));
+}
+
+void CGUIWindowCache::SetResolvedXML(const std::string& path, const TiXmlElement& root, const std::map<INFO::InfoPtr, bool>& xmlIncludeConditions)
+{
+  ResolvedWindow window;
+  window.root.reset(static_cast<TiXmlElement*>(root.Clone()));
+  window.conditions = xmlIncludeConditions;
+  window.reachable = GetReachableWindows(root);
+  window.reachable.erase(std::remove(window.reachable.begin(), window.reachable.end(), path), window.reachable.end());
+
+  CSingleLock lock(m_critSection);
+  window.lastUsed = ++m_useCounter;
+  m_resolved[path] = std::move(window);
+  EvictLeastRecentlyUsed(m_resolved, WINDOW_CACHE_RESOLVED_WINDOWS);
+}
+
+void CGUIWindowCache::PreloadReachable(const std::string& path)
+{
+  CSingleLock lock(m_critSection);
+  auto window = m_resolved.find(path);
+  if (window == m_resolved.end())
+    return;
+
+  for (const auto& reachable : window->second.reachable)
+  {
+    if (m_parsed.find(reachable) == m_parsed.end() && m_resolved.find(reachable) == m_resolved.end() &&
+        std::find(m_preloadQueue.begin(), m_preloadQueue.end(), reachable) == m_preloadQueue.end())
+      m_preloadQueue.push_back(reachable);
+  }
+
+  if (m_preloadQueue.empty() || m_preloading)
+    return;
+
+  std::shared_ptr<PreloadOwner> owner = m_preloadOwner;
+  auto preload = [owner]()
+  {
+    CSingleLock lock(owner->critSection);
+    if (owner->cache)
+      owner->cache->Preload();
+  };
+  CJob* job = new CLambdaJob<decltype(preload)>(std::move(preload));
+  m_preloading = CJobManager::GetInstance().AddJob(job, nullptr, CJob::PRIORITY_LOW_PAUSABLE) != 0;
+  if (!m_preloading)
+    delete job;
+}
+
+void CGUIWindowCache::Clear()
+{
+  CSingleLock lock(m_critSection);
+  m_parsed.clear();
+  m_resolved.clear();
+  m_preloadQueue.clear();
+  // files that are being preloaded right now belong to the old skin
+  m_generation++;
+}
+
+std::shared_ptr<const TiXmlElement> CGUIWindowCache::LoadWindowXML(const std::string& path, int& errorRow, std::string& errorDesc)
+{
+  CXBMCTinyXML xmlDoc;
+  if (!CXMLBinaryCache::LoadFile(path, xmlDoc) || !xmlDoc.RootElement())
+  {
+    errorRow = xmlDoc.ErrorRow();
+    errorDesc = xmlDoc.ErrorDesc();
+    return nullptr;
+  }
+
+  return std::shared_ptr<const TiXmlElement>(static_cast<TiXmlElement*>(xmlDoc.RootElement()->Clone()));
+}
+
+std::vector<std::string> CGUIWindowCache::GetReachableWindows(const TiXmlElement& root)
+{
+  std::vector<std::string> names;
+  GetWindowNames(root, names);
+
+  std::vector<std::string> paths;
+  for (const auto& name : names)
+  {
+    int id = CWindowTranslator::TranslateWindow(name);
+    if (id == WINDOW_INVALID)
+      continue;
+
+    CGUIWindow* window = CServiceBroker::GetGUI()->GetWindowManager().GetWindow(id);
+    if (!window)
+      continue;
+
+    std::string xmlFile = window->GetProperty("xmlfile").asString();
+    if (xmlFile.empty())
+      continue;
+
+    RESOLUTION_INFO res;
+    std::string path = g_SkinInfo->GetSkinPath(xmlFile, &res);
+    if (std::find(paths.begin(), paths.end(), path) == paths.end())
+      paths.push_back(path);
+  }
+  return paths;
+}
+
+void CGUIWindowCache::StoreWindowXML(const std::string& path, const std::shared_ptr<const TiXmlElement>& root)
+{
+  CSingleLock lock(m_critSection);
+  ParsedWindow& window = m_parsed[path];
+  window.root = root;
+  window.lastUsed = ++m_useCounter;
+  EvictLeastRecentlyUsed(m_parsed, WINDOW_CACHE_PARSED_WINDOWS);
+}
+
+void CGUIWindowCache::Preload()
+{
+  while (true)
+  {
+    std::string path;
+    unsigned int generation;
+    {
+      CSingleLock lock(m_critSection);
+      if (m_preloadQueue.empty())
+      {
+        m_preloading = false;
+        return;
+      }
+      path = m_preloadQueue.front();
+      m_preloadQueue.erase(m_preloadQueue.begin());
+      generation = m_generation;
+    }
+
+    int errorRow;
+    std::string errorDesc;
+    auto root = LoadWindowXML(path, errorRow, errorDesc);
+    if (!root)
+      CLog::Log(LOGDEBUG, "CGUIWindowCache: unable to preload %s. Line %d\n%s", path.c_str(), errorRow, errorDesc.c_str());
+
+    CSingleLock lock(m_critSection);
+    if (root && generation == m_generation && m_parsed.find(path) == m_parsed.end())
+    {
+      CLog::Log(LOGDEBUG, "CGUIWindowCache: preloaded %s", path.c_str());
+      ParsedWindow& window = m_parsed[path];
+      window.root = root;
+      window.lastUsed = ++m_useCounter;
+      EvictLeastRecentlyUsed(m_parsed, WINDOW_CACHE_PARSED_WINDOWS);
+    }
+  }
+}
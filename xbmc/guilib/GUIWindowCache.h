@@ -0,0 +1,149 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "interfaces/info/InfoBool.h"
+#include "threads/CriticalSection.h"
+
+class TiXmlElement;
+
+// resolved trees of include heavy skins can get large, so only keep the most recently used ones
+#define WINDOW_CACHE_RESOLVED_WINDOWS 24
+#define WINDOW_CACHE_PARSED_WINDOWS   64
+
+/*!
+ \brief Per skin cache of window XML.
+
+ Loading a window parses its XML file, clones it and resolves all includes,
+ constants and expressions on every (re)load. This cache keeps both the parsed
+ window XML and the resolved tree of recently loaded windows of the current
+ skin in memory. The parsed XML is read through CXMLBinaryCache, so it is only
+ tokenized again when the file on disk changed. A resolved tree is reused as
+ long as all include conditions it was resolved with still evaluate to the
+ same values.
+
+ Once a window has been loaded, the XML of the windows it can activate from
+ its actions is read and parsed in the background, so that opening one of
+ them does not have to wait for the file system. Resolving includes and
+ creating controls still happens on the GUI thread.
+
+ The cache is cleared whenever the skin is unloaded.
+ */
+class CGUIWindowCache
+{
+public:
+  CGUIWindowCache();
+  ~CGUIWindowCache();
+
+  /*!
+   \brief Check if the given window XML file is cached by this cache, which is
+   the case for all files of the current skin.
+   */
+  bool IsCacheable(const std::string& path) const;
+
+  /*!
+   \brief Get a copy of the parsed XML of the given window file.
+
+   \param path Path of the window XML file
+   \param errorRow Receives the line of the parse error if the file could not be loaded
+   \param errorDesc Receives the description of the error if the file could not be loaded
+   \return The root element of the file, nullptr if it could not be loaded
+   */
+  std::unique_ptr<TiXmlElement> GetWindowXML(const std::string& path, int& errorRow, std::string& errorDesc);
+
+  /*!
+   \brief Get a copy of the resolved XML of the given window file.
+
+   \param path Path of the window XML file
+   \param xmlIncludeConditions Receives the include conditions the tree was resolved with
+   \return The resolved root element, nullptr if none is cached or any of its
+   include conditions changed its value
+   */
+  std::unique_ptr<TiXmlElement> GetResolvedXML(const std::string& path, std::map<INFO::InfoPtr, bool>& xmlIncludeConditions);
+
+  /*!
+   \brief Store the resolved XML of the given window file.
+
+   \param path Path of the window XML file
+   \param root The resolved root element
+   \param xmlIncludeConditions The include conditions the tree was resolved with
+   */
+  void SetResolvedXML(const std::string& path, const TiXmlElement& root, const std::map<INFO::InfoPtr, bool>& xmlIncludeConditions);
+
+  /*!
+   \brief Read the XML of all windows reachable from the given window in the
+   background.
+
+   \param path Path of the window XML file, must have been stored with SetResolvedXML()
+   */
+  void PreloadReachable(const std::string& path);
+
+  /*!
+   \brief Drop all cached windows.
+   */
+  void Clear();
+
+private:
+  struct ResolvedWindow
+  {
+    std::shared_ptr<const TiXmlElement> root;
+    std::map<INFO::InfoPtr, bool> conditions;
+    std::vector<std::string> reachable;
+    uint64_t lastUsed = 0;
+  };
+
+  struct ParsedWindow
+  {
+    std::shared_ptr<const TiXmlElement> root;
+    uint64_t lastUsed = 0;
+  };
+
+  /*!
+   \brief Lets the preload job find out whether the cache still exists.
+   The job holds the lock while it works on the cache, the destructor takes it
+   to detach the cache, so only a job that is actually running is waited for.
+   */
+  struct PreloadOwner
+  {
+    CCriticalSection critSection;
+    CGUIWindowCache* cache;
+  };
+
+  static std::shared_ptr<const TiXmlElement> LoadWindowXML(const std::string& path, int& errorRow, std::string& errorDesc);
+  static std::vector<std::string> GetReachableWindows(const TiXmlElement& root);
+  void StoreWindowXML(const std::string& path, const std::shared_ptr<const TiXmlElement>& root);
+  void Preload();
+
+  std::map<std::string, ParsedWindow> m_parsed;
+  std::map<std::string, ResolvedWindow> m_resolved;
+  std::vector<std::string> m_preloadQueue;
+  uint64_t m_useCounter = 0;
+  unsigned int m_generation = 0;
+  bool m_preloading = false;
+  CCriticalSection m_critSection;
+  std::shared_ptr<PreloadOwner> m_preloadOwner;
+};
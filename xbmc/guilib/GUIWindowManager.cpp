@@ -27,6 +27,7 @@
 #include "GUIPassword.h"
 #include "GUIInfoManager.h"
 #include "threads/SingleLock.h"
+#include "utils/FrameTrace.h"
 #include "utils/URIUtils.h"
 #include "SeekHandler.h"
 #include "settings/AdvancedSettings.h"
@@ -1110,6 +1111,8 @@ bool RenderOrderSortFunction(CGUIWindow *first, CGUIWindow *second)
 
 void CGUIWindowManager::Process(unsigned int currentTime)
 {
+  FRAME_TRACE_ZONE("CGUIWindowManager::Process");
+
   assert(g_application.IsCurrentThread());
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
@@ -1191,6 +1194,8 @@ void CGUIWindowManager::RenderEx() const
 
 bool CGUIWindowManager::Render()
 {
+  FRAME_TRACE_ZONE("CGUIWindowManager::Render");
+
   assert(g_application.IsCurrentThread());
   CSingleExit lock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
@@ -1364,6 +1369,9 @@ void CGUIWindowManager::DeInitialize()
   m_vecCustomWindows.clear();
   m_activeDialogs.clear();
 
+  // cached windows belong to the skin that is being unloaded
+  m_windowCache.Clear();
+
   m_initialized = false;
 }
 
@@ -28,6 +28,7 @@
 #include "DirtyRegionTracker.h"
 #include "guilib/WindowIDs.h"
 #include "GUIWindow.h"
+#include "GUIWindowCache.h"
 #include "IMsgTargetCallback.h"
 #include "IWindowManagerCallback.h"
 #include "messaging/IMessageTarget.h"
@@ -224,6 +225,10 @@ public:
 
   bool HasVisibleControls();
 
+  /*! \brief Get the cache of window XML of the current skin.
+   */
+  CGUIWindowCache& GetWindowCache() { return m_windowCache; }
+
 #ifdef _DEBUG
   void DumpTextureUse();
 #endif
@@ -280,4 +285,6 @@ private:
 
   CDirtyRegionList m_dirtyregions;
   CDirtyRegionTracker m_tracker;
+
+  CGUIWindowCache m_windowCache;
 };
@@ -76,8 +76,8 @@ protected:
   typedef std::map<uint32_t, LocStr>::const_iterator ciStrings;
   typedef std::map<uint32_t, LocStr>::iterator       iStrings;
 
-  CSharedSection m_stringsMutex;
-  CSharedSection m_addonStringsMutex;
+  CSharedSection m_stringsMutex{"CLocalizeStrings"};
+  CSharedSection m_addonStringsMutex{"CLocalizeStrings::addons"};
 };
 
 /*!
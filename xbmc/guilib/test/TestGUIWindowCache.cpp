@@ -0,0 +1,184 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "guilib/GUIWindowCache.h"
+#include "interfaces/info/InfoBool.h"
+#include "utils/StringUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+// info bool that reports whatever value the test sets
+class TestInfoBool : public INFO::InfoBool
+{
+public:
+  TestInfoBool(const bool& value, unsigned int& refreshCounter)
+    : InfoBool("test", 0, refreshCounter), m_source(value) { }
+
+  void Update(const CGUIListItem* item) override { m_value = m_source; }
+
+private:
+  const bool& m_source;
+};
+
+std::string GetPath(int window)
+{
+  return StringUtils::Format("window%d.xml", window);
+}
+
+TiXmlElement MakeWindow(int id)
+{
+  TiXmlElement root("window");
+  root.SetAttribute("id", id);
+  return root;
+}
+
+int GetId(const TiXmlElement* root)
+{
+  int id = -1;
+  if (root)
+    root->QueryIntAttribute("id", &id);
+  return id;
+}
+
+bool IsResolved(CGUIWindowCache& cache, const std::string& path)
+{
+  std::map<INFO::InfoPtr, bool> conditions;
+  return cache.GetResolvedXML(path, conditions) != nullptr;
+}
+
+class TestGUIWindowCache : public testing::Test
+{
+protected:
+  ~TestGUIWindowCache() override
+  {
+    for (const auto& path : m_files)
+      XFILE::CFile::Delete(path);
+  }
+
+  std::string WriteWindow(int window, int id)
+  {
+    std::string path = CSpecialProtocol::TranslatePath("special://temp/" + GetPath(window));
+    std::string xml = StringUtils::Format("<window id=\"%d\"></window>", id);
+    XFILE::CFile file;
+    if (!file.OpenForWrite(path, true))
+      return path;
+    file.Write(xml.c_str(), xml.size());
+    file.Close();
+    if (std::find(m_files.begin(), m_files.end(), path) == m_files.end())
+      m_files.push_back(path);
+    return path;
+  }
+
+  int LoadWindow(CGUIWindowCache& cache, const std::string& path)
+  {
+    int errorRow;
+    std::string errorDesc;
+    std::unique_ptr<TiXmlElement> root = cache.GetWindowXML(path, errorRow, errorDesc);
+    return GetId(root.get());
+  }
+
+  std::vector<std::string> m_files;
+};
+}
+
+TEST_F(TestGUIWindowCache, ResolvedLeastRecentlyUsed)
+{
+  CGUIWindowCache cache;
+  std::map<INFO::InfoPtr, bool> conditions;
+  for (int i = 0; i < WINDOW_CACHE_RESOLVED_WINDOWS; i++)
+    cache.SetResolvedXML(GetPath(i), MakeWindow(i), conditions);
+
+  // using the oldest window makes the second one the least recently used
+  std::unique_ptr<TiXmlElement> root = cache.GetResolvedXML(GetPath(0), conditions);
+  EXPECT_EQ(0, GetId(root.get()));
+
+  cache.SetResolvedXML(GetPath(WINDOW_CACHE_RESOLVED_WINDOWS), MakeWindow(WINDOW_CACHE_RESOLVED_WINDOWS), conditions);
+  EXPECT_TRUE(IsResolved(cache, GetPath(0)));
+  EXPECT_FALSE(IsResolved(cache, GetPath(1)));
+  for (int i = 2; i <= WINDOW_CACHE_RESOLVED_WINDOWS; i++)
+    EXPECT_TRUE(IsResolved(cache, GetPath(i))) << GetPath(i);
+}
+
+TEST_F(TestGUIWindowCache, ParsedLeastRecentlyUsed)
+{
+  CGUIWindowCache cache;
+  std::string path = WriteWindow(0, 1);
+  EXPECT_EQ(1, LoadWindow(cache, path));
+
+  // the parsed xml is kept, changes on disk are only seen once it was evicted
+  WriteWindow(0, 22);
+  EXPECT_EQ(1, LoadWindow(cache, path));
+
+  for (int i = 1; i <= WINDOW_CACHE_PARSED_WINDOWS; i++)
+    EXPECT_EQ(i, LoadWindow(cache, WriteWindow(i, i)));
+  EXPECT_EQ(22, LoadWindow(cache, path));
+}
+
+TEST_F(TestGUIWindowCache, ChangedIncludeCondition)
+{
+  CGUIWindowCache cache;
+  unsigned int refreshCounter = 0;
+  bool value = true;
+  INFO::InfoPtr condition = std::make_shared<TestInfoBool>(value, refreshCounter);
+
+  std::map<INFO::InfoPtr, bool> conditions;
+  conditions[condition] = condition->Get();
+  cache.SetResolvedXML(GetPath(0), MakeWindow(0), conditions);
+
+  std::map<INFO::InfoPtr, bool> resolvedConditions;
+  std::unique_ptr<TiXmlElement> root = cache.GetResolvedXML(GetPath(0), resolvedConditions);
+  EXPECT_EQ(0, GetId(root.get()));
+  EXPECT_EQ(conditions, resolvedConditions);
+
+  value = false;
+  resolvedConditions.clear();
+  EXPECT_EQ(nullptr, cache.GetResolvedXML(GetPath(0), resolvedConditions).get());
+  EXPECT_TRUE(resolvedConditions.empty());
+
+  // the tree is still valid once the condition has its old value again
+  value = true;
+  EXPECT_TRUE(IsResolved(cache, GetPath(0)));
+}
+
+TEST_F(TestGUIWindowCache, Clear)
+{
+  CGUIWindowCache cache;
+  std::map<INFO::InfoPtr, bool> conditions;
+  cache.SetResolvedXML(GetPath(0), MakeWindow(0), conditions);
+  std::string path = WriteWindow(1, 1);
+  EXPECT_EQ(1, LoadWindow(cache, path));
+  WriteWindow(1, 22);
+
+  // a skin reload clears the cache, so the files are read again
+  cache.Clear();
+  EXPECT_FALSE(IsResolved(cache, GetPath(0)));
+  EXPECT_EQ(22, LoadWindow(cache, path));
+}
@@ -20,17 +20,30 @@
 
 #include "InfoBool.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 
 namespace INFO
 {
+  bool InfoBool::m_profiling = false;
+
   InfoBool::InfoBool(const std::string &expression, int context, unsigned int &refreshCounter)
     : m_value(false),
       m_context(context),
       m_listItemDependent(false),
       m_expression(expression),
       m_refreshCounter(0),
-      m_parentRefreshCounter(refreshCounter)
+      m_parentRefreshCounter(&refreshCounter),
+      m_evaluations(0),
+      m_evaluationTime(0)
   {
     StringUtils::ToLower(m_expression);
   }
+
+  void InfoBool::EvaluateProfiled(const CGUIListItem *item)
+  {
+    int64_t start = CurrentHostCounter();
+    Update(item);
+    m_evaluationTime += CurrentHostCounter() - start;
+    m_evaluations++;
+  }
 }
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <stdint.h>
 #include <string>
 #include <memory>
 
@@ -46,11 +47,11 @@ public:
   inline bool Get(const CGUIListItem *item = NULL)
   {
     if (item && m_listItemDependent)
-      Update(item);
-    else if (m_refreshCounter != m_parentRefreshCounter || m_refreshCounter == 0)
+      Evaluate(item);
+    else if (m_refreshCounter != *m_parentRefreshCounter || m_refreshCounter == 0)
     {
-      Update(NULL);
-      m_refreshCounter = m_parentRefreshCounter;
+      Evaluate(NULL);
+      m_refreshCounter = *m_parentRefreshCounter;
     }
     return m_value;
   }
@@ -77,8 +78,37 @@ public:
   virtual void Update(const CGUIListItem *item) {};
 
   const std::string &GetExpression() const { return m_expression; }
+  int GetContext() const { return m_context; }
   bool ListItemDependent() const { return m_listItemDependent; }
+
+  /*! \brief The counter that invalidates the cached value
+   */
+  unsigned int& GetRefreshCounter() const { return *m_parentRefreshCounter; }
+
+  /*! \brief Enable or disable recording of evaluation counts and times for all info bools
+   \sa GetEvaluationCount, GetEvaluationTime
+   */
+  static void SetProfiling(bool profile) { m_profiling = profile; }
+  static bool IsProfiling() { return m_profiling; }
+
+  /*! \brief Number of times the value was (re)evaluated while profiling
+   */
+  unsigned int GetEvaluationCount() const { return m_evaluations; }
+
+  /*! \brief Time spent evaluating while profiling, in host counter ticks.
+   This includes the time spent in any info bools this one depends on.
+   */
+  int64_t GetEvaluationTime() const { return m_evaluationTime; }
+  void ResetProfile() { m_evaluations = 0; m_evaluationTime = 0; }
 protected:
+  /*! \brief Follow another refresh counter than the one given on construction
+   Used for conditions whose value is only invalidated by their provider.
+   */
+  void SetRefreshCounter(unsigned int &refreshCounter)
+  {
+    m_parentRefreshCounter = &refreshCounter;
+    m_refreshCounter = 0;
+  }
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
@@ -86,8 +116,20 @@ protected:
   std::string  m_expression;   ///< original expression
 
 private:
+  inline void Evaluate(const CGUIListItem *item)
+  {
+    if (m_profiling)
+      EvaluateProfiled(item);
+    else
+      Update(item);
+  }
+  void EvaluateProfiled(const CGUIListItem *item);
+
   unsigned int m_refreshCounter;
-  unsigned int &m_parentRefreshCounter;
+  unsigned int *m_parentRefreshCounter;
+  unsigned int m_evaluations;
+  int64_t m_evaluationTime;
+  static bool m_profiling;
 };
 
 typedef std::shared_ptr<InfoBool> InfoPtr;
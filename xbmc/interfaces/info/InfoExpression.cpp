@@ -29,9 +29,28 @@
 
 using namespace INFO;
 
+namespace
+{
+// returns the position of the ']' closing the bracket opened just before start, or NULL
+const char* FindMatchingBracket(const char *start)
+{
+  int depth = 1;
+  for (const char *c = start; *c; c++)
+  {
+    if (*c == '[')
+      depth++;
+    else if (*c == ']' && --depth == 0)
+      return c;
+  }
+  return NULL;
+}
+}
+
 void InfoSingle::Initialize()
 {
-  m_condition = CServiceBroker::GetGUI()->GetInfoManager().TranslateSingleString(m_expression, m_listItemDependent);
+  CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
+  m_condition = infoMgr.TranslateSingleString(m_expression, m_listItemDependent);
+  SetRefreshCounter(infoMgr.GetRefreshCounter(m_condition));
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -46,6 +65,12 @@ void InfoExpression::Initialize()
     CLog::Log(LOGERROR, "Error parsing boolean expression %s", m_expression.c_str());
     m_expression_tree = std::make_shared<InfoLeaf>(CServiceBroker::GetGUI()->GetInfoManager().Register("false", 0), false);
   }
+
+  // an expression whose leaves all follow the same counter only needs to be
+  // evaluated again when they do, e.g. one that depends on skin settings only
+  unsigned int *refreshCounter = m_expression_tree->GetRefreshCounter();
+  if (refreshCounter)
+    SetRefreshCounter(*refreshCounter);
 }
 
 void InfoExpression::Update(const CGUIListItem *item)
@@ -69,6 +94,12 @@ void InfoExpression::Update(const CGUIListItem *item)
  * 2) Combining adjacent AND or OR operations such that each path from the root
  *    to a leaf encounters a strictly alternating pattern of AND and OR
  *    operations. So [A|B]|[C|D+[[E|F]|G] becomes A|B|C|[D+[E|F|G]].
+ *
+ * Bracketed subexpressions containing a binary operator are the exception:
+ * they are registered with the info manager as expressions of their own and
+ * become leaves. Skins repeat the same bracketed conditions across many
+ * controls, and as registered info bools are shared and cached per frame,
+ * such a subexpression is evaluated once per frame instead of once per user.
  */
 
 bool InfoExpression::InfoLeaf::Evaluate(const CGUIListItem *item)
@@ -76,6 +107,11 @@ bool InfoExpression::InfoLeaf::Evaluate(const CGUIListItem *item)
   return m_invert ^ m_info->Get(item);
 }
 
+unsigned int *InfoExpression::InfoLeaf::GetRefreshCounter()
+{
+  return &m_info->GetRefreshCounter();
+}
+
 InfoExpression::InfoAssociativeGroup::InfoAssociativeGroup(
     node_type_t type,
     const InfoSubexpressionPtr &left,
@@ -96,6 +132,19 @@ void InfoExpression::InfoAssociativeGroup::Merge(std::shared_ptr<InfoAssociative
   m_children.splice(m_children.end(), other->m_children);
 }
 
+unsigned int *InfoExpression::InfoAssociativeGroup::GetRefreshCounter()
+{
+  unsigned int *refreshCounter = NULL;
+  for (const auto &child : m_children)
+  {
+    unsigned int *childCounter = child->GetRefreshCounter();
+    if (!childCounter || (refreshCounter && childCounter != refreshCounter))
+      return NULL;
+    refreshCounter = childCounter;
+  }
+  return refreshCounter;
+}
+
 bool InfoExpression::InfoAssociativeGroup::Evaluate(const CGUIListItem *item)
 {
   /* Handle either AND or OR by using the relation
@@ -238,7 +287,30 @@ bool InfoExpression::Parse(const std::string &expression)
         return false;
       }
       if (c == '[')
+      {
+        const char *end = FindMatchingBracket(s);
+        if (end)
+        {
+          std::string subexpression(s, end - s);
+          if (subexpression.find_first_of("+|") != std::string::npos)
+          {
+            InfoPtr info = infoMgr.Register(subexpression, m_context);
+            if (!info)
+            {
+              CLog::Log(LOGERROR, "Bad subexpression '%s'", subexpression.c_str());
+              return false;
+            }
+            m_listItemDependent |= info->ListItemDependent();
+            nodes.push(std::make_shared<InfoLeaf>(info, invert));
+            after_binaryoperator = false;
+            s = end + 1;
+            // Skip trailing whitespace - don't want it to count as an operand if that's all there is
+            while (isspace((unsigned char)(c=*s))) s++;
+            continue;
+          }
+        }
         bracket_count++;
+      }
       else if (c == ']' && bracket_count-- == 0)
       {
         CLog::Log(LOGERROR, "Unmatched ]");
@@ -80,6 +80,8 @@ private:
     virtual ~InfoSubexpression(void) = default; // so we can destruct derived classes using a pointer to their base class
     virtual bool Evaluate(const CGUIListItem *item) = 0;
     virtual node_type_t Type() const=0;
+    // the refresh counter all leaves follow, NULL if they differ
+    virtual unsigned int *GetRefreshCounter() = 0;
   };
 
   typedef std::shared_ptr<InfoSubexpression> InfoSubexpressionPtr;
@@ -91,6 +93,7 @@ private:
     InfoLeaf(InfoPtr info, bool invert) : m_info(info), m_invert(invert) {};
     bool Evaluate(const CGUIListItem *item) override;
     node_type_t Type() const override { return NODE_LEAF; };
+    unsigned int *GetRefreshCounter() override;
   private:
     InfoPtr m_info;
     bool m_invert;
@@ -105,6 +108,7 @@ private:
     void Merge(std::shared_ptr<InfoAssociativeGroup> other);
     bool Evaluate(const CGUIListItem *item) override;
     node_type_t Type() const override { return m_type; };
+    unsigned int *GetRefreshCounter() override;
   private:
     node_type_t m_type;
     std::list<InfoSubexpressionPtr> m_children;
@@ -18,10 +18,18 @@
  *
  */
 
+#include <algorithm>
+#include <atomic>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <set>
 #include <string.h>
 
 #include "JSONRPC.h"
+#include "ServiceBroker.h"
 #include "ServiceDescription.h"
+#include "XBDateTime.h"
 #include "addons/Addon.h"
 #include "addons/IAddon.h"
 #include "dbwrappers/DatabaseQuery.h"
@@ -29,7 +37,14 @@
 #include "input/WindowTranslator.h"
 #include "interfaces/AnnouncementManager.h"
 #include "playlists/SmartPlayList.h"
+#include "profiles/ProfilesManager.h"
 #include "settings/AdvancedSettings.h"
+#include "settings/Settings.h"
+#include "settings/lib/ISettingCallback.h"
+#include "settings/lib/ISettingsHandler.h"
+#include "settings/lib/SettingsManager.h"
+#include "threads/Event.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
@@ -40,6 +55,62 @@ using namespace JSONRPC;
 
 bool CJSONRPC::m_initialized = false;
 
+// the calling thread works on a batch as well, so at most this many
+// additional workers are used for the read-only calls of a batch
+#define MAX_BATCH_WORKERS 4
+
+namespace
+{
+struct BatchState
+{
+  std::function<void(unsigned int)> handle;
+  unsigned int count = 0;
+  std::atomic<unsigned int> next{0};
+  std::atomic<unsigned int> done{0};
+  CEvent finished{true};
+
+  // claims calls until none are left, helpers that start late find nothing
+  // to do and never touch the caller's data
+  void Work()
+  {
+    unsigned int index;
+    while ((index = next++) < count)
+    {
+      handle(index);
+      if (++done == count)
+        finished.Set();
+    }
+  }
+};
+
+/*!
+ \brief Counts the changes announced for the video and music library as well
+ as (re)loads of the settings of a profile and changes of the settings that
+ alter the results of the library methods
+ */
+class CLibraryVersion : public IAnnouncer, public ISettingsHandler, public ISettingCallback
+{
+public:
+  void Announce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data) override
+  {
+    if (flag == VideoLibrary || flag == AudioLibrary)
+      ++m_version;
+  }
+
+  void OnSettingsLoaded() override { ++m_version; }
+  void OnSettingChanged(std::shared_ptr<const CSetting> setting) override { ++m_version; }
+
+  unsigned int Get() const { return m_version; }
+
+private:
+  std::atomic<unsigned int> m_version{0};
+};
+
+CLibraryVersion libraryVersion;
+// distinguishes the entity tags of different runs, the version starts at 0 in every run
+unsigned int libraryVersionEpoch = 0;
+}
+
 void CJSONRPC::Initialize()
 {
   if (m_initialized)
@@ -110,13 +181,44 @@ void CJSONRPC::Initialize()
 
   for (unsigned int index = 0; index < size; index++)
     CJSONServiceDescription::AddNotification(JSONRPC_SERVICE_NOTIFICATIONS[index]);
-  
+
+  CJSONServiceDescription::CompileValidators();
+
+  libraryVersionEpoch = static_cast<unsigned int>(time(NULL));
+  CAnnouncementManager::GetInstance().AddAnnouncer(&libraryVersion);
+
+  CSettingsManager *settingsManager = CServiceBroker::GetSettings().GetSettingsManager();
+  if (settingsManager != nullptr)
+  {
+    std::set<std::string> settingSet;
+    settingSet.insert(CSettings::SETTING_FILELISTS_IGNORETHEWHENSORTING);
+    settingSet.insert(CSettings::SETTING_VIDEOLIBRARY_SHOWEMPTYTVSHOWS);
+    settingSet.insert(CSettings::SETTING_VIDEOLIBRARY_GROUPMOVIESETS);
+    settingSet.insert(CSettings::SETTING_VIDEOLIBRARY_GROUPSINGLEITEMSETS);
+    settingSet.insert(CSettings::SETTING_MUSICLIBRARY_SHOWCOMPILATIONARTISTS);
+    settingSet.insert(CSettings::SETTING_MUSICLIBRARY_ARTISTSFOLDER);
+    settingsManager->RegisterCallback(&libraryVersion, settingSet);
+    settingsManager->RegisterSettingsHandler(&libraryVersion);
+  }
+
   m_initialized = true;
   CLog::Log(LOGINFO, "JSONRPC v%s: Successfully initialized", CJSONServiceDescription::GetVersion());
 }
 
 void CJSONRPC::Cleanup()
 {
+  if (m_initialized)
+  {
+    CAnnouncementManager::GetInstance().RemoveAnnouncer(&libraryVersion);
+
+    CSettingsManager *settingsManager = CServiceBroker::GetSettings().GetSettingsManager();
+    if (settingsManager != nullptr)
+    {
+      settingsManager->UnregisterSettingsHandler(&libraryVersion);
+      settingsManager->UnregisterCallback(&libraryVersion);
+    }
+  }
+
   CJSONServiceDescription::Cleanup();
   m_initialized = false;
 }
@@ -253,12 +355,35 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
       }
       else
       {
-        for (CVariant::const_iterator_array itr = inputroot.begin_array(); itr != inputroot.end_array(); itr++)
+        std::vector<CVariant> responses(inputroot.size());
+        std::vector<char> hasResponses(inputroot.size(), false);
+
+        // consecutive read-only calls run concurrently, any other call
+        // runs on its own after all calls in front of it finished
+        unsigned int index = 0;
+        while (index < inputroot.size())
         {
-          CVariant response;
-          if (HandleMethodCall(*itr, response, transport, client))
+          unsigned int last = index;
+          while (last < inputroot.size() && IsReadOnlyCall(inputroot[last]))
+            last++;
+
+          if (last - index > 1)
+          {
+            HandleMethodCalls(inputroot, index, last, responses, hasResponses, transport, client);
+            index = last;
+          }
+          else
           {
-            outputroot.append(response);
+            hasResponses[index] = HandleMethodCall(inputroot[index], responses[index], transport, client);
+            index++;
+          }
+        }
+
+        for (unsigned int i = 0; i < responses.size(); i++)
+        {
+          if (hasResponses[i])
+          {
+            outputroot.append(responses[i]);
             hasResponse = true;
           }
         }
@@ -316,6 +441,86 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
   return !isNotification;
 }
 
+void CJSONRPC::HandleMethodCalls(const CVariant& batch, unsigned int first, unsigned int last, std::vector<CVariant>& responses,
+                                 std::vector<char>& hasResponses, ITransportLayer *transport, IClient *client)
+{
+  std::shared_ptr<BatchState> state = std::make_shared<BatchState>();
+  state->count = last - first;
+  state->handle = [&batch, first, &responses, &hasResponses, transport, client](unsigned int index)
+  {
+    hasResponses[first + index] = HandleMethodCall(batch[first + index], responses[first + index], transport, client);
+  };
+
+  unsigned int workers = std::min<unsigned int>(state->count - 1, MAX_BATCH_WORKERS);
+  for (unsigned int i = 0; i < workers; i++)
+    CJobManager::GetInstance().Submit([state]() { state->Work(); }, CJob::PRIORITY_HIGH);
+
+  state->Work();
+  state->finished.Wait();
+
+  CLog::Log(LOGDEBUG, LOGJSONRPC, "JSONRPC: Handled %u read-only calls of a batch concurrently", state->count);
+}
+
+bool CJSONRPC::GetLibraryETag(const std::string &inputString, std::string &etag)
+{
+  // other instances sharing a MySQL database change the library without
+  // this instance announcing it
+  if (StringUtils::EqualsNoCase(g_advancedSettings.m_databaseVideo.type, "mysql") ||
+      StringUtils::EqualsNoCase(g_advancedSettings.m_databaseMusic.type, "mysql"))
+    return false;
+
+  CVariant inputroot;
+  if (!CJSONVariantParser::Parse(inputString, inputroot) || inputroot.isNull())
+    return false;
+
+  if (inputroot.isArray() && inputroot.empty())
+    return false;
+
+  CVariant calls(CVariant::VariantTypeArray);
+  if (inputroot.isArray())
+    calls = inputroot;
+  else
+    calls.push_back(inputroot);
+
+  for (CVariant::const_iterator_array itr = calls.begin_array(); itr != calls.end_array(); ++itr)
+  {
+    if (!IsReadOnlyCall(*itr))
+      return false;
+
+    std::string methodName = (*itr)["method"].asString();
+    StringUtils::ToLower(methodName);
+    if (!StringUtils::StartsWith(methodName, "videolibrary.get") &&
+        !StringUtils::StartsWith(methodName, "audiolibrary.get"))
+      return false;
+  }
+
+  // the same request returns different results for another profile or
+  // database and smart playlist rules relative to today change every day
+  const CProfilesManager &profileManager = CServiceBroker::GetProfileManager();
+  std::string state = StringUtils::Format("%u|%s|%s|%s|%s|%s|%s",
+                                          profileManager.GetCurrentProfileIndex(),
+                                          profileManager.GetDatabaseFolder().c_str(),
+                                          g_advancedSettings.m_databaseVideo.host.c_str(),
+                                          g_advancedSettings.m_databaseVideo.name.c_str(),
+                                          g_advancedSettings.m_databaseMusic.host.c_str(),
+                                          g_advancedSettings.m_databaseMusic.name.c_str(),
+                                          CDateTime::GetCurrentDateTime().GetAsDBDate().c_str());
+
+  etag = StringUtils::Format("\"%x-%x-%zx-%zx\"", libraryVersionEpoch, libraryVersion.Get(),
+                             std::hash<std::string>()(state), std::hash<std::string>()(inputString));
+  return true;
+}
+
+bool CJSONRPC::IsReadOnlyCall(const CVariant& request)
+{
+  if (!IsProperJSONRPC(request))
+    return false;
+
+  std::string methodName = request["method"].asString();
+  StringUtils::ToLower(methodName);
+  return CJSONServiceDescription::IsReadOnly(methodName);
+}
+
 inline bool CJSONRPC::IsProperJSONRPC(const CVariant& inputroot)
 {
   return inputroot.isMember("jsonrpc") && inputroot["jsonrpc"].isString() && inputroot["jsonrpc"] == CVariant("2.0") && inputroot.isMember("method") && inputroot["method"].isString() && (!inputroot.isMember("params") || inputroot["params"].isArray() || inputroot["params"].isObject());
@@ -23,6 +23,7 @@
 #include <map>
 #include <stdio.h>
 #include <string>
+#include <vector>
 
 #include "JSONRPCUtils.h"
 #include "JSONServiceDescription.h"
@@ -64,6 +65,17 @@ namespace JSONRPC
      */
     static std::string MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client);
 
+    /*!
+     \brief Gets an entity tag for the response to a library query
+     \param inputString received JSON-RPC request
+     \param etag tag which changes whenever the request, the video or music library, the
+     profile, its database, a setting affecting the results or the current date changes
+     \return True if the request only consists of read-only VideoLibrary.Get* and
+     AudioLibrary.Get* calls so a cached response can be revalidated with the tag,
+     false for any request while the video or music library is in a MySQL database
+     */
+    static bool GetLibraryETag(const std::string &inputString, std::string &etag);
+
     static JSONRPC_STATUS Introspect(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Version(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Permission(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
@@ -74,6 +86,15 @@ namespace JSONRPC
   
   private:
     static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
+    /*!
+     \brief Handles the calls [first, last) of a batch concurrently on the
+     calling thread and job manager workers
+     \param responses result slots of the whole batch, written at the index of each call
+     \param hasResponses whether the call at the same index produced a response
+     */
+    static void HandleMethodCalls(const CVariant& batch, unsigned int first, unsigned int last, std::vector<CVariant>& responses,
+                                  std::vector<char>& hasResponses, ITransportLayer *transport, IClient *client);
+    static bool IsReadOnlyCall(const CVariant& request);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
 
     inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response);
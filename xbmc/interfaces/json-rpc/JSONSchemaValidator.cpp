@@ -0,0 +1,349 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "JSONSchemaValidator.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "JSONServiceDescription.h"
+
+using namespace JSONRPC;
+
+bool CJSONSchemaValidator::Validate(const CVariant &value) const
+{
+  if (!IsType(value, m_type))
+    return false;
+  if (value.isNull() && !HasType(m_type, NullValue))
+    return false;
+
+  if (!m_unionTypes.empty())
+  {
+    bool ok = false;
+    for (const auto& unionType : m_unionTypes)
+    {
+      if (unionType->Validate(value))
+      {
+        ok = true;
+        break;
+      }
+    }
+
+    if (!ok)
+      return false;
+  }
+
+  for (const auto& extended : m_extends)
+  {
+    if (!extended->Validate(value))
+      return false;
+  }
+
+  if (HasType(m_type, ArrayValue) && value.isArray())
+    return validateArray(value);
+
+  if (HasType(m_type, ObjectValue) && value.isObject())
+    return validateObject(value);
+
+  return validateScalar(value);
+}
+
+bool CJSONSchemaValidator::validateArray(const CVariant &value) const
+{
+  if ((m_minItems > 0 && value.size() < m_minItems) || (m_maxItems > 0 && value.size() > m_maxItems))
+    return false;
+
+  if (m_items.size() == 1)
+  {
+    for (CVariant::const_iterator_array it = value.begin_array(); it != value.end_array(); ++it)
+    {
+      if (!m_items.front()->Validate(*it))
+        return false;
+    }
+  }
+  else if (m_items.size() > 1)
+  {
+    // tuple typing, every element must match the schema at the same position
+    if (value.size() < m_items.size() || (value.size() != m_items.size() && m_additionalItems.empty()))
+      return false;
+
+    for (unsigned int index = 0; index < value.size(); index++)
+    {
+      if (index < m_items.size())
+      {
+        if (!m_items[index]->Validate(value[index]))
+          return false;
+        continue;
+      }
+
+      bool ok = false;
+      for (const auto& additional : m_additionalItems)
+      {
+        if (additional->Validate(value[index]))
+        {
+          ok = true;
+          break;
+        }
+      }
+
+      if (!ok)
+        return false;
+    }
+  }
+
+  if (m_uniqueItems)
+  {
+    for (unsigned int checkingIndex = 0; checkingIndex < value.size(); checkingIndex++)
+    {
+      for (unsigned int checkedIndex = checkingIndex + 1; checkedIndex < value.size(); checkedIndex++)
+      {
+        if (value[checkingIndex] == value[checkedIndex])
+          return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool CJSONSchemaValidator::validateObject(const CVariant &value) const
+{
+  unsigned int handled = 0;
+  for (const auto& property : m_properties)
+  {
+    const CVariant &member = value[property.name];
+    if (!member.isNull() || value.isMember(property.name))
+    {
+      if (!property.validator->Validate(member))
+        return false;
+      handled++;
+    }
+    else if (!property.optional)
+      return false;
+  }
+
+  if (handled < value.size())
+  {
+    if (!m_hasAdditionalProperties)
+      return false;
+
+    if (m_additionalProperties != nullptr)
+    {
+      for (CVariant::const_iterator_map it = value.begin_map(); it != value.end_map(); ++it)
+      {
+        if (findProperty(it->first) == nullptr && !m_additionalProperties->Validate(it->second))
+          return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool CJSONSchemaValidator::validateScalar(const CVariant &value) const
+{
+  if (!m_enums.empty() && std::find(m_enums.begin(), m_enums.end(), value) == m_enums.end())
+    return false;
+
+  if ((HasType(m_type, NumberValue) && value.isDouble()) || (HasType(m_type, IntegerValue) && value.isInteger()))
+  {
+    double numberValue = value.isDouble() ? value.asDouble() : (double)value.asInteger();
+    if (m_checkRange &&
+        ((m_exclusiveMinimum && numberValue <= m_minimum) || (!m_exclusiveMinimum && numberValue < m_minimum) ||
+         (m_exclusiveMaximum && numberValue >= m_maximum) || (!m_exclusiveMaximum && numberValue > m_maximum)))
+      return false;
+
+    if (HasType(m_type, IntegerValue) && m_divisibleBy > 0 && ((int)numberValue % m_divisibleBy) != 0)
+      return false;
+  }
+
+  if ((m_minLength > 0 || m_maxLength >= 0) && HasType(m_type, StringValue) && value.isString())
+  {
+    int size = value.asString().size();
+    if (size < m_minLength || (m_maxLength >= 0 && size > m_maxLength))
+      return false;
+  }
+
+  return true;
+}
+
+void CJSONSchemaValidator::Complete(const CVariant &value, CVariant &output) const
+{
+  if (m_plain && output.isNull())
+  {
+    output = value;
+    return;
+  }
+
+  for (const auto& unionType : m_unionTypes)
+  {
+    if (unionType->Validate(value))
+    {
+      unionType->Complete(value, output);
+      break;
+    }
+  }
+
+  for (const auto& extended : m_extends)
+    extended->Complete(value, output);
+
+  if (HasType(m_type, ArrayValue) && value.isArray())
+  {
+    if (m_items.empty())
+    {
+      output = value;
+      return;
+    }
+
+    output = CVariant(CVariant::VariantTypeArray);
+    for (unsigned int index = 0; index < value.size(); index++)
+    {
+      const CJSONSchemaValidator *item = nullptr;
+      if (m_items.size() == 1)
+        item = m_items.front();
+      else if (index < m_items.size())
+        item = m_items[index];
+      else
+      {
+        for (const auto& additional : m_additionalItems)
+        {
+          if (additional->Validate(value[index]))
+          {
+            item = additional;
+            break;
+          }
+        }
+      }
+
+      CVariant temp;
+      if (item != nullptr)
+        item->Complete(value[index], temp);
+      else
+        temp = value[index];
+      output.push_back(temp);
+    }
+    return;
+  }
+
+  if (HasType(m_type, ObjectValue) && value.isObject())
+  {
+    for (const auto& property : m_properties)
+    {
+      if (value.isMember(property.name))
+        property.validator->Complete(value[property.name], output[property.name]);
+      else
+        output[property.name] = property.defaultValue;
+    }
+
+    if (m_hasAdditionalProperties && value.size() > 0)
+    {
+      for (CVariant::const_iterator_map it = value.begin_map(); it != value.end_map(); ++it)
+      {
+        if (findProperty(it->first) != nullptr)
+          continue;
+
+        if (m_additionalProperties == nullptr)
+          output[it->first] = it->second;
+        else
+          m_additionalProperties->Complete(it->second, output[it->first]);
+      }
+    }
+    return;
+  }
+
+  output = value;
+}
+
+const CJSONSchemaValidator::Property* CJSONSchemaValidator::findProperty(const std::string &name) const
+{
+  auto it = std::lower_bound(m_properties.begin(), m_properties.end(), name,
+                             [](const Property &property, const std::string &key) { return property.name < key; });
+  if (it == m_properties.end() || it->name != name)
+    return nullptr;
+
+  return &(*it);
+}
+
+const CJSONSchemaValidator* CJSONSchemaCompiler::Compile(const JSONSchemaTypeDefinitionPtr &type)
+{
+  if (type == nullptr)
+    return nullptr;
+
+  auto compiled = m_compiled.find(type.get());
+  if (compiled != m_compiled.end())
+    return compiled->second;
+
+  // resolve the reference now instead of on the first check
+  if (type->referencedType != nullptr && !type->referencedTypeSet)
+    type->Set(type->referencedType);
+
+  // register the validator before compiling its children so recursive types end up here
+  m_validators.emplace_back(new CJSONSchemaValidator());
+  CJSONSchemaValidator *validator = m_validators.back().get();
+  m_compiled.insert(std::make_pair(type.get(), validator));
+
+  validator->m_type = type->type;
+
+  for (const auto& unionType : type->unionTypes)
+    validator->m_unionTypes.push_back(Compile(unionType));
+  for (const auto& extended : type->extends)
+    validator->m_extends.push_back(Compile(extended));
+
+  for (const auto& item : type->items)
+    validator->m_items.push_back(Compile(item));
+  for (const auto& item : type->additionalItems)
+    validator->m_additionalItems.push_back(Compile(item));
+  validator->m_minItems = type->minItems;
+  validator->m_maxItems = type->maxItems;
+  validator->m_uniqueItems = type->uniqueItems;
+
+  for (auto it = type->properties.begin(); it != type->properties.end(); ++it)
+  {
+    CJSONSchemaValidator::Property property;
+    property.name = it->second->name;
+    property.validator = Compile(it->second);
+    property.optional = it->second->optional;
+    property.defaultValue = it->second->defaultValue;
+    validator->m_properties.push_back(property);
+  }
+  std::sort(validator->m_properties.begin(), validator->m_properties.end(),
+            [](const CJSONSchemaValidator::Property &lhs, const CJSONSchemaValidator::Property &rhs) { return lhs.name < rhs.name; });
+
+  validator->m_hasAdditionalProperties = type->hasAdditionalProperties && type->additionalProperties != nullptr;
+  // additional properties of type "any" are copied without checking them
+  if (validator->m_hasAdditionalProperties && type->additionalProperties->type != AnyValue)
+    validator->m_additionalProperties = Compile(type->additionalProperties);
+
+  validator->m_enums = type->enums;
+  validator->m_checkRange = type->minimum != -std::numeric_limits<double>::max() || type->maximum != std::numeric_limits<double>::max() ||
+                            type->exclusiveMinimum || type->exclusiveMaximum;
+  validator->m_minimum = type->minimum;
+  validator->m_maximum = type->maximum;
+  validator->m_exclusiveMinimum = type->exclusiveMinimum;
+  validator->m_exclusiveMaximum = type->exclusiveMaximum;
+  validator->m_divisibleBy = type->divisibleBy;
+  validator->m_minLength = type->minLength;
+  validator->m_maxLength = type->maxLength;
+
+  validator->m_plain = validator->m_unionTypes.empty() && validator->m_extends.empty() && validator->m_items.empty() &&
+                       !HasType(validator->m_type, ObjectValue);
+
+  return validator;
+}
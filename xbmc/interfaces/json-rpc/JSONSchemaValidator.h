@@ -0,0 +1,124 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "JSONUtils.h"
+#include "utils/Variant.h"
+
+namespace JSONRPC
+{
+  class JSONSchemaTypeDefinition;
+
+  /*!
+   \ingroup jsonrpc
+   \brief Validator compiled from a parsed json schema type definition.
+
+   References and extended types are resolved at compile time, so validating
+   a value only follows pointers between validators. Validate() reads the
+   value without building output or error data. Complete() builds the output
+   value JSONSchemaTypeDefinition::Check() would have produced for a value
+   that passed Validate().
+   */
+  class CJSONSchemaValidator : protected CJSONUtils
+  {
+  public:
+    /*!
+     \brief Checks the given value against the compiled schema
+     \param value Value to check
+     \return True if the value matches the schema otherwise false
+     */
+    bool Validate(const CVariant &value) const;
+
+    /*!
+     \brief Builds the cleaned up value with all defaults of missing optional
+     properties filled in
+     \param value Value that passed Validate()
+     \param output Output value
+     */
+    void Complete(const CVariant &value, CVariant &output) const;
+
+  private:
+    friend class CJSONSchemaCompiler;
+
+    CJSONSchemaValidator() = default;
+
+    struct Property
+    {
+      std::string name;
+      const CJSONSchemaValidator *validator;
+      bool optional;
+      CVariant defaultValue;
+    };
+
+    const Property* findProperty(const std::string &name) const;
+    bool validateArray(const CVariant &value) const;
+    bool validateObject(const CVariant &value) const;
+    bool validateScalar(const CVariant &value) const;
+
+    JSONSchemaType m_type = AnyValue;
+    bool m_plain = false;  ///< output is a plain copy of the value
+    std::vector<const CJSONSchemaValidator*> m_unionTypes;
+    std::vector<const CJSONSchemaValidator*> m_extends;
+
+    std::vector<const CJSONSchemaValidator*> m_items;
+    std::vector<const CJSONSchemaValidator*> m_additionalItems;
+    unsigned int m_minItems = 0;
+    unsigned int m_maxItems = 0;
+    bool m_uniqueItems = false;
+
+    std::vector<Property> m_properties;  ///< sorted by name
+    bool m_hasAdditionalProperties = false;
+    const CJSONSchemaValidator *m_additionalProperties = nullptr;  ///< nullptr if any value is allowed
+
+    std::vector<CVariant> m_enums;
+    bool m_checkRange = false;
+    double m_minimum = 0.0;
+    double m_maximum = 0.0;
+    bool m_exclusiveMinimum = false;
+    bool m_exclusiveMaximum = false;
+    unsigned int m_divisibleBy = 0;
+    int m_minLength = -1;
+    int m_maxLength = -1;
+  };
+
+  /*!
+   \ingroup jsonrpc
+   \brief Compiles json schema type definitions into validators and owns them.
+
+   Every type definition is compiled once, so types referenced from several
+   places and recursive types share their validator.
+   */
+  class CJSONSchemaCompiler : protected CJSONUtils
+  {
+  public:
+    const CJSONSchemaValidator* Compile(const std::shared_ptr<JSONSchemaTypeDefinition> &type);
+    size_t Size() const { return m_validators.size(); }
+
+  private:
+    std::map<const JSONSchemaTypeDefinition*, CJSONSchemaValidator*> m_compiled;
+    std::vector<std::unique_ptr<CJSONSchemaValidator>> m_validators;
+  };
+}
@@ -20,6 +20,7 @@
 
 #include "ServiceDescription.h"
 #include "JSONServiceDescription.h"
+#include "JSONSchemaValidator.h"
 #include "utils/log.h"
 #include "utils/JSONVariantParser.h"
 #include "utils/StringUtils.h"
@@ -45,6 +46,7 @@ using namespace JSONRPC;
 
 std::map<std::string, CVariant> CJSONServiceDescription::m_notifications = std::map<std::string, CVariant>();
 CJSONServiceDescription::CJsonRpcMethodMap CJSONServiceDescription::m_actionMap;
+std::unique_ptr<CJSONSchemaCompiler> CJSONServiceDescription::m_compiler;
 std::map<std::string, JSONSchemaTypeDefinitionPtr> CJSONServiceDescription::m_types = std::map<std::string, JSONSchemaTypeDefinitionPtr>();
 CJSONServiceDescription::IncompleteSchemaDefinitionMap CJSONServiceDescription::m_incompleteDefinitions = CJSONServiceDescription::IncompleteSchemaDefinitionMap();
 
@@ -202,6 +204,10 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
   { "System.Suspend",                               CSystemOperations::Suspend },
   { "System.Hibernate",                             CSystemOperations::Hibernate },
   { "System.Reboot",                                CSystemOperations::Reboot },
+  { "System.GetStartupTimeline",                    CSystemOperations::GetStartupTimeline },
+  { "System.GetLockStatistics",                     CSystemOperations::GetLockStatistics },
+  { "System.SetFrameTracing",                       CSystemOperations::SetFrameTracing },
+  { "System.GetFrameTrace",                         CSystemOperations::GetFrameTrace },
 
 // Input operations
   { "Input.SendText",                               CInputOperations::SendText },
@@ -1228,7 +1234,9 @@ JsonRpcMethod::JsonRpcMethod()
     permission(ReadData),
     description(),
     parameters(),
-    returns(new JSONSchemaTypeDefinition())
+    returns(new JSONSchemaTypeDefinition()),
+    m_compiledParameters(),
+    m_compiled(false)
 { }
 
 bool JsonRpcMethod::Parse(const CVariant &value)
@@ -1307,6 +1315,11 @@ JSONRPC_STATUS JsonRpcMethod::Check(const CVariant &requestParameters, ITranspor
     {
       methodCall = method;
 
+      // The compiled validators don't build any error data, so only
+      // invalid calls need the full check below to report the error
+      if (m_compiled && checkCompiled(requestParameters, outputParameters))
+        return OK;
+
       // Count the number of actually handled (present)
       // parameters
       unsigned int handled = 0;
@@ -1406,8 +1419,78 @@ JSONRPC_STATUS JsonRpcMethod::checkParameter(const CVariant &requestParameters,
   return OK;
 }
 
+bool JsonRpcMethod::checkCompiled(const CVariant &requestParameters, CVariant &outputParameters) const
+{
+  std::vector<const CVariant*> values(parameters.size(), nullptr);
+  unsigned int handled = 0;
+
+  for (unsigned int i = 0; i < parameters.size(); i++)
+  {
+    const std::string &parameterName = parameters[i]->name;
+    if (requestParameters.isMember(parameterName))
+      values[i] = &requestParameters[parameterName];
+    else if (requestParameters.isArray() && requestParameters.size() > i)
+      values[i] = &requestParameters[i];
+
+    if (values[i] != nullptr)
+    {
+      if (!m_compiledParameters[i]->Validate(*values[i]))
+        return false;
+      handled++;
+    }
+    else if (!parameters[i]->optional)
+      return false;
+  }
+
+  if (handled < requestParameters.size())
+    return false;
+
+  for (unsigned int i = 0; i < parameters.size(); i++)
+  {
+    if (values[i] != nullptr)
+      m_compiledParameters[i]->Complete(*values[i], outputParameters[parameters[i]->name]);
+    else
+      outputParameters[parameters[i]->name] = parameters[i]->defaultValue;
+  }
+
+  return true;
+}
+
+void JsonRpcMethod::Compile(CJSONSchemaCompiler &compiler)
+{
+  m_compiledParameters.clear();
+  for (unsigned int i = 0; i < parameters.size(); i++)
+    m_compiledParameters.push_back(compiler.Compile(parameters[i]));
+
+  m_compiled = true;
+}
+
+void JsonRpcMethod::ClearCompiled()
+{
+  m_compiledParameters.clear();
+  m_compiled = false;
+}
+
+void CJSONServiceDescription::CompileValidators()
+{
+  ClearValidators();
+
+  m_compiler.reset(new CJSONSchemaCompiler());
+  m_actionMap.compile(*m_compiler);
+
+  CLog::Log(LOGDEBUG, "JSONRPC: Compiled %u schema validators", (unsigned int)m_compiler->Size());
+}
+
+void CJSONServiceDescription::ClearValidators()
+{
+  m_actionMap.clearCompiled();
+  m_compiler.reset();
+}
+
 void CJSONServiceDescription::Cleanup()
 {
+  ClearValidators();
+
   // reset all of the static data
   m_notifications.clear();
   m_actionMap.clear();
@@ -1895,6 +1978,12 @@ JSONRPC_STATUS CJSONServiceDescription::CheckCall(const char* const method, cons
   return MethodNotFound;
 }
 
+bool CJSONServiceDescription::IsReadOnly(const std::string &method)
+{
+  CJsonRpcMethodMap::JsonRpcMethodIterator iter = m_actionMap.find(method);
+  return iter != m_actionMap.end() && iter->second.permission == ReadData;
+}
+
 JSONSchemaTypeDefinitionPtr CJSONServiceDescription::GetType(const std::string &identification)
 {
   std::map<std::string, JSONSchemaTypeDefinitionPtr>::iterator iter = m_types.find(identification);
@@ -2056,6 +2145,18 @@ void CJSONServiceDescription::CJsonRpcMethodMap::add(const JsonRpcMethod &method
   m_actionmap[name] = method;
 }
 
+void CJSONServiceDescription::CJsonRpcMethodMap::compile(CJSONSchemaCompiler &compiler)
+{
+  for (auto& method : m_actionmap)
+    method.second.Compile(compiler);
+}
+
+void CJSONServiceDescription::CJsonRpcMethodMap::clearCompiled()
+{
+  for (auto& method : m_actionmap)
+    method.second.ClearCompiled();
+}
+
 CJSONServiceDescription::CJsonRpcMethodMap::JsonRpcMethodIterator CJSONServiceDescription::CJsonRpcMethodMap::begin() const
 {
   return m_actionmap.begin();
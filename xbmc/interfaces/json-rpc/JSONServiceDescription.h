@@ -29,6 +29,8 @@
 
 namespace JSONRPC
 {
+  class CJSONSchemaCompiler;
+  class CJSONSchemaValidator;
   class JSONSchemaTypeDefinition;
   typedef std::shared_ptr<JSONSchemaTypeDefinition> JSONSchemaTypeDefinitionPtr;
 
@@ -240,6 +242,13 @@ namespace JSONRPC
   
     bool Parse(const CVariant &value);
     JSONRPC_STATUS Check(const CVariant &requestParameters, ITransportLayer *transport, IClient *client, bool notification, MethodCall &methodCall, CVariant &outputParameters) const;
+
+    /*!
+     \brief Compiles the parameter definitions into validators which
+     are used by Check from then on
+     */
+    void Compile(CJSONSchemaCompiler &compiler);
+    void ClearCompiled();
     
     std::string missingReference;    
     
@@ -279,6 +288,13 @@ namespace JSONRPC
     bool parseParameter(const CVariant &value, JSONSchemaTypeDefinitionPtr parameter);
     bool parseReturn(const CVariant &value);
     static JSONRPC_STATUS checkParameter(const CVariant &requestParameters, JSONSchemaTypeDefinitionPtr type, unsigned int position, CVariant &outputParameters, unsigned int &handled, CVariant &errorData);
+    bool checkCompiled(const CVariant &requestParameters, CVariant &outputParameters) const;
+
+    /*!
+     \brief Compiled validators of the parameters, empty if not compiled
+     */
+    std::vector<const CJSONSchemaValidator*> m_compiledParameters;
+    bool m_compiled;
   };
 
   /*! 
@@ -390,9 +406,31 @@ namespace JSONRPC
      given parameters from the request against the json schema description for the given method.
      */
     static JSONRPC_STATUS CheckCall(const char* method, const CVariant &requestParameters, ITransportLayer *transport, IClient *client, bool notification, MethodCall &methodCall, CVariant &outputParameters);
+
+    /*!
+     \brief Checks whether the given method only reads data
+     \param method Name of the method in lower case
+     \return True if the method exists and only needs the ReadData permission
+     */
+    static bool IsReadOnly(const std::string &method);
     
     static JSONSchemaTypeDefinitionPtr GetType(const std::string &identification);
 
+    /*!
+     \brief Compiles the parameter definitions of all methods into
+     validators so CheckCall doesn't have to walk the schema tree
+
+     Must be called after all types and methods have been added and
+     before any calls are checked.
+     */
+    static void CompileValidators();
+
+    /*!
+     \brief Drops the compiled validators, CheckCall falls back to
+     checking against the schema tree
+     */
+    static void ClearValidators();
+
     static void Cleanup();
 
   private:
@@ -411,6 +449,8 @@ namespace JSONRPC
       CJsonRpcMethodMap();
 
       void add(const JsonRpcMethod &method);
+      void compile(CJSONSchemaCompiler &compiler);
+      void clearCompiled();
 
       typedef std::map<std::string, JsonRpcMethod>::const_iterator JsonRpcMethodIterator;
       JsonRpcMethodIterator begin() const;
@@ -423,6 +463,7 @@ namespace JSONRPC
     };
 
     static CJsonRpcMethodMap m_actionMap;
+    static std::unique_ptr<CJSONSchemaCompiler> m_compiler;
     static std::map<std::string, JSONSchemaTypeDefinitionPtr> m_types;
     static std::map<std::string, CVariant> m_notifications;
     static JsonRpcMethodMap m_methodMaps[];
@@ -202,27 +202,26 @@ JSONRPC_STATUS CPlayerOperations::GetItem(const std::string &method, ITransportL
         if ((additionalInfo) &&
             videodatabase.Open())
         {
-          if (additionalInfo)
+          // only join the details that were asked for
+          CVideoInfoTag *tag = fileItem->GetVideoInfoTag();
+          switch (fileItem->GetVideoContentType())
           {
-            switch (fileItem->GetVideoContentType())
-            {
-              case VIDEODB_CONTENT_MOVIES:
-                videodatabase.GetMovieInfo("", *(fileItem->GetVideoInfoTag()), fileItem->GetVideoInfoTag()->m_iDbId);
-                break;
-
-              case VIDEODB_CONTENT_MUSICVIDEOS:
-                videodatabase.GetMusicVideoInfo("", *(fileItem->GetVideoInfoTag()), fileItem->GetVideoInfoTag()->m_iDbId);
-                break;
-
-              case VIDEODB_CONTENT_EPISODES:
-                videodatabase.GetEpisodeInfo("", *(fileItem->GetVideoInfoTag()), fileItem->GetVideoInfoTag()->m_iDbId);
-                break;
-
-              case VIDEODB_CONTENT_TVSHOWS:
-              case VIDEODB_CONTENT_MOVIE_SETS:
-              default:
-                break;
-            }
+            case VIDEODB_CONTENT_MOVIES:
+              videodatabase.GetMovieInfo("", *tag, tag->m_iDbId, CVideoLibrary::RequiresAdditionalDetails(MediaTypeMovie, parameterObject));
+              break;
+
+            case VIDEODB_CONTENT_MUSICVIDEOS:
+              videodatabase.GetMusicVideoInfo("", *tag, tag->m_iDbId, CVideoLibrary::RequiresAdditionalDetails(MediaTypeMusicVideo, parameterObject));
+              break;
+
+            case VIDEODB_CONTENT_EPISODES:
+              videodatabase.GetEpisodeInfo("", *tag, tag->m_iDbId, CVideoLibrary::RequiresAdditionalDetails(MediaTypeEpisode, parameterObject));
+              break;
+
+            case VIDEODB_CONTENT_TVSHOWS:
+            case VIDEODB_CONTENT_MOVIE_SETS:
+            default:
+              break;
           }
 
           videodatabase.Close();
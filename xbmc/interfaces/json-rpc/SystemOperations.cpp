@@ -24,6 +24,9 @@
 #include "utils/Variant.h"
 #include "powermanagement/PowerManager.h"
 #include "ServiceBroker.h"
+#include "ServiceInitScheduler.h"
+#include "threads/LockProfiler.h"
+#include "utils/FrameTrace.h"
 
 using namespace JSONRPC;
 using namespace KODI::MESSAGING;
@@ -96,6 +99,61 @@ JSONRPC_STATUS CSystemOperations::Reboot(const std::string &method, ITransportLa
     return FailedToExecute;
 }
 
+JSONRPC_STATUS CSystemOperations::GetStartupTimeline(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  result["services"] = CVariant(CVariant::VariantTypeArray);
+  for (const auto &record : CServiceInitScheduler::GetTimeline())
+  {
+    CVariant service(CVariant::VariantTypeObject);
+    service["name"] = record.name;
+    service["stage"] = record.stage;
+    service["start"] = record.start / 1000.0;
+    service["end"] = record.end / 1000.0;
+    service["worker"] = record.worker;
+    service["success"] = record.success;
+    result["services"].push_back(service);
+  }
+
+  return OK;
+}
+
+JSONRPC_STATUS CSystemOperations::GetLockStatistics(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  result["enabled"] = CLockProfiler::IsEnabled();
+  result["locks"] = CVariant(CVariant::VariantTypeArray);
+  for (const auto &statistics : CLockProfiler::GetStatistics())
+  {
+    CVariant lock(CVariant::VariantTypeObject);
+    lock["name"] = statistics.name;
+    lock["contentions"] = statistics.contentions;
+    lock["waittime"] = statistics.waitTime / 1000.0;
+    lock["maxwaittime"] = statistics.maxWaitTime / 1000.0;
+    lock["holders"] = CVariant(CVariant::VariantTypeArray);
+    for (const auto &holder : statistics.holders)
+    {
+      CVariant holderObj(CVariant::VariantTypeObject);
+      holderObj["name"] = holder.first;
+      holderObj["contentions"] = holder.second;
+      lock["holders"].push_back(holderObj);
+    }
+    result["locks"].push_back(lock);
+  }
+
+  return OK;
+}
+
+JSONRPC_STATUS CSystemOperations::SetFrameTracing(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  CFrameTrace::SetEnabled(parameterObject["enabled"].asBoolean());
+  return ACK;
+}
+
+JSONRPC_STATUS CSystemOperations::GetFrameTrace(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  CFrameTrace::Export(result);
+  return OK;
+}
+
 JSONRPC_STATUS CSystemOperations::GetPropertyValue(int permissions, const std::string &property, CVariant &result)
 {
   if (property == "canshutdown")
@@ -0,0 +1,135 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "interfaces/IAnnouncer.h"
+#include "interfaces/json-rpc/JSONRPC.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+using namespace ANNOUNCEMENT;
+using namespace JSONRPC;
+
+namespace
+{
+
+class CTestTransport : public ITransportLayer
+{
+public:
+  bool PrepareDownload(const char *path, CVariant &details, std::string &protocol) override { return false; }
+  bool Download(const char *path, CVariant &result) override { return false; }
+  int GetCapabilities() override { return Response | Announcing; }
+};
+
+class CTestClient : public IClient
+{
+public:
+  int GetPermissionFlags() override { return OPERATION_PERMISSION_ALL; }
+  int GetAnnouncementFlags() override { return m_flags; }
+  bool SetAnnouncementFlags(int flags) override { m_flags = flags; return true; }
+
+private:
+  int m_flags = ANNOUNCE_ALL;
+};
+
+class TestJSONRPC : public testing::Test
+{
+protected:
+  static void SetUpTestCase() { CJSONRPC::Initialize(); }
+  static void TearDownTestCase() { CJSONRPC::Cleanup(); }
+
+  CVariant Call(const std::string &request)
+  {
+    CVariant response;
+    EXPECT_TRUE(CJSONVariantParser::Parse(CJSONRPC::MethodCall(request, &m_transport, &m_client), response));
+    return response;
+  }
+
+  CTestTransport m_transport;
+  CTestClient m_client;
+};
+
+}
+
+TEST_F(TestJSONRPC, ReadOnlyBatchKeepsOrder)
+{
+  CVariant responses = Call(
+    "["
+    "{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Ping\", \"id\": 1 },"
+    "{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Version\", \"id\": 2 },"
+    "{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Ping\" },"
+    "{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Permission\", \"id\": 3 },"
+    "{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.GetConfiguration\", \"id\": 4 },"
+    "{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Ping\", \"id\": 5 },"
+    "{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.NoSuchMethod\", \"id\": 6 }"
+    "]");
+
+  // the notification doesn't get a response
+  ASSERT_TRUE(responses.isArray());
+  ASSERT_EQ(6u, responses.size());
+  for (unsigned int i = 0; i < responses.size(); i++)
+    EXPECT_EQ(i + 1, responses[i]["id"].asUnsignedInteger());
+
+  EXPECT_EQ("pong", responses[0]["result"].asString());
+  EXPECT_TRUE(responses[1]["result"].isMember("version"));
+  EXPECT_TRUE(responses[5].isMember("error"));
+}
+
+TEST_F(TestJSONRPC, MutatingCallSplitsBatch)
+{
+  CVariant responses = Call(
+    "["
+    "{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.GetConfiguration\", \"id\": 1 },"
+    "{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Ping\", \"id\": 2 },"
+    "{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.SetConfiguration\", \"params\": { \"notifications\": { \"Player\": false } }, \"id\": 3 },"
+    "{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.GetConfiguration\", \"id\": 4 },"
+    "{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Ping\", \"id\": 5 }"
+    "]");
+
+  ASSERT_TRUE(responses.isArray());
+  ASSERT_EQ(5u, responses.size());
+
+  // calls behind the mutating one see its effect, calls in front of it don't
+  EXPECT_TRUE(responses[0]["result"]["notifications"]["Player"].asBoolean());
+  EXPECT_FALSE(responses[3]["result"]["notifications"]["Player"].asBoolean());
+}
+
+TEST_F(TestJSONRPC, NoLibraryETagForSharedDatabase)
+{
+  const std::string request = "{ \"jsonrpc\": \"2.0\", \"method\": \"VideoLibrary.GetGenres\", \"params\": { \"type\": \"movie\" }, \"id\": 1 }";
+  std::string etag;
+  ASSERT_TRUE(CJSONRPC::GetLibraryETag(request, etag));
+  EXPECT_FALSE(etag.empty());
+
+  // other instances change a MySQL library without this one noticing
+  const std::string videoType = g_advancedSettings.m_databaseVideo.type;
+  g_advancedSettings.m_databaseVideo.type = "mysql";
+  EXPECT_FALSE(CJSONRPC::GetLibraryETag(request, etag));
+  g_advancedSettings.m_databaseVideo.type = videoType;
+
+  const std::string musicType = g_advancedSettings.m_databaseMusic.type;
+  g_advancedSettings.m_databaseMusic.type = "mysql";
+  EXPECT_FALSE(CJSONRPC::GetLibraryETag(request, etag));
+  g_advancedSettings.m_databaseMusic.type = musicType;
+}
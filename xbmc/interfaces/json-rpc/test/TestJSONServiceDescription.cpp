@@ -0,0 +1,171 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "interfaces/json-rpc/JSONRPC.h"
+#include "interfaces/json-rpc/JSONServiceDescription.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace JSONRPC;
+
+namespace
+{
+
+class CTestTransport : public ITransportLayer
+{
+public:
+  bool PrepareDownload(const char *path, CVariant &details, std::string &protocol) override { return false; }
+  bool Download(const char *path, CVariant &result) override { return false; }
+  int GetCapabilities() override { return Response | Announcing; }
+};
+
+class CTestClient : public IClient
+{
+public:
+  int GetPermissionFlags() override { return OPERATION_PERMISSION_ALL; }
+  int GetAnnouncementFlags() override { return 0; }
+  bool SetAnnouncementFlags(int flags) override { return false; }
+};
+
+struct TestCall
+{
+  const char *method;
+  const char *params;
+};
+
+// the calls remote apps issue most often
+const TestCall CommonCalls[] =
+{
+  { "JSONRPC.Ping", "{}" },
+  { "Player.GetActivePlayers", "{}" },
+  { "Player.GetProperties", "{ \"playerid\": 1, \"properties\": [ \"time\", \"totaltime\", \"percentage\", \"speed\", \"position\", \"playlistid\" ] }" },
+  { "Player.GetItem", "{ \"playerid\": 1, \"properties\": [ \"title\", \"artist\", \"album\", \"thumbnail\", \"file\" ] }" },
+  { "Application.GetProperties", "{ \"properties\": [ \"volume\", \"muted\" ] }" },
+  { "GUI.GetProperties", "{ \"properties\": [ \"currentwindow\" ] }" },
+  { "Input.ExecuteAction", "{ \"action\": \"select\" }" },
+  { "VideoLibrary.GetMovies", "{ \"properties\": [ \"title\", \"year\", \"rating\", \"thumbnail\" ], \"limits\": { \"start\": 0, \"end\": 50 }, \"sort\": { \"method\": \"title\" } }" },
+  { "VideoLibrary.GetMovies", "{ \"filter\": { \"field\": \"year\", \"operator\": \"greaterthan\", \"value\": \"2000\" } }" },
+  { "AudioLibrary.GetAlbums", "[ [ \"title\", \"artist\", \"year\" ], { \"start\": 0, \"end\": 100 } ]" },
+};
+
+class TestJSONServiceDescription : public testing::Test
+{
+protected:
+  static void SetUpTestCase() { CJSONRPC::Initialize(); }
+  static void TearDownTestCase() { CJSONRPC::Cleanup(); }
+
+  JSONRPC_STATUS Check(const TestCall &call, CVariant &output)
+  {
+    CVariant params;
+    EXPECT_TRUE(CJSONVariantParser::Parse(call.params, params));
+
+    std::string method = call.method;
+    StringUtils::ToLower(method);
+
+    MethodCall methodCall = nullptr;
+    return CJSONServiceDescription::CheckCall(method.c_str(), params, &m_transport, &m_client, false, methodCall, output);
+  }
+
+  // average time of a check in nanoseconds
+  long long Measure(const TestCall &call, int iterations)
+  {
+    CVariant params;
+    CJSONVariantParser::Parse(call.params, params);
+    std::string method = call.method;
+    StringUtils::ToLower(method);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+      CVariant output;
+      MethodCall methodCall = nullptr;
+      CJSONServiceDescription::CheckCall(method.c_str(), params, &m_transport, &m_client, false, methodCall, output);
+    }
+    auto duration = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / iterations;
+  }
+
+  CTestTransport m_transport;
+  CTestClient m_client;
+};
+
+}
+
+TEST_F(TestJSONServiceDescription, CompiledMatchesSchema)
+{
+  for (const auto& call : CommonCalls)
+  {
+    CVariant compiled;
+    EXPECT_EQ(OK, Check(call, compiled)) << call.method;
+
+    CJSONServiceDescription::ClearValidators();
+    CVariant schema;
+    EXPECT_EQ(OK, Check(call, schema)) << call.method;
+    CJSONServiceDescription::CompileValidators();
+
+    EXPECT_TRUE(compiled == schema) << call.method;
+  }
+}
+
+TEST_F(TestJSONServiceDescription, InvalidParameters)
+{
+  const TestCall invalidCalls[] =
+  {
+    { "Player.GetProperties", "{ \"playerid\": 1, \"properties\": [ \"time\", \"time\" ] }" },
+    { "Player.GetProperties", "{ \"playerid\": 1, \"properties\": [ \"nosuchproperty\" ] }" },
+    { "Player.GetProperties", "{ \"properties\": [ \"time\" ] }" },
+    { "Application.GetProperties", "{ \"properties\": [ \"volume\" ], \"unknown\": true }" },
+    { "VideoLibrary.GetMovies", "{ \"limits\": { \"start\": -1 } }" },
+    { "VideoLibrary.GetMovies", "{ \"filter\": { \"field\": \"nosuchfield\", \"operator\": \"is\", \"value\": \"\" } }" },
+  };
+
+  for (const auto& call : invalidCalls)
+  {
+    // errors are still reported with the full error data
+    CVariant output;
+    EXPECT_EQ(InvalidParams, Check(call, output)) << call.params;
+    EXPECT_FALSE(output["method"].asString().empty()) << call.params;
+  }
+}
+
+// reports the validation time per call, run with --gtest_also_run_disabled_tests
+TEST_F(TestJSONServiceDescription, DISABLED_Benchmark)
+{
+  static const int iterations = 1000;
+
+  for (const auto& call : CommonCalls)
+  {
+    long long compiledNs = Measure(call, iterations);
+
+    CJSONServiceDescription::ClearValidators();
+    long long schemaNs = Measure(call, iterations);
+    CJSONServiceDescription::CompileValidators();
+
+    RecordProperty(std::string(call.method) + ".SchemaNs", std::to_string(schemaNs));
+    RecordProperty(std::string(call.method) + ".CompiledNs", std::to_string(compiledNs));
+  }
+}
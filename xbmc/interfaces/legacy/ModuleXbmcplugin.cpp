@@ -63,10 +63,10 @@ namespace XBMCAddon
     }
 
     void endOfDirectory(int handle, bool succeeded, bool updateListing, 
-                        bool cacheToDisc)
+                        bool cacheToDisc, int cacheTime, int staleTime)
     {
       // tell the directory class that we're done
-      XFILE::CPluginDirectory::EndOfDirectory(handle, succeeded, updateListing, cacheToDisc);
+      XFILE::CPluginDirectory::EndOfDirectory(handle, succeeded, updateListing, cacheToDisc, cacheTime, staleTime);
     }
 
     void setResolvedUrl(int handle, bool succeeded, const xbmcgui::ListItem* listItem)
@@ -119,7 +119,7 @@ namespace XBMCAddon
 #ifdef DOXYGEN_SHOULD_USE_THIS
     ///
     /// \ingroup python_xbmcplugin
-    /// @brief \python_func{ xbmcplugin.endOfDirectory(handle[, succeeded, updateListing, cacheToDisc]) }
+    /// @brief \python_func{ xbmcplugin.endOfDirectory(handle[, succeeded, updateListing, cacheToDisc, cacheTime, staleTime]) }
     ///-------------------------------------------------------------------------
     /// Callback function to tell Kodi that the end of the directory listing in
     /// a virtualPythonFolder module is reached.
@@ -134,21 +134,35 @@ namespace XBMCAddon
     /// @param cacheToDisc          [opt] bool - True=Folder will cache if
     ///                             extended time(default)/False=this folder
     ///                             will never cache to disc.
+    /// @param cacheTime            [opt] integer - seconds Kodi may show this
+    ///                             listing again without running the plugin.
+    ///                             0 (default) never reuses the listing, at
+    ///                             most one day. Container.Refresh always
+    ///                             runs the plugin.
+    /// @param staleTime            [opt] integer - seconds after cacheTime
+    ///                             expired during which the old listing is
+    ///                             shown right away while the plugin is run
+    ///                             in the background to refresh it, at most
+    ///                             one day.
     ///
     ///
     /// ------------------------------------------------------------------------
+    /// @python_v18 **cacheTime** and **staleTime** options added.
     ///
     /// **Example:**
     /// ~~~~~~~~~~~~~{.py}
     /// ..
     /// xbmcplugin.endOfDirectory(int(sys.argv[1]), cacheToDisc=False)
+    /// # show this listing for five minutes without running the plugin, and
+    /// # for an hour after that while refreshing it in the background
+    /// xbmcplugin.endOfDirectory(int(sys.argv[1]), cacheTime=300, staleTime=3600)
     /// ..
     /// ~~~~~~~~~~~~~
     ///
     endOfDirectory(...);
 #else
     void endOfDirectory(int handle, bool succeeded = true, bool updateListing = false,
-                        bool cacheToDisc = true);
+                        bool cacheToDisc = true, int cacheTime = 0, int staleTime = 0);
 #endif
 
 #ifdef DOXYGEN_SHOULD_USE_THIS
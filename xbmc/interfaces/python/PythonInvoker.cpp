@@ -20,6 +20,7 @@
 
 // python.h should always be included first before any other includes
 #include <Python.h>
+#include <algorithm>
 #include <iterator>
 #include <osdefs.h>
 
@@ -42,6 +43,7 @@
 #include "interfaces/python/swig.h"
 #include "interfaces/python/XBPython.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #if defined(TARGET_WINDOWS)
 #include "utils/CharsetConverter.h"
 #endif // defined(TARGET_WINDOWS)
@@ -67,6 +69,9 @@ extern "C" FILE *fopen_utf8(const char *_Filename, const char *_Mode);
 // Time before ill-behaved scripts are terminated
 #define PYTHON_SCRIPT_TIMEOUT 5000 // ms
 
+// Maximum number of warm interpreters kept for plugins that opted in
+#define PYTHON_INTERPRETER_POOL_SIZE 4
+
 using namespace XFILE;
 using namespace KODI::MESSAGING;
 
@@ -79,6 +84,8 @@ extern "C"
 #define PythonModulesSize sizeof(PythonModules) / sizeof(PythonModule)
 
 CCriticalSection CPythonInvoker::s_critical;
+std::vector<CPythonInvoker::PooledInterpreter> CPythonInvoker::s_interpreterPool;
+CCriticalSection CPythonInvoker::s_poolCritical;
 
 static const std::string getListOfAddonClassesAsString(XBMCAddon::AddonClass::Ref<XBMCAddon::Python::PythonLanguageHook>& languageHook)
 {
@@ -168,12 +175,19 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
 
   CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): start processing", GetId(), m_sourceFile.c_str());
 
+  bool reusable = isInterpreterReusable();
+
   // get the global lock
   PyEval_AcquireLock();
-  PyThreadState* state = Py_NewInterpreter();
+  // a warm interpreter still has all modules imported by earlier invocations.
+  // It keeps the thread state it was created with, we run in one of our own.
+  PyThreadState* pooledState = reusable ? static_cast<PyThreadState*>(acquirePooledInterpreter()) : NULL;
+  PyThreadState* state = pooledState != NULL ? PyThreadState_New(pooledState->interp) : Py_NewInterpreter();
   if (state == NULL)
   {
     PyEval_ReleaseLock();
+    if (pooledState != NULL)
+      endInterpreter(pooledState);
     CLog::Log(LOGERROR, "CPythonInvoker(%d, %s): FAILED to get thread state!", GetId(), m_sourceFile.c_str());
     return false;
   }
@@ -183,7 +197,14 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
   XBMCAddon::AddonClass::Ref<XBMCAddon::Python::PythonLanguageHook> languageHook(new XBMCAddon::Python::PythonLanguageHook(state->interp));
   languageHook->RegisterMe();
 
-  onInitialization();
+  if (pooledState != NULL)
+  {
+    CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): reusing warm interpreter", GetId(), m_sourceFile.c_str());
+    resetMainModule();
+    runInitializationScript();
+  }
+  else
+    onInitialization();
   setState(InvokerStateInitialized);
 
   std::string realFilename(CSpecialProtocol::TranslatePath(m_sourceFile));
@@ -376,7 +397,7 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
   // make sure all sub threads have finished
   for (PyThreadState* s = state->interp->tstate_head, *old = NULL; s;)
   {
-    if (s == state)
+    if (s == state || s == pooledState)
     {
       s = s->next;
       continue;
@@ -415,6 +436,33 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
 
   onDeinitialization();
 
+  // keep the interpreter for the next invocation if the script ended normally
+  if (reusable && stateToSet == InvokerStateDone && !m_stop)
+  {
+    // drop everything the script left in __main__ before collecting
+    resetMainModule();
+    PyGC_Collect();
+
+    if (pooledState != NULL)
+    {
+      PyThreadState_Clear(state);
+      PyThreadState_DeleteCurrent(); // releases the GIL
+      PyEval_AcquireLock();
+    }
+    else
+    {
+      pooledState = state;
+      PyThreadState_Swap(NULL);
+    }
+
+    languageHook->UnregisterMe();
+    PyEval_ReleaseLock();
+
+    releaseToPool(pooledState);
+    setState(stateToSet);
+    return true;
+  }
+
   // run the gc before finishing
   //
   // if the script exited by throwing a SystemExit exception then going back
@@ -426,6 +474,15 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
       PyRun_SimpleString(GC_SCRIPT) == -1)
     CLog::Log(LOGERROR, "CPythonInvoker(%d, %s): failed to run the gc to clean up after running prior to shutting down the Interpreter", GetId(), m_sourceFile.c_str());
 
+  if (pooledState != NULL)
+  {
+    // the warm interpreter is not reused after a failure, end it with its own thread state
+    PyThreadState_Clear(state);
+    PyThreadState_DeleteCurrent(); // releases the GIL
+    PyEval_AcquireLock();
+    PyThreadState_Swap(pooledState);
+    state = pooledState;
+  }
   Py_EndInterpreter(state);
 
   // If we still have objects left around, produce an error message detailing what's been left behind
@@ -565,6 +622,11 @@ void CPythonInvoker::onInitialization()
     initializeModules(getModules());
   }
 
+  runInitializationScript();
+}
+
+void CPythonInvoker::runInitializationScript()
+{
   // get a possible initialization script
   const char* runscript = getInitializationScript();
   if (runscript!= NULL && strlen(runscript) > 0)
@@ -685,8 +747,128 @@ void CPythonInvoker::addNativePath(const std::string& path)
   if (path.empty())
     return;
 
+  // sys.path of a warm interpreter already contains the add-on's paths
+  std::vector<std::string> paths = StringUtils::Split(m_pythonPath, PY_PATH_SEP);
+  if (std::find(paths.begin(), paths.end(), path) != paths.end())
+    return;
+
   if (!m_pythonPath.empty())
     m_pythonPath += PY_PATH_SEP;
 
   m_pythonPath += path;
 }
+
+bool CPythonInvoker::isInterpreterReusable() const
+{
+  // plugins opt in through <reuselanguageinvoker>true</reuselanguageinvoker>
+  // in their xbmc.python.pluginsource extension
+  if (m_addon == NULL || m_addon->Type() != ADDON::ADDON_PLUGIN)
+    return false;
+
+  const auto& extraInfo = m_addon->ExtraInfo();
+  auto reuse = extraInfo.find("reuselanguageinvoker");
+  return reuse != extraInfo.end() && reuse->second == "true";
+}
+
+std::string CPythonInvoker::getInterpreterKey() const
+{
+  // an updated add-on or another script of it gets a fresh interpreter
+  return m_addon->ID() + "|" + m_addon->Version().asString() + "|" + m_sourceFile;
+}
+
+void *CPythonInvoker::acquirePooledInterpreter()
+{
+  std::string key = getInterpreterKey();
+
+  CSingleLock lock(s_poolCritical);
+  for (auto it = s_interpreterPool.begin(); it != s_interpreterPool.end(); ++it)
+  {
+    if (it->key == key)
+    {
+      void *threadState = it->threadState;
+      s_interpreterPool.erase(it);
+      return threadState;
+    }
+  }
+  return NULL;
+}
+
+void CPythonInvoker::releaseToPool(void *threadState)
+{
+  PooledInterpreter interpreter = { getInterpreterKey(), threadState, XbmcThreads::SystemClockMillis() };
+  void *evicted = NULL;
+  {
+    CSingleLock lock(s_poolCritical);
+    // keep one interpreter per plugin, concurrent invocations end theirs
+    for (const auto& pooled : s_interpreterPool)
+    {
+      if (pooled.key == interpreter.key)
+      {
+        evicted = threadState;
+        break;
+      }
+    }
+
+    if (evicted == NULL)
+    {
+      if (s_interpreterPool.size() >= PYTHON_INTERPRETER_POOL_SIZE)
+      {
+        auto oldest = std::min_element(s_interpreterPool.begin(), s_interpreterPool.end(),
+          [](const PooledInterpreter& a, const PooledInterpreter& b) { return a.lastUsed < b.lastUsed; });
+        evicted = oldest->threadState;
+        s_interpreterPool.erase(oldest);
+      }
+      s_interpreterPool.push_back(interpreter);
+      CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): keeping interpreter for the next invocation", GetId(), m_sourceFile.c_str());
+    }
+  }
+
+  if (evicted != NULL)
+    endInterpreter(evicted);
+}
+
+void CPythonInvoker::endInterpreter(void *threadState)
+{
+  PyEval_AcquireLock();
+  PyThreadState_Swap(static_cast<PyThreadState*>(threadState));
+  Py_EndInterpreter(static_cast<PyThreadState*>(threadState));
+  PyEval_ReleaseLock();
+}
+
+void CPythonInvoker::ReleasePooledInterpreters(unsigned int idleMs /* = 0 */)
+{
+  std::vector<void*> expired;
+  {
+    CSingleLock lock(s_poolCritical);
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    for (auto it = s_interpreterPool.begin(); it != s_interpreterPool.end();)
+    {
+      if (idleMs == 0 || now - it->lastUsed >= idleMs)
+      {
+        expired.push_back(it->threadState);
+        it = s_interpreterPool.erase(it);
+      }
+      else
+        ++it;
+    }
+  }
+
+  for (auto threadState : expired)
+    endInterpreter(threadState);
+}
+
+bool CPythonInvoker::HasPooledInterpreters()
+{
+  CSingleLock lock(s_poolCritical);
+  return !s_interpreterPool.empty();
+}
+
+void CPythonInvoker::resetMainModule()
+{
+  PyObject* moduleDict = PyModule_GetDict(PyImport_AddModule((char*)"__main__"));
+  PyDict_Clear(moduleDict);
+  PyDict_SetItemString(moduleDict, "__builtins__", PyEval_GetBuiltins());
+  PyObject* name = PyString_FromString("__main__");
+  PyDict_SetItemString(moduleDict, "__name__", name);
+  Py_DECREF(name);
+}
@@ -38,6 +38,15 @@ public:
   bool IsStopping() const override { return m_stop || ILanguageInvoker::IsStopping(); }
 
   typedef void (*PythonModuleInitialization)();
+
+  /*!
+   \brief End warm interpreters that have not been used for the given time.
+
+   \param idleMs Minimum idle time in milliseconds, 0 ends all of them
+   \note Must not be called while holding the GIL
+   */
+  static void ReleasePooledInterpreters(unsigned int idleMs = 0);
+  static bool HasPooledInterpreters();
   
 protected:
   // implementation of ILanguageInvoker
@@ -62,6 +71,27 @@ protected:
   CCriticalSection m_critical;
 
 private:
+  friend class TestPythonInvokerHelper;
+
+  /*!
+   \brief A warm sub-interpreter kept for the next invocation of the same
+   plugin. Only the thread state the interpreter was created with is kept,
+   every invocation runs in a thread state of its own.
+   */
+  struct PooledInterpreter
+  {
+    std::string key;
+    void *threadState; // actually a PyThreadState*
+    unsigned int lastUsed;
+  };
+
+  bool isInterpreterReusable() const;
+  std::string getInterpreterKey() const;
+  void *acquirePooledInterpreter();
+  void releaseToPool(void *threadState);
+  static void endInterpreter(void *threadState);
+  void resetMainModule();
+  void runInitializationScript();
   void initializeModules(const std::map<std::string, PythonModuleInitialization> &modules);
   bool initializeModule(PythonModuleInitialization module);
   void addPath(const std::string& path); // add path in UTF-8 encoding
@@ -74,4 +104,6 @@ private:
   CEvent m_stoppedEvent;
 
   static CCriticalSection s_critical;
+  static std::vector<PooledInterpreter> s_interpreterPool;
+  static CCriticalSection s_poolCritical;
 };
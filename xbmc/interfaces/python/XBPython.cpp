@@ -78,6 +78,9 @@ XBPython::~XBPython()
 #define CHECK_FOR_ENTRY(l,v) \
   (l.hadSomethingRemoved ? (std::find(l.begin(),l.end(),v) != l.end()) : true)
 
+// Time after which warm interpreters of plugins that weren't used are ended
+#define PYTHON_INTERPRETER_IDLE_TIMEOUT 300000 // ms
+
 void XBPython::Announce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
 {
   if (flag & VideoLibrary)
@@ -495,6 +498,9 @@ void XBPython::Finalize()
     m_mainThreadState = NULL; // clear the main thread state before releasing the lock
     {
       CSingleExit exit(m_critSection);
+      // warm interpreters have to go before the main interpreter
+      CPythonInvoker::ReleasePooledInterpreters();
+
       PyEval_AcquireLock();
       PyThreadState_Swap(curTs);
 
@@ -558,8 +564,12 @@ void XBPython::Process()
     //delete scripts which are done
     tmpvec.clear(); // boost releases the XBPyThreads which, if deleted, calls OnScriptFinalized
 
+    // warm interpreters of plugins keep python loaded until they expire
+    CPythonInvoker::ReleasePooledInterpreters(PYTHON_INTERPRETER_IDLE_TIMEOUT);
+
     CSingleLock l2(m_critSection);
-    if(m_iDllScriptCounter == 0 && (XbmcThreads::SystemClockMillis() - m_endtime) > 10000 )
+    if(m_iDllScriptCounter == 0 && (XbmcThreads::SystemClockMillis() - m_endtime) > 10000 &&
+       !CPythonInvoker::HasPooledInterpreters())
     {
       Finalize();
     }
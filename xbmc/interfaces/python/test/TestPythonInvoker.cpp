@@ -0,0 +1,174 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "addons/AddonBuilder.h"
+#include "interfaces/python/AddonPythonInvoker.h"
+#include "interfaces/python/XBPython.h"
+#include "threads/SingleLock.h"
+#include "utils/URIUtils.h"
+#include "test/TestUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+ADDON::AddonPtr CreateDummyPlugin(bool reuseLanguageInvoker)
+{
+  ADDON::CAddonBuilder builder;
+  builder.SetId("plugin.test.dummy");
+  builder.SetType(ADDON::ADDON_PLUGIN);
+  builder.SetVersion(ADDON::AddonVersion("1.0.0"));
+  builder.SetPath(URIUtils::GetDirectory(XBMC_REF_FILE_PATH("xbmc/interfaces/python/test/testdata/plugin.test.dummy/addon.xml")));
+  if (reuseLanguageInvoker)
+  {
+    ADDON::InfoMap extraInfo;
+    extraInfo.insert(std::make_pair("reuselanguageinvoker", "true"));
+    builder.SetExtrainfo(std::move(extraInfo));
+  }
+  return builder.Build();
+}
+
+bool RunListing(XBPython& python, const ADDON::AddonPtr& addon, const std::string& query)
+{
+  const std::string script = XBMC_REF_FILE_PATH("xbmc/interfaces/python/test/testdata/plugin.test.dummy/addon.py");
+  const std::vector<std::string> arguments = { "plugin://plugin.test.dummy/", "-1", query };
+
+  CAddonPythonInvoker invoker(&python);
+  invoker.SetAddon(addon);
+  return invoker.Execute(script, arguments) && invoker.GetState() == InvokerStateDone;
+}
+
+// average time of a listing in microseconds
+long long MeasureListings(XBPython& python, const ADDON::AddonPtr& addon, int iterations)
+{
+  const std::string script = XBMC_REF_FILE_PATH("xbmc/interfaces/python/test/testdata/plugin.test.dummy/addon.py");
+  const std::vector<std::string> arguments = { "plugin://plugin.test.dummy/", "-1", "?page=1" };
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++)
+  {
+    CAddonPythonInvoker invoker(&python);
+    invoker.SetAddon(addon);
+    EXPECT_TRUE(invoker.Execute(script, arguments));
+    EXPECT_EQ(InvokerStateDone, invoker.GetState());
+  }
+  auto duration = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration).count() / iterations;
+}
+
+}
+
+class TestPythonInvokerHelper
+{
+public:
+  static std::vector<void*> GetPooledInterpreters()
+  {
+    std::vector<void*> interpreters;
+    CSingleLock lock(CPythonInvoker::s_poolCritical);
+    for (const auto& pooled : CPythonInvoker::s_interpreterPool)
+      interpreters.push_back(pooled.threadState);
+    return interpreters;
+  }
+};
+
+TEST(TestPythonInvoker, ReusesPooledInterpreter)
+{
+  XBPython python;
+  auto addon = CreateDummyPlugin(true);
+  ASSERT_TRUE(addon != nullptr);
+
+  ASSERT_TRUE(RunListing(python, addon, "?page=1"));
+  std::vector<void*> pooled = TestPythonInvokerHelper::GetPooledInterpreters();
+  ASSERT_EQ(1u, pooled.size());
+
+  // the second run takes the interpreter out of the pool and puts it back
+  ASSERT_TRUE(RunListing(python, addon, "?page=2"));
+  EXPECT_EQ(pooled, TestPythonInvokerHelper::GetPooledInterpreters());
+
+  CPythonInvoker::ReleasePooledInterpreters();
+}
+
+TEST(TestPythonInvoker, DoesNotPoolFailedInterpreter)
+{
+  XBPython python;
+  auto addon = CreateDummyPlugin(true);
+  ASSERT_TRUE(addon != nullptr);
+
+  ASSERT_TRUE(RunListing(python, addon, "?page=1"));
+  ASSERT_TRUE(CPythonInvoker::HasPooledInterpreters());
+
+  // the failing run uses the pooled interpreter and ends it
+  EXPECT_FALSE(RunListing(python, addon, "?fail=1"));
+  EXPECT_FALSE(CPythonInvoker::HasPooledInterpreters());
+
+  // without reuse nothing is pooled in the first place
+  EXPECT_TRUE(RunListing(python, CreateDummyPlugin(false), "?page=1"));
+  EXPECT_FALSE(CPythonInvoker::HasPooledInterpreters());
+}
+
+TEST(TestPythonInvoker, ReleasePooledInterpreters)
+{
+  XBPython python;
+  auto addon = CreateDummyPlugin(true);
+  ASSERT_TRUE(addon != nullptr);
+
+  ASSERT_TRUE(RunListing(python, addon, "?page=1"));
+  ASSERT_TRUE(CPythonInvoker::HasPooledInterpreters());
+
+  // interpreters idle for less than the given time are kept
+  CPythonInvoker::ReleasePooledInterpreters(60 * 60 * 1000);
+  EXPECT_TRUE(CPythonInvoker::HasPooledInterpreters());
+
+  CPythonInvoker::ReleasePooledInterpreters();
+  EXPECT_FALSE(CPythonInvoker::HasPooledInterpreters());
+  EXPECT_TRUE(TestPythonInvokerHelper::GetPooledInterpreters().empty());
+}
+
+// listing latency of a cold and a warm interpreter, only runs with
+// --gtest_also_run_disabled_tests
+TEST(TestPythonInvoker, DISABLED_Benchmark)
+{
+  static const int iterations = 10;
+
+  XBPython python;
+
+  auto coldAddon = CreateDummyPlugin(false);
+  auto warmAddon = CreateDummyPlugin(true);
+  ASSERT_TRUE(coldAddon && warmAddon);
+
+  long long coldUs = MeasureListings(python, coldAddon, iterations);
+  EXPECT_FALSE(CPythonInvoker::HasPooledInterpreters());
+
+  // the first invocation creates the interpreter that all others reuse
+  MeasureListings(python, warmAddon, 1);
+  EXPECT_TRUE(CPythonInvoker::HasPooledInterpreters());
+  long long warmUs = MeasureListings(python, warmAddon, iterations);
+
+  CPythonInvoker::ReleasePooledInterpreters();
+  EXPECT_FALSE(CPythonInvoker::HasPooledInterpreters());
+
+  RecordProperty("ColdListingUs", std::to_string(coldUs));
+  RecordProperty("WarmListingUs", std::to_string(warmUs));
+}
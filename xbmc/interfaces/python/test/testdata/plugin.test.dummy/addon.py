@@ -0,0 +1,15 @@
+import sys
+
+import xbmcgui
+
+from resources.lib import catalog
+
+# lets the tests check what happens to an interpreter after a failure
+if len(sys.argv) > 2 and 'fail' in sys.argv[2]:
+    raise RuntimeError('failure requested by the test')
+
+items = []
+for entry in catalog.list_entries(sys.argv[2] if len(sys.argv) > 2 else ''):
+    item = xbmcgui.ListItem(entry['title'])
+    item.setInfo('video', {'plot': entry['plot']})
+    items.append(item)
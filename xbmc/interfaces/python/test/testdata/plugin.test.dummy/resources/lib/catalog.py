@@ -0,0 +1,15 @@
+# Stands in for the heavy imports of real streaming add-ons
+import decimal
+import email.parser
+import json
+import xml.dom.minidom
+
+_TEMPLATE = xml.dom.minidom.parseString(
+    '<catalog>' + ''.join('<entry id="%d">Entry %d</entry>' % (i, i) for i in range(2000)) + '</catalog>')
+_ENTRIES = [json.loads(json.dumps({'title': node.firstChild.data,
+                                   'plot': str(decimal.Decimal(node.getAttribute('id')) / 7)}))
+            for node in _TEMPLATE.getElementsByTagName('entry')]
+
+
+def list_entries(query):
+    return _ENTRIES[:200]
@@ -6435,7 +6435,12 @@ int CMusicDatabase::GetSongIDFromPath(const std::string &filePath)
 bool CMusicDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
-  { // number of items in the db has likely changed, so reset the infomanager cache
+  {
+    // within a batch the cache is reset once the batch is closed
+    if (InBatch())
+      return true;
+
+    // number of items in the db has likely changed, so reset the infomanager cache
     CGUIComponent* gui = CServiceBroker::GetGUI();
     if (gui)
     {
@@ -6446,6 +6451,18 @@ bool CMusicDatabase::CommitTransaction()
   return false;
 }
 
+bool CMusicDatabase::EndBatch()
+{
+  if (!InBatch())
+    return false;
+
+  bool ret = CDatabase::EndBatch();
+  CGUIComponent* gui = CServiceBroker::GetGUI();
+  if (gui)
+    gui->GetInfoManager().GetInfoProviders().GetLibraryInfoProvider().SetLibraryBool(LIBRARY_HAS_MUSIC, GetSongsCount() > 0);
+  return ret;
+}
+
 bool CMusicDatabase::SetScraperAll(const std::string & strBaseDir, const ADDON::ScraperPtr scraper)
 {
   if (NULL == m_pDB.get()) return false;
@@ -113,6 +113,7 @@ public:
 
   bool Open() override;
   bool CommitTransaction() override;
+  bool EndBatch() override;
   void EmptyCache();
   void Clean();
   int  Cleanup(CGUIDialogProgress* progressDialog = nullptr);
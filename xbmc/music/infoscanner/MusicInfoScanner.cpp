@@ -134,6 +134,7 @@ void CMusicInfoScanner::Process()
       m_needsCleanup = false;
 
       bool commit = true;
+      m_musicDatabase.BeginBatch();
       for (std::set<std::string>::const_iterator it = m_pathsToScan.begin(); it != m_pathsToScan.end(); ++it)
       {
         if (!CDirectory::Exists(*it) && !m_bClean)
@@ -172,6 +173,7 @@ void CMusicInfoScanner::Process()
           break;
         }
       }
+      m_musicDatabase.EndBatch();
 
       if (commit)
       {
@@ -895,6 +897,7 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
   int numAdded = 0;
 
   // Add all albums to the library, and hence any new song or album artists or other contributors
+  m_musicDatabase.BeginBatchItem();
   for (VECALBUMS::iterator album = albums.begin(); album != albums.end(); ++album)
   {
     if (m_bStop)
@@ -910,6 +913,7 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
     
     numAdded += album->songs.size();
   }
+  m_musicDatabase.BatchItemDone();
   return numAdded;
 }
 
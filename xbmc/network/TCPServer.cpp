@@ -19,11 +19,21 @@
  */
 
 #include "TCPServer.h"
+#include <algorithm>
+#include <iterator>
 #include <stdio.h>
 #include <stdlib.h>
 #include <memory.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#if !defined(TARGET_WINDOWS)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+#include <sys/epoll.h>
+#define HAS_EPOLL
+#endif
 
 #include "settings/AdvancedSettings.h"
 #include "interfaces/json-rpc/JSONRPC.h"
@@ -31,6 +41,7 @@
 #include "utils/log.h"
 #include "utils/Variant.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "websocket/WebSocketManager.h"
 #include "Network.h"
 
@@ -61,6 +72,26 @@ using namespace JSONRPC;
 using namespace ANNOUNCEMENT;
 
 #define RECEIVEBUFFER 1024
+#define MAX_EVENTS 64
+// notifications beyond this many queued bytes per client are dropped, oldest first
+#define MAX_QUEUED_ANNOUNCEMENTS (256 * 1024)
+// clients that don't read any of their queued data for this long are disconnected
+#define CLIENT_STALL_TIMEOUT 30000
+#define CLIENT_LAG_WARNING 5000
+
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL
+#else
+#define SEND_FLAGS 0
+#endif
+
+// notifications that only report the latest state, a newer one makes a queued one obsolete
+static const char* SupersededAnnouncements[] = { "Player.OnSeek", "Player.OnSpeedChanged", "Application.OnVolumeChanged" };
+
+static bool IsReady(const std::vector<SOCKET> &sockets, SOCKET socket)
+{
+  return std::find(sockets.begin(), sockets.end(), socket) != sockets.end();
+}
 
 CTCPServer *CTCPServer::ServerInstance = NULL;
 
@@ -117,34 +148,19 @@ CTCPServer::CTCPServer(int port, bool nonlocal) : CThread("TCPServer")
   m_port = port;
   m_nonlocal = nonlocal;
   m_sdpd = NULL;
+  m_pollfd = -1;
 }
 
 void CTCPServer::Process()
 {
   m_bStop = false;
 
+  std::vector<SOCKET> readable;
+  std::vector<SOCKET> writable;
+
   while (!m_bStop)
   {
-    SOCKET          max_fd = 0;
-    fd_set          rfds;
-    struct timeval  to     = {1, 0};
-    FD_ZERO(&rfds);
-
-    for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); ++it)
-    {
-      FD_SET(*it, &rfds);
-      if ((intptr_t)*it > (intptr_t)max_fd)
-        max_fd = *it;
-    }
-
-    for (unsigned int i = 0; i < m_connections.size(); i++)
-    {
-      FD_SET(m_connections[i]->m_socket, &rfds);
-      if ((intptr_t)m_connections[i]->m_socket > (intptr_t)max_fd)
-        max_fd = m_connections[i]->m_socket;
-    }
-
-    int res = select((intptr_t)max_fd+1, &rfds, NULL, NULL, &to);
+    int res = Wait(readable, writable);
     if (res < 0)
     {
       CLog::Log(LOGERROR, "JSONRPC Server: Select failed");
@@ -156,7 +172,10 @@ void CTCPServer::Process()
       for (int i = m_connections.size() - 1; i >= 0; i--)
       {
         int socket = m_connections[i]->m_socket;
-        if (FD_ISSET(socket, &rfds))
+        if (IsReady(writable, socket))
+          m_connections[i]->Flush();
+
+        if (IsReady(readable, socket))
         {
           char buffer[RECEIVEBUFFER] = {};
           int  nread = 0;
@@ -175,6 +194,7 @@ void CTCPServer::Process()
               if (websocket != NULL)
               {
                 // Replace the CTCPClient with a CWebSocketClient
+                CSingleLock lock(m_connectionsLock);
                 CWebSocketClient *websocketClient = new CWebSocketClient(websocket, *(m_connections[i]));
                 delete m_connections[i];
                 m_connections.erase(m_connections.begin() + i);
@@ -193,16 +213,14 @@ void CTCPServer::Process()
           if (close)
           {
             CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
-            m_connections[i]->Disconnect();
-            delete m_connections[i];
-            m_connections.erase(m_connections.begin() + i);
+            RemoveConnection(i);
           }
         }
       }
 
       for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); ++it)
       {
-        if (FD_ISSET(*it, &rfds))
+        if (IsReady(readable, *it))
         {
           CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
           CTCPClient *newconnection = new CTCPClient();
@@ -211,6 +229,7 @@ void CTCPServer::Process()
           if (newconnection->m_socket == INVALID_SOCKET)
           {
             CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed: %d", errno);
+            delete newconnection;
             if (EBADF == errno)
             {
               Sleep(1000);
@@ -221,16 +240,133 @@ void CTCPServer::Process()
           else
           {
             CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
-            m_connections.push_back(newconnection);
+            AddConnection(newconnection);
           }
         }
       }
     }
+
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    for (int i = m_connections.size() - 1; i >= 0; i--)
+    {
+      if (m_connections[i]->Failed(now))
+      {
+        CLog::Log(LOGINFO, "JSONRPC Server: Dropping client that stopped receiving");
+        RemoveConnection(i);
+      }
+    }
   }
 
   Deinitialize();
 }
 
+int CTCPServer::Wait(std::vector<SOCKET> &readable, std::vector<SOCKET> &writable)
+{
+  readable.clear();
+  writable.clear();
+
+#ifdef HAS_EPOLL
+  if (m_pollfd >= 0)
+  {
+    struct epoll_event events[MAX_EVENTS];
+    int res = epoll_wait(m_pollfd, events, MAX_EVENTS, 1000);
+    if (res < 0)
+      return errno == EINTR ? 0 : -1;
+
+    for (int i = 0; i < res; i++)
+    {
+      if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+        readable.push_back(events[i].data.fd);
+      if (events[i].events & EPOLLOUT)
+        writable.push_back(events[i].data.fd);
+    }
+    return res;
+  }
+#endif
+
+  SOCKET          max_fd = 0;
+  fd_set          rfds;
+  fd_set          wfds;
+  struct timeval  to     = {1, 0};
+  FD_ZERO(&rfds);
+  FD_ZERO(&wfds);
+
+  for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); ++it)
+  {
+    FD_SET(*it, &rfds);
+    if ((intptr_t)*it > (intptr_t)max_fd)
+      max_fd = *it;
+  }
+
+  for (unsigned int i = 0; i < m_connections.size(); i++)
+  {
+    FD_SET(m_connections[i]->m_socket, &rfds);
+    if (m_connections[i]->HasPendingOutput())
+      FD_SET(m_connections[i]->m_socket, &wfds);
+    if ((intptr_t)m_connections[i]->m_socket > (intptr_t)max_fd)
+      max_fd = m_connections[i]->m_socket;
+  }
+
+  int res = select((intptr_t)max_fd+1, &rfds, &wfds, NULL, &to);
+  if (res <= 0)
+    return res;
+
+  for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); ++it)
+  {
+    if (FD_ISSET(*it, &rfds))
+      readable.push_back(*it);
+  }
+
+  for (unsigned int i = 0; i < m_connections.size(); i++)
+  {
+    if (FD_ISSET(m_connections[i]->m_socket, &rfds))
+      readable.push_back(m_connections[i]->m_socket);
+    if (FD_ISSET(m_connections[i]->m_socket, &wfds))
+      writable.push_back(m_connections[i]->m_socket);
+  }
+  return res;
+}
+
+void CTCPServer::AddConnection(CTCPClient *client)
+{
+  // announcements are only queued, the socket must never block the caller
+#ifdef TARGET_WINDOWS
+  u_long nonblocking = 1;
+  ioctlsocket(client->m_socket, FIONBIO, &nonblocking);
+#else
+  fcntl(client->m_socket, F_SETFL, fcntl(client->m_socket, F_GETFL) | O_NONBLOCK);
+#endif
+
+#ifdef HAS_EPOLL
+  if (m_pollfd >= 0)
+  {
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = client->m_socket;
+    if (epoll_ctl(m_pollfd, EPOLL_CTL_ADD, client->m_socket, &event) == 0)
+      client->m_pollfd = m_pollfd;
+    else
+      CLog::Log(LOGERROR, "JSONRPC Server: Failed to watch new connection: %d", errno);
+  }
+#endif
+
+  CSingleLock lock(m_connectionsLock);
+  m_connections.push_back(client);
+}
+
+void CTCPServer::RemoveConnection(unsigned int index)
+{
+  CTCPClient *client = m_connections[index];
+  {
+    CSingleLock lock(m_connectionsLock);
+    m_connections.erase(m_connections.begin() + index);
+  }
+
+  client->Disconnect();
+  client->LogStatistics();
+  delete client;
+}
+
 bool CTCPServer::PrepareDownload(const char *path, CVariant &details, std::string &protocol)
 {
   return false;
@@ -250,6 +386,11 @@ void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char
 {
   std::string str = IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, g_advancedSettings.m_jsonOutputCompact);
 
+  std::string key = std::string(AnnouncementFlagToString(flag)) + "." + message;
+  if (std::find(std::begin(SupersededAnnouncements), std::end(SupersededAnnouncements), key) == std::end(SupersededAnnouncements))
+    key.clear();
+
+  CSingleLock lock(m_connectionsLock);
   for (unsigned int i = 0; i < m_connections.size(); i++)
   {
     {
@@ -258,7 +399,7 @@ void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char
         continue;
     }
 
-    m_connections[i]->Send(str.c_str(), str.size());
+    m_connections[i]->SendAnnouncement(str.c_str(), str.size(), key);
   }
 }
 
@@ -273,6 +414,25 @@ bool CTCPServer::Initialize()
 
   if (started)
   {
+#ifdef HAS_EPOLL
+    m_pollfd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_pollfd < 0)
+      CLog::Log(LOGWARNING, "JSONRPC Server: epoll unavailable, falling back to select");
+
+    for (unsigned int i = 0; i < m_servers.size() && m_pollfd >= 0; i++)
+    {
+      struct epoll_event event = {};
+      event.events = EPOLLIN;
+      event.data.fd = m_servers[i];
+      if (epoll_ctl(m_pollfd, EPOLL_CTL_ADD, m_servers[i], &event) < 0)
+      {
+        CLog::Log(LOGWARNING, "JSONRPC Server: Failed to watch server socket, falling back to select");
+        close(m_pollfd);
+        m_pollfd = -1;
+      }
+    }
+#endif
+
     CAnnouncementManager::GetInstance().AddAnnouncer(this);
     CLog::Log(LOGINFO, "JSONRPC Server: Successfully initialized");
     return true;
@@ -486,13 +646,16 @@ bool CTCPServer::InitializeTCP()
 
 void CTCPServer::Deinitialize()
 {
-  for (unsigned int i = 0; i < m_connections.size(); i++)
   {
-    m_connections[i]->Disconnect();
-    delete m_connections[i];
-  }
+    CSingleLock lock(m_connectionsLock);
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+      m_connections[i]->Disconnect();
+      delete m_connections[i];
+    }
 
-  m_connections.clear();
+    m_connections.clear();
+  }
 
   for (unsigned int i = 0; i < m_servers.size(); i++)
     closesocket(m_servers[i]);
@@ -505,6 +668,12 @@ void CTCPServer::Deinitialize()
   m_sdpd = NULL;
 #endif
 
+#ifdef HAS_EPOLL
+  if (m_pollfd >= 0)
+    close(m_pollfd);
+#endif
+  m_pollfd = -1;
+
   CAnnouncementManager::GetInstance().RemoveAnnouncer(this);
 }
 
@@ -517,6 +686,16 @@ CTCPServer::CTCPClient::CTCPClient()
   m_endBrackets = 0;
   m_beginChar = 0;
   m_endChar = 0;
+  m_pollfd = -1;
+  m_outboundOffset = 0;
+  m_announcementsSize = 0;
+  m_pollOut = false;
+  m_failed = false;
+  m_lastProgress = 0;
+  m_maxLag = 0;
+  m_coalesced = 0;
+  m_dropped = 0;
+  m_lagging = false;
 
   m_addrlen = sizeof(m_cliaddr);
 }
@@ -550,12 +729,164 @@ bool CTCPServer::CTCPClient::SetAnnouncementFlags(int flags)
 
 void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
 {
-  unsigned int sent = 0;
-  do
+  Queue(data, size, "", false);
+  Flush();
+}
+
+void CTCPServer::CTCPClient::SendAnnouncement(const char *data, unsigned int size, const std::string &key)
+{
+  Queue(data, size, key, true);
+  Flush();
+}
+
+void CTCPServer::CTCPClient::Queue(const char *data, unsigned int size, const std::string &key, bool announcement)
+{
+  CSingleLock lock (m_critSection);
+  if (m_failed || m_socket == INVALID_SOCKET)
+    return;
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  if (m_outbound.empty())
+    m_lastProgress = now;
+
+  // the first message can't be touched once parts of it went out
+  size_t first = m_outboundOffset > 0 ? 1 : 0;
+
+  if (announcement && !key.empty())
   {
-    CSingleLock lock (m_critSection);
-    sent += send(m_socket, data + sent, size - sent, 0);
-  } while (sent < size);
+    for (size_t i = first; i < m_outbound.size(); i++)
+    {
+      if (m_outbound[i].key == key)
+      {
+        // take over the position of the obsolete notification so that it is
+        // still sent before everything that was queued after it
+        m_announcementsSize -= m_outbound[i].data.size();
+        m_announcementsSize += size;
+        m_outbound[i].data.assign(data, size);
+        m_coalesced++;
+        return;
+      }
+    }
+  }
+
+  if (announcement)
+  {
+    // make room by dropping the oldest notifications, responses are never dropped
+    size_t i = first;
+    while (m_announcementsSize + size > MAX_QUEUED_ANNOUNCEMENTS && i < m_outbound.size())
+    {
+      if (m_outbound[i].announcement)
+      {
+        m_announcementsSize -= m_outbound[i].data.size();
+        m_outbound.erase(m_outbound.begin() + i);
+        m_dropped++;
+      }
+      else
+        i++;
+    }
+
+    if (m_announcementsSize + size > MAX_QUEUED_ANNOUNCEMENTS)
+    {
+      m_dropped++;
+      return;
+    }
+  }
+
+  OutboundMessage message;
+  message.data.assign(data, size);
+  message.key = key;
+  message.announcement = announcement;
+  message.queued = now;
+
+  if (announcement)
+    m_announcementsSize += size;
+  m_outbound.push_back(std::move(message));
+}
+
+bool CTCPServer::CTCPClient::Flush()
+{
+  CSingleLock lock (m_critSection);
+  if (m_failed)
+    return false;
+
+  while (!m_outbound.empty() && m_socket != INVALID_SOCKET)
+  {
+    const OutboundMessage &message = m_outbound.front();
+    int sent = send(m_socket, message.data.c_str() + m_outboundOffset, (int)(message.data.size() - m_outboundOffset), SEND_FLAGS);
+    if (sent < 0)
+    {
+#ifdef TARGET_WINDOWS
+      if (WSAGetLastError() == WSAEWOULDBLOCK)
+#else
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+#endif
+        break;
+
+      CLog::Log(LOGDEBUG, "JSONRPC Server: Sending to client failed: %d", errno);
+      m_failed = true;
+      return false;
+    }
+
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    m_lastProgress = now;
+    m_outboundOffset += sent;
+    if (m_outboundOffset < message.data.size())
+      continue;
+
+    unsigned int lag = now - message.queued;
+    m_maxLag = std::max(m_maxLag, lag);
+    if (lag >= CLIENT_LAG_WARNING && !m_lagging)
+      CLog::Log(LOGWARNING, "JSONRPC Server: Client is lagging %u ms behind", lag);
+    m_lagging = lag >= CLIENT_LAG_WARNING;
+
+    if (message.announcement)
+      m_announcementsSize -= message.data.size();
+    m_outboundOffset = 0;
+    m_outbound.pop_front();
+  }
+
+  UpdatePollEvents();
+  return true;
+}
+
+bool CTCPServer::CTCPClient::HasPendingOutput()
+{
+  CSingleLock lock (m_critSection);
+  return !m_outbound.empty();
+}
+
+bool CTCPServer::CTCPClient::Failed(unsigned int now)
+{
+  CSingleLock lock (m_critSection);
+  if (!m_failed && !m_outbound.empty() && now - m_lastProgress > CLIENT_STALL_TIMEOUT)
+  {
+    CLog::Log(LOGWARNING, "JSONRPC Server: Client did not receive anything for %u ms", now - m_lastProgress);
+    m_failed = true;
+  }
+  return m_failed;
+}
+
+void CTCPServer::CTCPClient::LogStatistics()
+{
+  CSingleLock lock (m_critSection);
+  CLog::Log(LOGDEBUG, "JSONRPC Server: Client statistics: maximum lag %u ms, %u notifications coalesced, %u dropped",
+            m_maxLag, m_coalesced, m_dropped);
+}
+
+void CTCPServer::CTCPClient::UpdatePollEvents()
+{
+#ifdef HAS_EPOLL
+  // only ask for writability while there's something to write
+  bool pollOut = !m_outbound.empty();
+  if (m_pollfd < 0 || m_socket == INVALID_SOCKET || pollOut == m_pollOut)
+    return;
+
+  struct epoll_event event = {};
+  event.events = EPOLLIN | (pollOut ? EPOLLOUT : 0);
+  event.data.fd = m_socket;
+  if (epoll_ctl(m_pollfd, EPOLL_CTL_MOD, m_socket, &event) == 0)
+    m_pollOut = pollOut;
+#endif
 }
 
 void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
@@ -600,9 +931,14 @@ void CTCPServer::CTCPClient::Disconnect()
   if (m_socket > 0)
   {
     CSingleLock lock (m_critSection);
+    // hand over whatever the socket still takes, e.g. a websocket close frame
+    Flush();
     shutdown(m_socket, SHUT_RDWR);
     closesocket(m_socket);
     m_socket = INVALID_SOCKET;
+    m_outbound.clear();
+    m_outboundOffset = 0;
+    m_announcementsSize = 0;
   }
 }
 
@@ -618,6 +954,17 @@ void CTCPServer::CTCPClient::Copy(const CTCPClient& client)
   m_beginChar         = client.m_beginChar;
   m_endChar           = client.m_endChar;
   m_buffer            = client.m_buffer;
+  m_pollfd            = client.m_pollfd;
+  m_outbound          = client.m_outbound;
+  m_outboundOffset    = client.m_outboundOffset;
+  m_announcementsSize = client.m_announcementsSize;
+  m_pollOut           = client.m_pollOut;
+  m_failed            = client.m_failed;
+  m_lastProgress      = client.m_lastProgress;
+  m_maxLag            = client.m_maxLag;
+  m_coalesced         = client.m_coalesced;
+  m_dropped           = client.m_dropped;
+  m_lagging           = client.m_lagging;
 }
 
 CTCPServer::CWebSocketClient::CWebSocketClient(CWebSocket *websocket)
@@ -653,13 +1000,30 @@ CTCPServer::CWebSocketClient& CTCPServer::CWebSocketClient::operator=(const CWeb
 
 void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
 {
+  std::string frames;
+  if (Encode(data, size, frames))
+    CTCPClient::Send(frames.c_str(), frames.size());
+}
+
+void CTCPServer::CWebSocketClient::SendAnnouncement(const char *data, unsigned int size, const std::string &key)
+{
+  // all frames of a message are queued as one so they are coalesced or dropped together
+  std::string frames;
+  if (Encode(data, size, frames))
+    CTCPClient::SendAnnouncement(frames.c_str(), frames.size(), key);
+}
+
+bool CTCPServer::CWebSocketClient::Encode(const char *data, unsigned int size, std::string &frames)
+{
+  CSingleLock lock (m_critSection);
   const CWebSocketMessage *msg = m_websocket->Send(WebSocketTextFrame, data, size);
   if (msg == NULL || !msg->IsComplete())
-    return;
+    return false;
 
-  std::vector<const CWebSocketFrame *> frames = msg->GetFrames();
-  for (unsigned int index = 0; index < frames.size(); index++)
-    CTCPClient::Send(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength());
+  std::vector<const CWebSocketFrame *> msgFrames = msg->GetFrames();
+  for (unsigned int index = 0; index < msgFrames.size(); index++)
+    frames.append(msgFrames.at(index)->GetFrameData(), (size_t)msgFrames.at(index)->GetFrameLength());
+  return true;
 }
 
 void CTCPServer::CWebSocketClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
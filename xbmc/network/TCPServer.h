@@ -19,6 +19,8 @@
  *
  */
 
+#include <deque>
+#include <string>
 #include <vector>
 #include <sys/socket.h>
 
@@ -36,6 +38,7 @@ namespace JSONRPC
 {
   class CTCPServer : public ITransportLayer, public JSONRPC::IJSONRPCAnnouncer, public CThread
   {
+    friend class TestTCPServerHelper;
   public:
     static bool StartServer(int port, bool nonlocal);
     static void StopServer(bool bWait);
@@ -49,12 +52,23 @@ namespace JSONRPC
   protected:
     void Process() override;
   private:
+    class CTCPClient;
+
     CTCPServer(int port, bool nonlocal);
     bool Initialize();
     bool InitializeBlue();
     bool InitializeTCP();
     void Deinitialize();
 
+    /*!
+     \brief Wait until a server socket or a client is readable or a client with
+     queued output becomes writable
+     \return number of ready sockets, 0 on timeout and -1 on error
+     */
+    int Wait(std::vector<SOCKET> &readable, std::vector<SOCKET> &writable);
+    void AddConnection(CTCPClient *client);
+    void RemoveConnection(unsigned int index);
+
     class CTCPClient : public IClient
     {
     public:
@@ -69,26 +83,72 @@ namespace JSONRPC
       int GetAnnouncementFlags() override;
       bool SetAnnouncementFlags(int flags) override;
 
+      /*!
+       \brief Queue data for the client and write as much of it as the socket
+       accepts without blocking
+       */
       virtual void Send(const char *data, unsigned int size);
+      /*!
+       \brief Queue a notification for the client
+       \param key a queued notification that has not been started yet is
+       replaced by a newer one with the same non-empty key, which keeps the
+       position of the replaced one
+       */
+      virtual void SendAnnouncement(const char *data, unsigned int size, const std::string &key);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
       virtual bool IsNew() const { return m_new; }
       virtual bool Closing() const { return false; }
 
+      /*!
+       \brief Write queued data until the socket would block
+       \return false if writing to the socket failed
+       */
+      bool Flush();
+      bool HasPendingOutput();
+      /*!
+       \brief Whether the client failed or stopped reading its queued data
+       */
+      bool Failed(unsigned int now);
+      void LogStatistics();
+
       SOCKET m_socket;
       sockaddr_storage m_cliaddr;
       socklen_t m_addrlen;
       CCriticalSection m_critSection;
+      int m_pollfd;
 
     protected:
       void Copy(const CTCPClient& client);
+      void Queue(const char *data, unsigned int size, const std::string &key, bool announcement);
     private:
+      void UpdatePollEvents();
+
+      struct OutboundMessage
+      {
+        std::string data;
+        std::string key;
+        bool announcement;
+        unsigned int queued;
+      };
+
       bool m_new;
       int m_announcementflags;
       int m_beginBrackets, m_endBrackets;
       char m_beginChar, m_endChar;
       std::string m_buffer;
+
+      std::deque<OutboundMessage> m_outbound;
+      size_t m_outboundOffset;  ///< bytes of the first queued message already sent
+      size_t m_announcementsSize; ///< bytes of queued notifications
+      bool m_pollOut;
+      bool m_failed;
+      unsigned int m_lastProgress;
+      unsigned int m_maxLag;
+      unsigned int m_coalesced;
+      unsigned int m_dropped;
+      bool m_lagging;
     };
 
     class CWebSocketClient : public CTCPClient
@@ -101,6 +161,7 @@ namespace JSONRPC
       ~CWebSocketClient() override;
 
       void Send(const char *data, unsigned int size) override;
+      void SendAnnouncement(const char *data, unsigned int size, const std::string &key) override;
       void PushBuffer(CTCPServer *host, const char *buffer, int length) override;
       void Disconnect() override;
 
@@ -108,11 +169,15 @@ namespace JSONRPC
       bool Closing() const override { return m_websocket != NULL && m_websocket->GetState() == WebSocketStateClosed; }
 
     private:
+      bool Encode(const char *data, unsigned int size, std::string &frames);
+
       CWebSocket *m_websocket;
     };
 
     std::vector<CTCPClient*> m_connections;
+    CCriticalSection m_connectionsLock;
     std::vector<SOCKET> m_servers;
+    int m_pollfd;
     int m_port;
     bool m_nonlocal;
     void* m_sdpd;
@@ -27,6 +27,7 @@
 #include "network/WebServer.h"
 #include "network/httprequesthandler/HTTPRequestHandlerUtils.h"
 #include "utils/JSONVariantWriter.h"
+#include "utils/StringUtils.h"
 #include "utils/log.h"
 #include "utils/Variant.h"
 
@@ -84,6 +85,28 @@ int CHTTPJsonRpcHandler::HandleRequest()
 
   if (isRequest)
   {
+    // library queries are tagged with the library version so clients can
+    // revalidate a cached response instead of transferring it again
+    std::string etag;
+    if (JSONRPC::CJSONRPC::GetLibraryETag(m_requestData + jsonpCallback, etag))
+    {
+      AddResponseHeader(MHD_HTTP_HEADER_ETAG, etag);
+
+      std::string ifNoneMatch = HTTPRequestHandlerUtils::GetRequestHeaderValue(m_request.connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_IF_NONE_MATCH);
+      if (MatchesETag(ifNoneMatch, etag))
+      {
+        m_requestData.clear();
+        m_notModified = true;
+
+        m_response.type = HTTPMemoryDownloadNoFreeCopy;
+        m_response.status = MHD_HTTP_NOT_MODIFIED;
+        m_response.contentType = "application/json";
+        m_response.totalLength = 0;
+
+        return MHD_YES;
+      }
+    }
+
     m_responseData = JSONRPC::CJSONRPC::MethodCall(m_requestData, &m_transportLayer, &client);
 
     if (!jsonpCallback.empty())
@@ -125,11 +148,31 @@ int CHTTPJsonRpcHandler::HandleRequest()
 HttpResponseRanges CHTTPJsonRpcHandler::GetResponseData() const
 {
   HttpResponseRanges ranges;
-  ranges.push_back(m_responseRange);
+  if (!m_notModified)
+    ranges.push_back(m_responseRange);
 
   return ranges;
 }
 
+bool CHTTPJsonRpcHandler::MatchesETag(const std::string &ifNoneMatch, const std::string &etag)
+{
+  if (ifNoneMatch.empty())
+    return false;
+
+  std::vector<std::string> tags = StringUtils::Split(ifNoneMatch, ",");
+  for (std::vector<std::string>::iterator tag = tags.begin(); tag != tags.end(); ++tag)
+  {
+    StringUtils::Trim(*tag);
+    // If-None-Match uses the weak comparison
+    if (StringUtils::StartsWith(*tag, "W/"))
+      tag->erase(0, 2);
+    if (*tag == "*" || *tag == etag)
+      return true;
+  }
+
+  return false;
+}
+
 bool CHTTPJsonRpcHandler::appendPostData(const char *data, size_t size)
 {
   if (m_requestData.size() + size > MAX_HTTP_POST_SIZE)
@@ -49,9 +49,12 @@ protected:
   bool appendPostData(const char *data, size_t size) override;
 
 private:
+  static bool MatchesETag(const std::string &ifNoneMatch, const std::string &etag);
+
   std::string m_requestData;
   std::string m_responseData;
   CHttpResponseRange m_responseRange;
+  bool m_notModified = false;
 
   class CHTTPTransportLayer : public JSONRPC::ITransportLayer
   {
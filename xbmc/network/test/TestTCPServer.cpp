@@ -0,0 +1,172 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "network/TCPServer.h"
+#include "utils/StringUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace JSONRPC
+{
+class TestTCPServerHelper
+{
+public:
+  typedef CTCPServer::CTCPClient Client;
+};
+}
+
+using JSONRPC::TestTCPServerHelper;
+
+namespace
+{
+// a newline terminated message of the given size that starts with tag
+std::string Message(const std::string& tag, size_t size)
+{
+  std::string message(tag);
+  message.resize(size - 1, ' ');
+  message.push_back('\n');
+  return message;
+}
+}
+
+class TestTCPServer : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, m_sockets));
+    fcntl(m_sockets[0], F_SETFL, fcntl(m_sockets[0], F_GETFL) | O_NONBLOCK);
+    fcntl(m_sockets[1], F_SETFL, fcntl(m_sockets[1], F_GETFL) | O_NONBLOCK);
+    m_client.m_socket = m_sockets[0];
+  }
+
+  void TearDown() override
+  {
+    m_client.Disconnect();
+    close(m_sockets[1]);
+  }
+
+  void SendResponse(const std::string& data)
+  {
+    m_client.Send(data.c_str(), data.size());
+  }
+
+  void SendAnnouncement(const std::string& data, const std::string& key = "")
+  {
+    m_client.SendAnnouncement(data.c_str(), data.size(), key);
+  }
+
+  // fills the socket with a response, so everything queued after it stays queued
+  void Block()
+  {
+    SendResponse(Message("block", 4 * 1024 * 1024));
+    ASSERT_TRUE(m_client.HasPendingOutput());
+  }
+
+  // the tags of all messages the client receives
+  std::vector<std::string> Receive()
+  {
+    std::string data;
+    char buffer[64 * 1024];
+    while (true)
+    {
+      EXPECT_TRUE(m_client.Flush());
+      ssize_t size = read(m_sockets[1], buffer, sizeof(buffer));
+      if (size > 0)
+        data.append(buffer, size);
+      else if (!m_client.HasPendingOutput())
+        break;
+    }
+
+    std::vector<std::string> tags;
+    for (const auto& line : StringUtils::Split(data, "\n"))
+    {
+      if (!line.empty())
+        tags.push_back(line.substr(0, line.find(' ')));
+    }
+    return tags;
+  }
+
+  int m_sockets[2];
+  TestTCPServerHelper::Client m_client;
+};
+
+TEST_F(TestTCPServer, SendsImmediately)
+{
+  SendResponse(Message("response", 100));
+  EXPECT_FALSE(m_client.HasPendingOutput());
+  EXPECT_EQ(std::vector<std::string>({ "response" }), Receive());
+}
+
+TEST_F(TestTCPServer, CoalescesInPlace)
+{
+  Block();
+  SendAnnouncement(Message("seek1", 100), "Player.OnSeek");
+  SendAnnouncement(Message("pause", 100));
+  SendAnnouncement(Message("seek2", 100), "Player.OnSeek");
+  SendAnnouncement(Message("stop", 100));
+
+  EXPECT_EQ(std::vector<std::string>({ "block", "seek2", "pause", "stop" }), Receive());
+}
+
+TEST_F(TestTCPServer, CapsQueuedAnnouncements)
+{
+  Block();
+
+  // only the newest 256 KiB of notifications are kept
+  const int count = 300;
+  for (int i = 0; i < count; i++)
+    SendAnnouncement(Message(StringUtils::Format("n%i", i), 1024));
+
+  std::vector<std::string> tags = Receive();
+  ASSERT_EQ(1u + 256u, tags.size());
+  EXPECT_EQ("block", tags.front());
+  EXPECT_EQ(StringUtils::Format("n%i", count - 256), tags[1]);
+  EXPECT_EQ(StringUtils::Format("n%i", count - 1), tags.back());
+}
+
+TEST_F(TestTCPServer, NeverDropsResponses)
+{
+  Block();
+
+  for (int i = 0; i < 100; i++)
+  {
+    SendAnnouncement(Message(StringUtils::Format("n%i", i), 8 * 1024));
+    SendResponse(Message(StringUtils::Format("r%i", i), 8 * 1024));
+  }
+
+  std::vector<std::string> responses;
+  for (const auto& tag : Receive())
+  {
+    if (tag[0] != 'n')
+      responses.push_back(tag);
+  }
+
+  ASSERT_EQ(101u, responses.size());
+  for (int i = 0; i < 100; i++)
+    EXPECT_EQ(StringUtils::Format("r%i", i), responses[i + 1]);
+}
@@ -455,6 +455,54 @@ TEST_F(TestWebServer, CannotModifyOverJsonRpcWithHttpGet)
   JSONRPC::CJSONRPC::Cleanup();
 }
 
+TEST_F(TestWebServer, CanRevalidateLibraryQueryOverJsonRpcWithHttpGet)
+{
+  // initialized JSON-RPC
+  JSONRPC::CJSONRPC::Initialize();
+
+  std::string url = GetUrl(TEST_URL_JSONRPC "?request=" + CURL::Encode("{ \"jsonrpc\": \"2.0\", \"method\": \"VideoLibrary.GetGenres\", \"params\": { \"type\": \"movie\" }, \"id\": 1 }"));
+
+  std::string result;
+  CCurlFile curl;
+  ASSERT_TRUE(curl.Get(url, result));
+  ASSERT_FALSE(result.empty());
+
+  // library queries must be tagged
+  std::string etag = curl.GetHttpHeader().GetValue(MHD_HTTP_HEADER_ETAG);
+  ASSERT_FALSE(etag.empty());
+
+  // the same query must get the same tag as long as the library doesn't change
+  CCurlFile curlAgain;
+  ASSERT_TRUE(curlAgain.Get(url, result));
+  EXPECT_STREQ(etag.c_str(), curlAgain.GetHttpHeader().GetValue(MHD_HTTP_HEADER_ETAG).c_str());
+
+  // revalidating with the tag must not transfer the result again
+  CCurlFile curlRevalidate;
+  curlRevalidate.SetRequestHeader(MHD_HTTP_HEADER_IF_NONE_MATCH, etag);
+  result.clear();
+  ASSERT_TRUE(curlRevalidate.Get(url, result));
+  EXPECT_TRUE(result.empty());
+  const CHttpHeader& revalidateHeader = curlRevalidate.GetHttpHeader();
+  EXPECT_TRUE(revalidateHeader.GetProtoLine().find(StringUtils::Format(" %d ", MHD_HTTP_NOT_MODIFIED)) != std::string::npos);
+  EXPECT_STREQ(etag.c_str(), revalidateHeader.GetValue(MHD_HTTP_HEADER_ETAG).c_str());
+
+  // a different tag must get the full result
+  CCurlFile curlOutdated;
+  curlOutdated.SetRequestHeader(MHD_HTTP_HEADER_IF_NONE_MATCH, "\"outdated\"");
+  result.clear();
+  ASSERT_TRUE(curlOutdated.Get(url, result));
+  EXPECT_FALSE(result.empty());
+  EXPECT_TRUE(curlOutdated.GetHttpHeader().GetProtoLine().find(StringUtils::Format(" %d ", MHD_HTTP_OK)) != std::string::npos);
+
+  // any other call must not be tagged
+  CCurlFile curlPing;
+  ASSERT_TRUE(curlPing.Get(GetUrl(TEST_URL_JSONRPC "?request=" + CURL::Encode("{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Ping\", \"id\": 1 }")), result));
+  EXPECT_TRUE(curlPing.GetHttpHeader().GetValue(MHD_HTTP_HEADER_ETAG).empty());
+
+  // uninitialize JSON-RPC
+  JSONRPC::CJSONRPC::Cleanup();
+}
+
 TEST_F(TestWebServer, CanReadDataOverJsonRpcWithHttpPost)
 {
   // initialized JSON-RPC
@@ -179,6 +179,6 @@ namespace PERIPHERALS
     
     AddonInstance_Peripheral m_struct;
 
-    CSharedSection      m_dllSection;
+    CSharedSection      m_dllSection{"CPeripheralAddon"};
   };
 }
@@ -42,6 +42,7 @@
 #include "utils/SystemInfo.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
+#include "utils/XMLBinaryCache.h"
 #include "utils/XMLUtils.h"
 
 #if defined(TARGET_DARWIN_IOS)
@@ -80,6 +81,7 @@ void CAdvancedSettings::OnSettingsLoaded()
     CLog::Log(LOGNOTICE, "Disabled debug logging due to GUI setting. Level %d.", m_logLevel);
   }
   CLog::SetLogLevel(m_logLevel);
+  CLog::SetAsync(m_logAsync);
 
   m_extraLogEnabled = CServiceBroker::GetSettings().GetBool(CSettings::SETTING_DEBUG_EXTRALOGGING);
   setExtraLogLevel(CServiceBroker::GetSettings().GetList(CSettings::SETTING_DEBUG_SETEXTRALOGLEVEL));
@@ -117,6 +119,7 @@ void CAdvancedSettings::Initialize()
   //default hold time of 25 ms, this allows a 20 hertz sine to pass undistorted
   m_limiterHold = 0.025f;
   m_limiterRelease = 0.1f;
+  m_audioLowLatency = false;
 
   m_seekSteps = { 10, 30, 60, 180, 300, 600, 1800 };
 
@@ -402,6 +405,7 @@ void CAdvancedSettings::Initialize()
   m_videoAssFixedWorks = false;
 
   m_logLevelHint = m_logLevel = LOG_LEVEL_DEBUG;
+  m_logAsync = false;
   m_extraLogEnabled = false;
   m_extraLogLevels = 0;
 
@@ -438,7 +442,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     return;
   }
 
-  if (!advancedXML.LoadFile(file))
+  if (!CXMLBinaryCache::LoadFile(file, advancedXML))
   {
     CLog::Log(LOGERROR, "Error loading %s, Line %d\n%s", file.c_str(), advancedXML.ErrorRow(), advancedXML.ErrorDesc());
     return;
@@ -529,6 +533,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
 
     XMLUtils::GetFloat(pElement, "limiterhold", m_limiterHold, 0.0f, 100.0f);
     XMLUtils::GetFloat(pElement, "limiterrelease", m_limiterRelease, 0.001f, 100.0f);
+    XMLUtils::GetBoolean(pElement, "lowlatency", m_audioLowLatency);
   }
 
   pElement = pRootElement->FirstChildElement("omx");
@@ -869,6 +874,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     g_advancedSettings.m_logLevel = std::max(g_advancedSettings.m_logLevel, g_advancedSettings.m_logLevelHint);
     CLog::SetLogLevel(g_advancedSettings.m_logLevel);
   }
+  XMLUtils::GetBoolean(pRootElement, "logasync", m_logAsync);
 
   XMLUtils::GetString(pRootElement, "cddbaddress", m_cddbAddress);
   XMLUtils::GetBoolean(pRootElement, "addsourceontop", m_addSourceOnTop);
@@ -142,6 +142,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_VideoPlayerIgnoreDTSinWAV;
     float m_limiterHold;
     float m_limiterRelease;
+    bool m_audioLowLatency; ///< request small sink periods, trades underrun safety for latency
 
     bool  m_omxDecodeStartWithValidFrame;
 
@@ -202,6 +203,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_songInfoDuration;
     int m_logLevel;
     int m_logLevelHint;
+    bool m_logAsync; // queue log lines and write them on a background thread
     bool m_extraLogEnabled;
     int m_extraLogLevels;
     std::string m_cddbAddress;
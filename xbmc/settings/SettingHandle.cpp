@@ -0,0 +1,196 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SettingHandle.h"
+#include "settings/lib/Setting.h"
+#include "settings/lib/SettingsManager.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+
+#include <vector>
+
+namespace
+{
+
+template<typename TSetting, typename THandle>
+void SyncValue(const CSetting& setting, THandle& handle)
+{
+  const TSetting& typedSetting = static_cast<const TSetting&>(setting);
+
+  // a change racing with this update may already have stored a newer value,
+  // so check again after storing and let the latest value win
+  auto value = typedSetting.GetValue();
+  handle.SetValue(value);
+  for (auto current = typedSetting.GetValue(); current != value; current = typedSetting.GetValue())
+  {
+    value = current;
+    handle.SetValue(value);
+  }
+}
+
+}
+
+CSettingHandles::CSettingHandles(CSettingsManager& settingsManager)
+  : m_settingsManager(settingsManager)
+{ }
+
+SettingBoolHandlePtr CSettingHandles::GetBool(const std::string& id)
+{
+  Handle handle;
+  if (!Create(id, handle) || handle.boolHandle == nullptr)
+  {
+    CLog::Log(LOGWARNING, "CSettingHandles: unable to create boolean handle for setting %s", id.c_str());
+    return std::make_shared<CSettingBoolHandle>(id, false);
+  }
+
+  return handle.boolHandle;
+}
+
+SettingIntHandlePtr CSettingHandles::GetInt(const std::string& id)
+{
+  Handle handle;
+  if (!Create(id, handle) || handle.intHandle == nullptr)
+  {
+    CLog::Log(LOGWARNING, "CSettingHandles: unable to create integer handle for setting %s", id.c_str());
+    return std::make_shared<CSettingIntHandle>(id, 0);
+  }
+
+  return handle.intHandle;
+}
+
+SettingNumberHandlePtr CSettingHandles::GetNumber(const std::string& id)
+{
+  Handle handle;
+  if (!Create(id, handle) || handle.numberHandle == nullptr)
+  {
+    CLog::Log(LOGWARNING, "CSettingHandles: unable to create number handle for setting %s", id.c_str());
+    return std::make_shared<CSettingNumberHandle>(id, 0.0);
+  }
+
+  return handle.numberHandle;
+}
+
+void CSettingHandles::Refresh()
+{
+  // setting values must not be read while holding m_critical because setting
+  // callbacks are executed with the setting locked
+  std::vector<Handle> handles;
+  {
+    CSingleLock lock(m_critical);
+    handles.reserve(m_handles.size());
+    for (const auto& handle : m_handles)
+      handles.push_back(handle.second);
+  }
+
+  for (auto& handle : handles)
+    Update(handle, *handle.setting);
+}
+
+void CSettingHandles::Clear()
+{
+  m_settingsManager.UnregisterCallback(this);
+
+  CSingleLock lock(m_critical);
+  m_handles.clear();
+}
+
+void CSettingHandles::OnSettingChanged(std::shared_ptr<const CSetting> setting)
+{
+  if (setting == nullptr)
+    return;
+
+  Handle handle;
+  {
+    CSingleLock lock(m_critical);
+    auto it = m_handles.find(setting->GetId());
+    if (it == m_handles.end())
+      return;
+    handle = it->second;
+  }
+
+  Update(handle, *setting);
+}
+
+bool CSettingHandles::Create(const std::string& id, Handle& handle)
+{
+  std::string key = id;
+  StringUtils::ToLower(key);
+  {
+    CSingleLock lock(m_critical);
+    auto it = m_handles.find(key);
+    if (it != m_handles.end())
+    {
+      handle = it->second;
+      return true;
+    }
+  }
+
+  std::shared_ptr<CSetting> setting = m_settingsManager.GetSetting(key);
+  if (setting == nullptr)
+    return false;
+
+  handle.setting = setting;
+  switch (setting->GetType())
+  {
+    case SettingType::Boolean:
+      handle.boolHandle = std::make_shared<CSettingBoolHandle>(key, false);
+      break;
+
+    case SettingType::Integer:
+      handle.intHandle = std::make_shared<CSettingIntHandle>(key, 0);
+      break;
+
+    case SettingType::Number:
+      handle.numberHandle = std::make_shared<CSettingNumberHandle>(key, 0.0);
+      break;
+
+    default:
+      return false;
+  }
+  Update(handle, *setting);
+
+  {
+    CSingleLock lock(m_critical);
+    auto inserted = m_handles.insert(std::make_pair(key, handle));
+    if (!inserted.second)
+    {
+      // another thread created the handle in the meantime
+      handle = inserted.first->second;
+      return true;
+    }
+  }
+
+  // any change after registering is delivered through OnSettingChanged() and
+  // any change since the first update is picked up by the update below
+  m_settingsManager.RegisterCallback(this, { key });
+  Update(handle, *setting);
+
+  return true;
+}
+
+void CSettingHandles::Update(Handle& handle, const CSetting& setting)
+{
+  if (handle.boolHandle != nullptr)
+    SyncValue<CSettingBool>(setting, *handle.boolHandle);
+  else if (handle.intHandle != nullptr)
+    SyncValue<CSettingInt>(setting, *handle.intHandle);
+  else if (handle.numberHandle != nullptr)
+    SyncValue<CSettingNumber>(setting, *handle.numberHandle);
+}
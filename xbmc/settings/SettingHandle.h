@@ -0,0 +1,117 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "settings/lib/ISettingCallback.h"
+#include "threads/CriticalSection.h"
+
+class CSetting;
+class CSettingsManager;
+
+/*!
+ \brief Pre-resolved, typed view on the value of a single setting.
+
+ Reading the value of a handle is a single relaxed atomic load instead of a
+ string keyed lookup in the settings manager, which makes handles suitable
+ for code that reads a setting per frame or per packet. Handles are obtained
+ from CSettingsBase::GetBoolHandle() and friends and are kept up to date
+ whenever the value of the setting changes.
+ */
+template<typename T>
+class CSettingHandle
+{
+public:
+  CSettingHandle(const std::string& id, T value)
+    : m_id(id)
+    , m_value(value)
+  { }
+
+  const std::string& GetId() const { return m_id; }
+  T GetValue() const { return m_value.load(std::memory_order_relaxed); }
+  void SetValue(T value) { m_value.store(value, std::memory_order_relaxed); }
+
+private:
+  const std::string m_id;
+  std::atomic<T> m_value;
+};
+
+using CSettingBoolHandle = CSettingHandle<bool>;
+using CSettingIntHandle = CSettingHandle<int>;
+using CSettingNumberHandle = CSettingHandle<double>;
+
+using SettingBoolHandlePtr = std::shared_ptr<const CSettingBoolHandle>;
+using SettingIntHandlePtr = std::shared_ptr<const CSettingIntHandle>;
+using SettingNumberHandlePtr = std::shared_ptr<const CSettingNumberHandle>;
+
+/*!
+ \brief Creates setting handles and keeps their values in sync with the
+ settings manager through ISettingCallback.
+
+ Handles stay valid after the settings have been uninitialized but keep
+ their last value from then on.
+ */
+class CSettingHandles : public ISettingCallback
+{
+public:
+  explicit CSettingHandles(CSettingsManager& settingsManager);
+  ~CSettingHandles() override = default;
+
+  SettingBoolHandlePtr GetBool(const std::string& id);
+  SettingIntHandlePtr GetInt(const std::string& id);
+  SettingNumberHandlePtr GetNumber(const std::string& id);
+
+  /*!
+   \brief Re-reads the values of all handles, e.g. after setting values have
+   been loaded or reset without triggering OnSettingChanged().
+   */
+  void Refresh();
+  /*!
+   \brief Stops updating all handles created so far.
+   */
+  void Clear();
+
+  // implementation of ISettingCallback
+  void OnSettingChanged(std::shared_ptr<const CSetting> setting) override;
+
+private:
+  CSettingHandles(const CSettingHandles&) = delete;
+  CSettingHandles& operator=(const CSettingHandles&) = delete;
+
+  struct Handle
+  {
+    std::shared_ptr<const CSetting> setting;
+    std::shared_ptr<CSettingBoolHandle> boolHandle;
+    std::shared_ptr<CSettingIntHandle> intHandle;
+    std::shared_ptr<CSettingNumberHandle> numberHandle;
+  };
+
+  bool Create(const std::string& id, Handle& handle);
+  static void Update(Handle& handle, const CSetting& setting);
+
+  CSettingsManager& m_settingsManager;
+  CCriticalSection m_critical;
+  std::map<std::string, Handle> m_handles;
+};
@@ -72,6 +72,7 @@
 #include "utils/StringUtils.h"
 #include "utils/SystemInfo.h"
 #include "utils/XBMCTinyXML.h"
+#include "utils/XMLBinaryCache.h"
 #include "SeekHandler.h"
 #include "utils/Variant.h"
 #include "view/ViewStateSettings.h"
@@ -471,7 +472,7 @@ bool CSettings::Load(const std::string &file)
 {
   CXBMCTinyXML xmlDoc;
   bool updated = false;
-  if (!XFILE::CFile::Exists(file) || !xmlDoc.LoadFile(file) ||
+  if (!XFILE::CFile::Exists(file) || !CXMLBinaryCache::LoadFile(file, xmlDoc) ||
       !LoadValuesFromXml(xmlDoc, updated))
   {
     CLog::Log(LOGERROR, "CSettings: unable to load settings from %s, creating new default settings", file.c_str());
@@ -521,7 +522,7 @@ bool CSettings::GetBool(const std::string& id) const
 bool CSettings::Initialize(const std::string &file)
 {
   CXBMCTinyXML xmlDoc;
-  if (!xmlDoc.LoadFile(file.c_str()))
+  if (!CXMLBinaryCache::LoadFile(file, xmlDoc))
   {
     CLog::Log(LOGERROR, "CSettings: error loading settings definition from %s, Line %d\n%s", file.c_str(), xmlDoc.ErrorRow(), xmlDoc.ErrorDesc());
     return false;
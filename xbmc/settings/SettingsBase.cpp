@@ -30,6 +30,7 @@
 CSettingsBase::CSettingsBase()
   : m_initialized(false)
   , m_settingsManager(new CSettingsManager())
+  , m_settingHandles(new CSettingHandles(*m_settingsManager))
 { }
 
 CSettingsBase::~CSettingsBase()
@@ -117,6 +118,9 @@ bool CSettingsBase::LoadHiddenValuesFromXml(const TiXmlElement* root)
 void CSettingsBase::SetLoaded()
 {
   m_settingsManager->SetLoaded();
+
+  // loading values doesn't trigger any callbacks
+  m_settingHandles->Refresh();
 }
 
 bool CSettingsBase::IsLoaded() const
@@ -137,6 +141,7 @@ bool CSettingsBase::SaveValuesToXml(CXBMCTinyXML& xml) const
 void CSettingsBase::Unload()
 {
   m_settingsManager->Unload();
+  m_settingHandles->Refresh();
 }
 
 void CSettingsBase::Uninitialize()
@@ -153,6 +158,7 @@ void CSettingsBase::Uninitialize()
 
   // unregister ISettingCallback implementations
   UninitializeISettingCallbacks();
+  m_settingHandles->Clear();
 
   // cleanup the settings manager
   m_settingsManager->Clear();
@@ -250,6 +256,21 @@ std::vector<CVariant> CSettingsBase::GetList(const std::string& id) const
   return CSettingUtils::GetList(std::static_pointer_cast<CSettingList>(setting));
 }
 
+SettingBoolHandlePtr CSettingsBase::GetBoolHandle(const std::string& id)
+{
+  return m_settingHandles->GetBool(id);
+}
+
+SettingIntHandlePtr CSettingsBase::GetIntHandle(const std::string& id)
+{
+  return m_settingHandles->GetInt(id);
+}
+
+SettingNumberHandlePtr CSettingsBase::GetNumberHandle(const std::string& id)
+{
+  return m_settingHandles->GetNumber(id);
+}
+
 bool CSettingsBase::SetList(const std::string& id, const std::vector<CVariant>& value)
 {
   std::shared_ptr<CSetting> setting = m_settingsManager->GetSetting(id);
@@ -19,10 +19,12 @@
  *
  */
 
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "settings/SettingHandle.h"
 #include "settings/lib/ISettingCallback.h"
 #include "threads/CriticalSection.h"
 
@@ -167,6 +169,38 @@ public:
    */
   std::vector<CVariant> GetList(const std::string& id) const;
 
+  /*!
+   \brief Gets a handle to the boolean value of the setting with the given
+   identifier.
+
+   Reading the value through the handle avoids the string keyed lookup of
+   GetBool() and is meant for code paths reading the setting very often.
+   Handles should be retrieved once (e.g. when opening a player) and not
+   from within ISettingCallback implementations.
+
+   \param id Setting identifier
+   \return Handle to the value of the setting with the given identifier
+   */
+  SettingBoolHandlePtr GetBoolHandle(const std::string& id);
+  /*!
+   \brief Gets a handle to the integer value of the setting with the given
+   identifier.
+
+   \param id Setting identifier
+   \return Handle to the value of the setting with the given identifier
+   \sa GetBoolHandle()
+   */
+  SettingIntHandlePtr GetIntHandle(const std::string& id);
+  /*!
+   \brief Gets a handle to the real number value of the setting with the
+   given identifier.
+
+   \param id Setting identifier
+   \return Handle to the value of the setting with the given identifier
+   \sa GetBoolHandle()
+   */
+  SettingNumberHandlePtr GetNumberHandle(const std::string& id);
+
   /*!
    \brief Sets the boolean value of the setting with the given identifier.
 
@@ -285,6 +319,8 @@ protected:
   CSettingsManager* m_settingsManager;
   CCriticalSection m_critical;
 private:
+  std::unique_ptr<CSettingHandles> m_settingHandles;
+
   CSettingsBase(const CSettingsBase&) = delete;
   CSettingsBase& operator=(const CSettingsBase&) = delete;
 };
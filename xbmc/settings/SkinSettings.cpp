@@ -60,6 +60,7 @@ const std::string& CSkinSettings::GetString(int setting) const
 void CSkinSettings::SetString(int setting, const std::string &label)
 {
   g_SkinInfo->SetString(setting, label);
+  CServiceBroker::GetGUI()->GetInfoManager().ResetSkinSettingsCache();
 }
 
 int CSkinSettings::TranslateBool(const std::string &setting)
@@ -75,11 +76,13 @@ bool CSkinSettings::GetBool(int setting) const
 void CSkinSettings::SetBool(int setting, bool set)
 {
   g_SkinInfo->SetBool(setting, set);
+  CServiceBroker::GetGUI()->GetInfoManager().ResetSkinSettingsCache();
 }
 
 void CSkinSettings::Reset(const std::string &setting)
 {
   g_SkinInfo->Reset(setting);
+  CServiceBroker::GetGUI()->GetInfoManager().ResetSkinSettingsCache();
 }
 
 void CSkinSettings::Reset()
@@ -88,6 +91,7 @@ void CSkinSettings::Reset()
 
   CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
   infoMgr.ResetCache();
+  infoMgr.ResetSkinSettingsCache();
   infoMgr.GetInfoProviders().GetGUIControlsInfoProvider().ResetContainerMovingCache();
 }
 
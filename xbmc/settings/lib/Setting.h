@@ -116,7 +116,7 @@ protected:
   SettingDependencies m_dependencies;
   std::set<CSettingUpdate> m_updates;
   bool m_changed = false;
-  CSharedSection m_critical;
+  CSharedSection m_critical{"CSetting"};
 };
 
 template<typename TValue, SettingType TSettingType>
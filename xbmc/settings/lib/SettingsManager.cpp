@@ -552,6 +552,8 @@ SettingPtr CSettingsManager::GetSetting(const std::string &id) const
   if (id.empty())
     return nullptr;
 
+  m_lookupCount.fetch_add(1, std::memory_order_relaxed);
+
   auto setting = FindSetting(id);
   if (setting != m_settings.end())
     return setting->second.setting;
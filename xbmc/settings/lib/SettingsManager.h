@@ -19,6 +19,7 @@
  *
  */
 
+#include <atomic>
 #include <map>
 #include <set>
 #include <vector>
@@ -292,6 +293,16 @@ public:
    \return Setting object with the given identifier or nullptr if the identifier is unknown
    */
   std::shared_ptr<CSetting> GetSetting(const std::string &id) const;
+  /*!
+   \brief Gets the number of string keyed setting lookups performed so far.
+
+   Every call to GetSetting() (and therefore every GetBool(), GetInt() etc.)
+   counts as one lookup. Comparing two values over a period of time shows how
+   often the settings map is searched by hot code paths.
+
+   \return Number of setting lookups since the settings manager was created
+   */
+  uint64_t GetLookupCount() const { return m_lookupCount.load(std::memory_order_relaxed); }
   /*!
    \brief Gets the full list of setting sections.
 
@@ -513,6 +524,7 @@ private:
 
   bool m_initialized = false;
   bool m_loaded = false;
+  mutable std::atomic<uint64_t> m_lookupCount{0};
 
   SettingMap m_settings;
   using SettingSectionMap = std::map<std::string, std::shared_ptr<CSettingSection>>;
@@ -537,6 +549,6 @@ private:
   using SettingOptionsFillerMap = std::map<std::string, SettingOptionsFiller>;
   SettingOptionsFillerMap m_optionsFillers;
 
-  CSharedSection m_critical;
-  CSharedSection m_settingsCritical;
+  CSharedSection m_critical{"CSettingsManager"};
+  CSharedSection m_settingsCritical{"CSettingsManager::settings"};
 };
@@ -0,0 +1,100 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ServiceBroker.h"
+#include "settings/Settings.h"
+#include "settings/lib/SettingsManager.h"
+
+#include "gtest/gtest.h"
+
+class TestSettingHandle : public testing::Test
+{
+protected:
+  TestSettingHandle()
+  {
+    // setting callbacks are only executed for loaded settings
+    CServiceBroker::GetSettings().SetLoaded();
+  }
+
+  ~TestSettingHandle() override
+  {
+    CServiceBroker::GetSettings().Unload();
+  }
+};
+
+TEST_F(TestSettingHandle, FollowsValueChanges)
+{
+  CSettings& settings = CServiceBroker::GetSettings();
+
+  SettingBoolHandlePtr boolHandle = settings.GetBoolHandle(CSettings::SETTING_SUBTITLES_PARSECAPTIONS);
+  SettingIntHandlePtr intHandle = settings.GetIntHandle(CSettings::SETTING_VIDEOPLAYER_ERRORINASPECT);
+  ASSERT_TRUE(boolHandle != nullptr);
+  ASSERT_TRUE(intHandle != nullptr);
+  EXPECT_EQ(settings.GetBool(CSettings::SETTING_SUBTITLES_PARSECAPTIONS), boolHandle->GetValue());
+  EXPECT_EQ(settings.GetInt(CSettings::SETTING_VIDEOPLAYER_ERRORINASPECT), intHandle->GetValue());
+
+  bool value = !boolHandle->GetValue();
+  EXPECT_TRUE(settings.SetBool(CSettings::SETTING_SUBTITLES_PARSECAPTIONS, value));
+  EXPECT_EQ(value, boolHandle->GetValue());
+  EXPECT_TRUE(settings.SetInt(CSettings::SETTING_VIDEOPLAYER_ERRORINASPECT, 10));
+  EXPECT_EQ(10, intHandle->GetValue());
+
+  // handles for the same setting are shared
+  EXPECT_EQ(boolHandle, settings.GetBoolHandle(CSettings::SETTING_SUBTITLES_PARSECAPTIONS));
+
+  // resetting the values doesn't trigger callbacks but is reflected as well
+  settings.Unload();
+  EXPECT_EQ(settings.GetBool(CSettings::SETTING_SUBTITLES_PARSECAPTIONS), boolHandle->GetValue());
+  EXPECT_EQ(settings.GetInt(CSettings::SETTING_VIDEOPLAYER_ERRORINASPECT), intHandle->GetValue());
+}
+
+TEST_F(TestSettingHandle, UnknownSetting)
+{
+  CSettings& settings = CServiceBroker::GetSettings();
+
+  SettingBoolHandlePtr unknown = settings.GetBoolHandle("unknown.setting");
+  ASSERT_TRUE(unknown != nullptr);
+  EXPECT_FALSE(unknown->GetValue());
+
+  // wrong type
+  SettingIntHandlePtr wrongType = settings.GetIntHandle(CSettings::SETTING_SUBTITLES_PARSECAPTIONS);
+  ASSERT_TRUE(wrongType != nullptr);
+  EXPECT_EQ(0, wrongType->GetValue());
+}
+
+TEST_F(TestSettingHandle, ReadsWithoutLookup)
+{
+  static const int reads = 1000;
+  CSettings& settings = CServiceBroker::GetSettings();
+  const CSettingsManager* settingsManager = settings.GetSettingsManager();
+  SettingIntHandlePtr handle = settings.GetIntHandle(CSettings::SETTING_VIDEOPLAYER_ERRORINASPECT);
+  int sum = 0;
+
+  uint64_t lookups = settingsManager->GetLookupCount();
+  for (int i = 0; i < reads; i++)
+    sum += settings.GetInt(CSettings::SETTING_VIDEOPLAYER_ERRORINASPECT);
+  EXPECT_EQ(static_cast<uint64_t>(reads), settingsManager->GetLookupCount() - lookups);
+
+  lookups = settingsManager->GetLookupCount();
+  for (int i = 0; i < reads; i++)
+    sum -= handle->GetValue();
+  EXPECT_EQ(lookups, settingsManager->GetLookupCount());
+  EXPECT_EQ(0, sum);
+}
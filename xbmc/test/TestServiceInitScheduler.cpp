@@ -0,0 +1,76 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ServiceInitScheduler.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+TEST(TestServiceInitScheduler, DependencyOrder)
+{
+  CServiceInitScheduler scheduler("test");
+  std::atomic<int> counter(0);
+  int a = -1, b = -1, c = -1, d = -1;
+
+  scheduler.Add("a", {}, [&]() { a = counter++; return true; }, true);
+  scheduler.Add("b", { "a" }, [&]() { b = counter++; return true; });
+  scheduler.Add("c", { "a" }, [&]() { c = counter++; return true; }, true);
+  scheduler.Add("d", { "b", "c" }, [&]() { d = counter++; return true; });
+
+  EXPECT_TRUE(scheduler.Run());
+  EXPECT_EQ(4, counter);
+  EXPECT_LT(a, b);
+  EXPECT_LT(a, c);
+  EXPECT_LT(b, d);
+  EXPECT_LT(c, d);
+
+  unsigned int recorded = 0;
+  for (const auto &record : CServiceInitScheduler::GetTimeline())
+  {
+    if (record.stage != "test")
+      continue;
+    recorded++;
+    EXPECT_LE(record.start, record.end);
+    EXPECT_TRUE(record.success);
+  }
+  EXPECT_EQ(4U, recorded);
+}
+
+TEST(TestServiceInitScheduler, FailureStopsDependents)
+{
+  CServiceInitScheduler scheduler("failure");
+  bool dependentRan = false;
+
+  scheduler.Add("broken", {}, []() { return false; }, true);
+  scheduler.Add("dependent", { "broken" }, [&]() { dependentRan = true; return true; });
+
+  EXPECT_FALSE(scheduler.Run());
+  EXPECT_FALSE(dependentRan);
+}
+
+TEST(TestServiceInitScheduler, UnknownDependency)
+{
+  CServiceInitScheduler scheduler("unknown");
+  scheduler.Add("a", { "missing" }, []() { return true; });
+  EXPECT_FALSE(scheduler.Run());
+}
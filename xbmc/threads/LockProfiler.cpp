@@ -0,0 +1,135 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <sstream>
+
+#include "LockProfiler.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/log.h"
+
+namespace
+{
+CCriticalSection& ProfilerSection()
+{
+  static CCriticalSection section;
+  return section;
+}
+
+std::map<std::string, LockStatistics>& Statistics()
+{
+  static std::map<std::string, LockStatistics> statistics;
+  return statistics;
+}
+
+std::map<std::thread::id, std::string>& ThreadNames()
+{
+  static std::map<std::thread::id, std::string> names;
+  return names;
+}
+}
+
+bool CLockProfiler::IsEnabled()
+{
+#ifdef HAS_LOCK_PROFILING
+  return true;
+#else
+  return false;
+#endif
+}
+
+void CLockProfiler::RegisterThread()
+{
+  static thread_local bool registered = false;
+  if (registered)
+    return;
+  registered = true;
+
+  std::string name;
+  CThread *thread = CThread::GetCurrentThread();
+  if (thread != nullptr)
+    name = thread->GetName();
+  else
+  {
+    std::ostringstream id;
+    id << "thread " << std::this_thread::get_id();
+    name = id.str();
+  }
+
+  CSingleLock lock(ProfilerSection());
+  ThreadNames()[std::this_thread::get_id()] = name;
+}
+
+void CLockProfiler::RecordWait(const char *name, bool readers, std::thread::id holder, int64_t waitTime)
+{
+  CSingleLock lock(ProfilerSection());
+
+  LockStatistics &statistics = Statistics()[name];
+  if (statistics.name.empty())
+    statistics.name = name;
+  statistics.contentions++;
+  statistics.waitTime += waitTime;
+  statistics.maxWaitTime = std::max(statistics.maxWaitTime, waitTime);
+
+  std::string holderName = "unknown";
+  if (readers)
+    holderName = "readers";
+  else
+  {
+    std::map<std::thread::id, std::string>::const_iterator thread = ThreadNames().find(holder);
+    if (thread != ThreadNames().end())
+      holderName = thread->second;
+  }
+  statistics.holders[holderName]++;
+}
+
+std::vector<LockStatistics> CLockProfiler::GetStatistics()
+{
+  std::vector<LockStatistics> result;
+  {
+    CSingleLock lock(ProfilerSection());
+    for (const auto &statistics : Statistics())
+      result.push_back(statistics.second);
+  }
+
+  std::sort(result.begin(), result.end(), [](const LockStatistics &lhs, const LockStatistics &rhs)
+  {
+    return lhs.waitTime > rhs.waitTime;
+  });
+  return result;
+}
+
+void CLockProfiler::Log()
+{
+  if (!IsEnabled())
+    return;
+
+  for (const auto &statistics : GetStatistics())
+  {
+    CLog::Log(LOGNOTICE, "LockProfiler: %s contended %llu times, waited %.3f ms in total, %.3f ms at most",
+              statistics.name.c_str(), static_cast<unsigned long long>(statistics.contentions),
+              statistics.waitTime / 1000.0, statistics.maxWaitTime / 1000.0);
+    for (const auto &holder : statistics.holders)
+      CLog::Log(LOGNOTICE, "LockProfiler:   held by %s %llu times",
+                holder.first.c_str(), static_cast<unsigned long long>(holder.second));
+  }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*!
+ \brief Contention recorded for all sections sharing a name
+ */
+struct LockStatistics
+{
+  std::string name;
+  uint64_t contentions = 0;
+  int64_t waitTime = 0;     ///< microseconds spent waiting in total
+  int64_t maxWaitTime = 0;
+  std::map<std::string, uint64_t> holders;  ///< contentions per thread holding the section
+};
+
+/*!
+ \brief Collects the time threads wait for named shared sections.
+
+ Only builds with HAS_LOCK_PROFILING (cmake -DENABLE_LOCK_PROFILING=ON) record
+ anything. Uncontended acquisitions are not recorded.
+ */
+class CLockProfiler
+{
+public:
+  static bool IsEnabled();
+
+  /*!
+   \brief Remember the name of the calling thread so it can be reported as holder
+   */
+  static void RegisterThread();
+
+  /*!
+   \brief Record a wait for a named section
+   \param readers true if the section was held by readers
+   \param holder thread holding the section exclusively when the wait started
+   \param waitTime microseconds
+   */
+  static void RecordWait(const char *name, bool readers, std::thread::id holder, int64_t waitTime);
+
+  static std::vector<LockStatistics> GetStatistics();
+
+  /*!
+   \brief Write the statistics of all sections to the log
+   */
+  static void Log();
+};
@@ -0,0 +1,138 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SharedSection.h"
+
+#ifdef HAS_LOCK_PROFILING
+#include <chrono>
+#endif
+
+// number of attempts to claim a contended section before the thread parks
+#define SHARED_SECTION_SPIN_COUNT 100
+
+void CSharedSection::unlock()
+{
+  if (--m_recursion > 0)
+    return;
+
+  // shared locks the owner still holds become ordinary readers
+  unsigned int readers = m_ownerShared;
+  m_ownerShared = 0;
+  m_owner.store(std::thread::id(), std::memory_order_relaxed);
+  m_state.exchange(readers);
+  Wake();
+}
+
+bool CSharedSection::try_lock_shared()
+{
+  if (m_owner.load(std::memory_order_relaxed) == std::this_thread::get_id())
+  {
+    m_ownerShared++;
+    return true;
+  }
+
+  unsigned int state = m_state.load(std::memory_order_relaxed);
+  while (!(state & WRITER))
+  {
+    if (m_state.compare_exchange_weak(state, state + 1, std::memory_order_acquire))
+      return true;
+  }
+  return false;
+}
+
+void CSharedSection::LockSlow()
+{
+#ifdef HAS_LOCK_PROFILING
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  bool readers = (m_state.load(std::memory_order_relaxed) & WRITER) == 0;
+  std::thread::id holder = m_owner.load(std::memory_order_relaxed);
+#endif
+
+  for (unsigned int spin = 0; ; spin++)
+  {
+    unsigned int expected = 0;
+    if (m_state.load(std::memory_order_relaxed) == 0 &&
+        m_state.compare_exchange_weak(expected, WRITER, std::memory_order_acquire))
+      break;
+
+    if (spin < SHARED_SECTION_SPIN_COUNT)
+      continue;
+
+    CSingleLock lock(m_parkSection);
+    m_parked++;
+    while (m_state.load() != 0)
+      m_parkCondition.wait(lock);
+    m_parked--;
+  }
+
+#ifdef HAS_LOCK_PROFILING
+  if (m_name)
+    CLockProfiler::RecordWait(m_name, readers, holder,
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+#endif
+}
+
+void CSharedSection::LockSharedSlow()
+{
+#ifdef HAS_LOCK_PROFILING
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::thread::id holder = m_owner.load(std::memory_order_relaxed);
+  bool contended = false;
+#endif
+
+  for (unsigned int spin = 0; ; spin++)
+  {
+    unsigned int state = m_state.load(std::memory_order_relaxed);
+    if (!(state & WRITER))
+    {
+      // only lost a race against another reader
+      if (m_state.compare_exchange_weak(state, state + 1, std::memory_order_acquire))
+        break;
+      continue;
+    }
+
+#ifdef HAS_LOCK_PROFILING
+    contended = true;
+#endif
+    if (spin < SHARED_SECTION_SPIN_COUNT)
+      continue;
+
+    CSingleLock lock(m_parkSection);
+    m_parked++;
+    while (m_state.load() & WRITER)
+      m_parkCondition.wait(lock);
+    m_parked--;
+  }
+
+#ifdef HAS_LOCK_PROFILING
+  if (m_name && contended)
+    CLockProfiler::RecordWait(m_name, false, holder,
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+#endif
+}
+
+void CSharedSection::Wake()
+{
+  if (m_parked.load() == 0)
+    return;
+
+  CSingleLock lock(m_parkSection);
+  m_parkCondition.notifyAll();
+}
@@ -20,31 +20,126 @@
  *
  */
 
+#include <atomic>
+#include <thread>
+
 #include "threads/Condition.h"
+#include "threads/CriticalSection.h"
 #include "threads/SingleLock.h"
 #include "threads/Helpers.h"
+#ifdef HAS_LOCK_PROFILING
+#include "threads/LockProfiler.h"
+#endif
 
 /**
  * A CSharedSection is a mutex that satisfies the Shared Lockable concept (see Lockables.h).
+ *
+ * Readers and the writer claim the section with a single atomic operation as
+ * long as it is free. A reader only waits while a writer holds the section, so
+ * waiting writers never block new readers. Contended threads spin for a short
+ * while before they park on a condition variable.
+ *
+ * The exclusive lock is recursive and its owner may also take shared locks.
+ *
+ * When built with HAS_LOCK_PROFILING the time spent waiting for a named section
+ * is recorded by CLockProfiler.
  */
 class CSharedSection
 {
-  CCriticalSection sec;
-  XbmcThreads::ConditionVariable actualCv;
-  XbmcThreads::TightConditionVariable<XbmcThreads::InversePredicate<unsigned int&> > cond;
+  CSharedSection(const CSharedSection&) = delete;
+  CSharedSection& operator=(const CSharedSection&) = delete;
+
+  static const unsigned int WRITER = 0x80000000;
+
+  std::atomic<unsigned int> m_state;  // WRITER bit and number of readers
+  std::atomic<std::thread::id> m_owner;
+  unsigned int m_recursion;            // only touched by the owner
+  unsigned int m_ownerShared;          // shared locks taken by the owner
+
+  std::atomic<unsigned int> m_parked;
+  CCriticalSection m_parkSection;
+  XbmcThreads::ConditionVariable m_parkCondition;
+
+  const char *m_name;
+
+  void LockSlow();
+  void LockSharedSlow();
+  void Wake();
 
-  unsigned int sharedCount;
+  inline void Acquired()
+  {
+    m_owner.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    m_recursion = 1;
+#ifdef HAS_LOCK_PROFILING
+    CLockProfiler::RegisterThread();
+#endif
+  }
 
 public:
-  inline CSharedSection() : cond(actualCv,XbmcThreads::InversePredicate<unsigned int&>(sharedCount)), sharedCount(0)  {}
+  /**
+   * @param name identifies the section in lock profiling builds, sections
+   * sharing a name are profiled together
+   */
+  inline explicit CSharedSection(const char *name = nullptr)
+    : m_state(0), m_recursion(0), m_ownerShared(0), m_parked(0), m_name(name) {}
+
+  inline void lock()
+  {
+    if (m_owner.load(std::memory_order_relaxed) == std::this_thread::get_id())
+    {
+      m_recursion++;
+      return;
+    }
+
+    unsigned int expected = 0;
+    if (!m_state.compare_exchange_strong(expected, WRITER, std::memory_order_acquire))
+      LockSlow();
+    Acquired();
+  }
+
+  inline bool try_lock()
+  {
+    if (m_owner.load(std::memory_order_relaxed) == std::this_thread::get_id())
+    {
+      m_recursion++;
+      return true;
+    }
+
+    unsigned int expected = 0;
+    if (!m_state.compare_exchange_strong(expected, WRITER, std::memory_order_acquire))
+      return false;
+    Acquired();
+    return true;
+  }
+
+  void unlock();
+
+  inline void lock_shared()
+  {
+    if (m_owner.load(std::memory_order_relaxed) == std::this_thread::get_id())
+    {
+      m_ownerShared++;
+      return;
+    }
+
+    unsigned int state = m_state.load(std::memory_order_relaxed);
+    if ((state & WRITER) || !m_state.compare_exchange_strong(state, state + 1, std::memory_order_acquire))
+      LockSharedSlow();
+  }
+
+  bool try_lock_shared();
 
-  inline void lock() { CSingleLock l(sec); while (sharedCount) cond.wait(l); sec.lock(); }
-  inline bool try_lock() { return (sec.try_lock() ? ((sharedCount == 0) ? true : (sec.unlock(), false)) : false); }
-  inline void unlock() { sec.unlock(); }
+  inline void unlock_shared()
+  {
+    if (m_owner.load(std::memory_order_relaxed) == std::this_thread::get_id())
+    {
+      m_ownerShared--;
+      return;
+    }
 
-  inline void lock_shared() { CSingleLock l(sec); sharedCount++; }
-  inline bool try_lock_shared() { return (sec.try_lock() ? sharedCount++, sec.unlock(), true : false); }
-  inline void unlock_shared() { CSingleLock l(sec); sharedCount--; if (!sharedCount) { cond.notifyAll(); } }
+    if (m_state.fetch_sub(1) == 1)
+      Wake();
+  }
 };
 
 class CSharedLock : public XbmcThreads::SharedLock<CSharedSection>
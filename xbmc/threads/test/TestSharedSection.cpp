@@ -25,6 +25,8 @@
 #include "threads/test/TestHelpers.h"
 
 #include <stdio.h>
+#include <thread>
+#include <vector>
 
 //=============================================================================
 // Helper classes
@@ -222,3 +224,79 @@ TEST(TestMultipleSharedSection, General)
   }
 }
 
+
+TEST(TestSharedSection, ExclusiveOwnerCanNestLocks)
+{
+  CSharedSection sec;
+
+  {
+    CExclusiveLock l1(sec);
+    CExclusiveLock l2(sec);
+    CSharedLock l3(sec);
+    EXPECT_TRUE(l3.IsOwner());
+
+    // nobody else gets in while the owner holds any of them
+    bool obtained = true;
+    std::thread other([&sec, &obtained]() { obtained = sec.try_lock_shared(); });
+    other.join();
+    EXPECT_FALSE(obtained);
+  }
+
+  EXPECT_TRUE(sec.try_lock());
+  sec.unlock();
+}
+
+TEST(TestSharedSection, SharedLockOutlivesExclusiveLock)
+{
+  CSharedSection sec;
+
+  sec.lock();
+  sec.lock_shared();
+  sec.unlock();
+
+  // the remaining shared lock still keeps writers out
+  EXPECT_FALSE(sec.try_lock());
+  EXPECT_TRUE(sec.try_lock_shared());
+  sec.unlock_shared();
+
+  sec.unlock_shared();
+  EXPECT_TRUE(sec.try_lock());
+  sec.unlock();
+}
+
+TEST(TestSharedSection, ReadersNeverSeeHalfWrites)
+{
+  CSharedSection sec;
+  unsigned int first = 0;
+  unsigned int second = 0;
+  std::atomic<unsigned int> torn(0);
+
+  std::vector<std::thread> threads;
+  for (unsigned int index = 0; index < 4; index++)
+  {
+    threads.emplace_back([&, index]()
+    {
+      for (unsigned int iteration = 0; iteration < 20000; iteration++)
+      {
+        if ((iteration + index) % 8 == 0)
+        {
+          CExclusiveLock lock(sec);
+          first++;
+          second++;
+        }
+        else
+        {
+          CSharedLock lock(sec);
+          if (first != second)
+            torn++;
+        }
+      }
+    });
+  }
+  for (auto &worker : threads)
+    worker.join();
+
+  EXPECT_EQ(0u, torn);
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(4u * 20000u / 8u, first);
+}
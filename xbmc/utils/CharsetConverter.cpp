@@ -301,6 +301,23 @@ public:
   template<class INPUT,class OUTPUT>
   static bool convert(iconv_t type, int multiplier, const INPUT& strSource, OUTPUT& strDest, bool failOnInvalidChar = false);
 
+  /* Conversions between Unicode encodings don't need iconv and its lock.
+     Each overload returns false if it doesn't handle convertType, else
+     the result of the conversion is stored in result. */
+  template<class INPUT,class OUTPUT>
+  static bool nativeConvert(StdConversionType convertType, const INPUT& strSource, OUTPUT& strDest, bool failOnInvalidChar, bool& result)
+  {
+    return false;
+  }
+  static bool nativeConvert(StdConversionType convertType, const std::string& strSource, std::u32string& strDest, bool failOnInvalidChar, bool& result);
+  static bool nativeConvert(StdConversionType convertType, const std::string& strSource, std::wstring& strDest, bool failOnInvalidChar, bool& result);
+  static bool nativeConvert(StdConversionType convertType, const std::u32string& strSource, std::string& strDest, bool failOnInvalidChar, bool& result);
+  static bool nativeConvert(StdConversionType convertType, const std::u32string& strSource, std::wstring& strDest, bool failOnInvalidChar, bool& result);
+  static bool nativeConvert(StdConversionType convertType, const std::wstring& strSource, std::string& strDest, bool failOnInvalidChar, bool& result);
+  static bool nativeConvert(StdConversionType convertType, const std::wstring& strSource, std::u32string& strDest, bool failOnInvalidChar, bool& result);
+  static bool nativeConvert(StdConversionType convertType, const std::u16string& strSource, std::string& strDest, bool failOnInvalidChar, bool& result);
+  static bool nativeConvert(StdConversionType convertType, const std::u16string& strSource, std::wstring& strDest, bool failOnInvalidChar, bool& result);
+
   static CConverterType m_stdConversion[NumberOfStdConversionTypes];
   static CCriticalSection m_critSectionFriBiDi;
 };
@@ -343,6 +360,10 @@ bool CCharsetConverter::CInnerConverter::stdConvert(StdConversionType convertTyp
   if (convertType < 0 || convertType >= NumberOfStdConversionTypes)
     return false;
 
+  bool result;
+  if (nativeConvert(convertType, strSource, strDest, failOnInvalidChar, result))
+    return result;
+
   CConverterType& convType = m_stdConversion[convertType];
   CSingleLock converterLock(convType);
 
@@ -370,6 +391,100 @@ bool CCharsetConverter::CInnerConverter::customConvert(const std::string& source
   return result;
 }
 
+/* UTF-8-MAC also composes decomposed sequences, so that one is left to iconv */
+#if !defined(TARGET_DARWIN)
+#define NATIVE_UTF8_SOURCE 1
+#endif
+
+bool CCharsetConverter::CInnerConverter::nativeConvert(StdConversionType convertType, const std::string& strSource, std::u32string& strDest, bool failOnInvalidChar, bool& result)
+{
+#ifdef NATIVE_UTF8_SOURCE
+  if (convertType == Utf8ToUtf32)
+  {
+    result = CUtf8Utils::Utf8ToUtf32(strSource, strDest, failOnInvalidChar);
+    return true;
+  }
+#endif
+  return false;
+}
+
+bool CCharsetConverter::CInnerConverter::nativeConvert(StdConversionType convertType, const std::string& strSource, std::wstring& strDest, bool failOnInvalidChar, bool& result)
+{
+#ifdef NATIVE_UTF8_SOURCE
+  if (convertType == Utf8toW)
+  {
+    result = CUtf8Utils::Utf8ToW(strSource, strDest, failOnInvalidChar);
+    return true;
+  }
+#endif
+  return false;
+}
+
+bool CCharsetConverter::CInnerConverter::nativeConvert(StdConversionType convertType, const std::u32string& strSource, std::string& strDest, bool failOnInvalidChar, bool& result)
+{
+  if (convertType == Utf32ToUtf8)
+  {
+    result = CUtf8Utils::Utf32ToUtf8(strSource, strDest, failOnInvalidChar);
+    return true;
+  }
+  return false;
+}
+
+bool CCharsetConverter::CInnerConverter::nativeConvert(StdConversionType convertType, const std::u32string& strSource, std::wstring& strDest, bool failOnInvalidChar, bool& result)
+{
+  if (convertType == Utf32ToW)
+  {
+    result = CUtf8Utils::Utf32ToW(strSource, strDest, failOnInvalidChar);
+    return true;
+  }
+  return false;
+}
+
+bool CCharsetConverter::CInnerConverter::nativeConvert(StdConversionType convertType, const std::wstring& strSource, std::string& strDest, bool failOnInvalidChar, bool& result)
+{
+  if (convertType == WtoUtf8)
+  {
+    result = CUtf8Utils::WToUtf8(strSource, strDest, failOnInvalidChar);
+    return true;
+  }
+  return false;
+}
+
+bool CCharsetConverter::CInnerConverter::nativeConvert(StdConversionType convertType, const std::wstring& strSource, std::u32string& strDest, bool failOnInvalidChar, bool& result)
+{
+  if (convertType == WToUtf32)
+  {
+    result = CUtf8Utils::WToUtf32(strSource, strDest, failOnInvalidChar);
+    return true;
+  }
+  return false;
+}
+
+bool CCharsetConverter::CInnerConverter::nativeConvert(StdConversionType convertType, const std::u16string& strSource, std::string& strDest, bool failOnInvalidChar, bool& result)
+{
+#ifndef WORDS_BIGENDIAN
+  /* std::u16string holds host order code units */
+  if (convertType == Utf16LEtoUtf8)
+  {
+    result = CUtf8Utils::Utf16ToUtf8(strSource, strDest, failOnInvalidChar);
+    return true;
+  }
+#endif
+  return false;
+}
+
+bool CCharsetConverter::CInnerConverter::nativeConvert(StdConversionType convertType, const std::u16string& strSource, std::wstring& strDest, bool failOnInvalidChar, bool& result)
+{
+#ifndef WORDS_BIGENDIAN
+  if (convertType == Utf16LEtoW)
+  {
+    result = CUtf8Utils::Utf16ToW(strSource, strDest, failOnInvalidChar);
+    return true;
+  }
+#endif
+  return false;
+}
+
 /* iconv may declare inbuf to be char** rather than const char** depending on platform and version,
     so provide a wrapper that handles both */
 struct charPtrPtrAdapter
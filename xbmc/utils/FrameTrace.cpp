@@ -0,0 +1,196 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "FrameTrace.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/log.h"
+#include "utils/Variant.h"
+
+std::atomic<bool> CFrameTrace::m_enabled(false);
+std::atomic<int64_t> CFrameTrace::m_since(0);
+
+namespace
+{
+struct TraceEvent
+{
+  std::atomic<const char*> name;
+  std::atomic<int64_t> start;
+  std::atomic<int64_t> end;
+};
+
+struct ThreadBuffer
+{
+  TraceEvent events[FRAME_TRACE_EVENTS];
+  std::atomic<uint64_t> head{0};
+  unsigned int id = 0;
+  std::string name;
+  bool retired = false;
+};
+
+CCriticalSection& RegistrySection()
+{
+  static CCriticalSection section;
+  return section;
+}
+
+std::vector<std::unique_ptr<ThreadBuffer>>& Registry()
+{
+  static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+  return buffers;
+}
+
+// hands the buffer of an ended thread to the next thread that starts tracing
+struct ThreadSlot
+{
+  ThreadBuffer *buffer = nullptr;
+
+  ~ThreadSlot()
+  {
+    if (buffer != nullptr)
+    {
+      CSingleLock lock(RegistrySection());
+      buffer->retired = true;
+    }
+  }
+};
+
+thread_local ThreadSlot threadSlot;
+
+ThreadBuffer* AcquireBuffer()
+{
+  std::string name;
+  CThread *thread = CThread::GetCurrentThread();
+  if (thread != nullptr)
+    name = thread->GetName();
+  else
+  {
+    std::ostringstream id;
+    id << "Thread " << std::this_thread::get_id();
+    name = id.str();
+  }
+
+  CSingleLock lock(RegistrySection());
+  std::vector<std::unique_ptr<ThreadBuffer>> &buffers = Registry();
+  for (auto &buffer : buffers)
+  {
+    if (buffer->retired)
+    {
+      buffer->head = 0;
+      buffer->name = name;
+      buffer->retired = false;
+      return buffer.get();
+    }
+  }
+
+  buffers.emplace_back(new ThreadBuffer());
+  buffers.back()->id = buffers.size();
+  buffers.back()->name = name;
+  return buffers.back().get();
+}
+}
+
+void CFrameTrace::SetEnabled(bool enabled)
+{
+  if (enabled && !m_enabled)
+    m_since = Now();
+  m_enabled = enabled;
+
+  CLog::Log(LOGNOTICE, "CFrameTrace: %s tracing", enabled ? "started" : "stopped");
+}
+
+int64_t CFrameTrace::Now()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void CFrameTrace::Record(const char *name, int64_t start, int64_t end)
+{
+  if (threadSlot.buffer == nullptr)
+    threadSlot.buffer = AcquireBuffer();
+
+  // only this thread writes the buffer, readers check the head afterwards
+  // to drop whatever was overwritten while they read it
+  ThreadBuffer *buffer = threadSlot.buffer;
+  uint64_t head = buffer->head.load(std::memory_order_relaxed);
+  TraceEvent &event = buffer->events[head % FRAME_TRACE_EVENTS];
+  event.name.store(name, std::memory_order_relaxed);
+  event.start.store(start, std::memory_order_relaxed);
+  event.end.store(end, std::memory_order_relaxed);
+  buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void CFrameTrace::Export(CVariant &trace)
+{
+  int64_t since = m_since;
+  trace["displayTimeUnit"] = "ms";
+  trace["traceEvents"] = CVariant(CVariant::VariantTypeArray);
+  CVariant &traceEvents = trace["traceEvents"];
+
+  CSingleLock lock(RegistrySection());
+  for (const auto &buffer : Registry())
+  {
+    CVariant metadata(CVariant::VariantTypeObject);
+    metadata["name"] = "thread_name";
+    metadata["ph"] = "M";
+    metadata["pid"] = 1;
+    metadata["tid"] = buffer->id;
+    metadata["args"]["name"] = buffer->name;
+    traceEvents.push_back(metadata);
+
+    uint64_t head = buffer->head.load(std::memory_order_acquire);
+    uint64_t first = head > FRAME_TRACE_EVENTS ? head - FRAME_TRACE_EVENTS : 0;
+
+    std::vector<std::pair<uint64_t, CVariant>> events;
+    for (uint64_t index = first; index < head; index++)
+    {
+      const TraceEvent &event = buffer->events[index % FRAME_TRACE_EVENTS];
+      int64_t start = event.start.load(std::memory_order_relaxed);
+      if (start < since)
+        continue;
+
+      CVariant traceEvent(CVariant::VariantTypeObject);
+      traceEvent["name"] = event.name.load(std::memory_order_relaxed);
+      traceEvent["ph"] = "X";
+      traceEvent["pid"] = 1;
+      traceEvent["tid"] = buffer->id;
+      traceEvent["ts"] = start;
+      traceEvent["dur"] = event.end.load(std::memory_order_relaxed) - start;
+      events.push_back(std::make_pair(index, traceEvent));
+    }
+
+    // the slot currently being written and everything the thread lapped meanwhile
+    uint64_t overwritten = buffer->head.load(std::memory_order_acquire) + 1;
+    for (const auto &event : events)
+    {
+      if (event.first + FRAME_TRACE_EVENTS >= overwritten)
+        traceEvents.push_back(event.second);
+    }
+  }
+}
+
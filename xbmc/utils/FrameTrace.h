@@ -0,0 +1,98 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <stdint.h>
+
+class CVariant;
+
+// zones kept per thread
+#define FRAME_TRACE_EVENTS 16384
+
+/*!
+ \brief Records timed zones of the GUI, render and player threads.
+
+ Every thread writes into its own ring buffer without taking a lock, once the
+ buffer is full the oldest zones are overwritten. Recording is off by default,
+ a zone then costs a single atomic load. The zones recorded since tracing was
+ enabled can be exported in the Chrome trace event format and opened in
+ chrome://tracing or Perfetto.
+ */
+class CFrameTrace
+{
+public:
+  /*!
+   \brief Start or stop recording, starting discards the zones recorded before
+   */
+  static void SetEnabled(bool enabled);
+  static bool IsEnabled() { return m_enabled.load(std::memory_order_relaxed); }
+
+  /*!
+   \brief Microseconds of a monotonic clock
+   */
+  static int64_t Now();
+
+  /*!
+   \brief Record a zone of the calling thread
+   \param name has to stay valid until the process ends, usually a string literal
+   */
+  static void Record(const char *name, int64_t start, int64_t end);
+
+  /*!
+   \brief Get the recorded zones of all threads
+   \param trace object with a "traceEvents" array
+   */
+  static void Export(CVariant &trace);
+
+private:
+  static std::atomic<bool> m_enabled;
+  static std::atomic<int64_t> m_since;
+};
+
+/*!
+ \brief Records the lifetime of the object as zone of the calling thread
+ */
+class CFrameTraceZone
+{
+public:
+  explicit CFrameTraceZone(const char *name)
+    : m_name(CFrameTrace::IsEnabled() ? name : nullptr),
+      m_start(m_name != nullptr ? CFrameTrace::Now() : 0)
+  { }
+
+  ~CFrameTraceZone()
+  {
+    if (m_name != nullptr)
+      CFrameTrace::Record(m_name, m_start, CFrameTrace::Now());
+  }
+
+  CFrameTraceZone(const CFrameTraceZone&) = delete;
+  CFrameTraceZone& operator=(const CFrameTraceZone&) = delete;
+
+private:
+  const char *m_name;
+  int64_t m_start;
+};
+
+#define FRAME_TRACE_CONCAT2(a, b) a##b
+#define FRAME_TRACE_CONCAT(a, b) FRAME_TRACE_CONCAT2(a, b)
+#define FRAME_TRACE_ZONE(name) CFrameTraceZone FRAME_TRACE_CONCAT(frameTraceZone, __LINE__)(name)
@@ -20,6 +20,266 @@
 
 #include "Utf8Utils.h"
 
+#include <cstring>
+#include <stdint.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+
+/* number of leading US-ASCII bytes in str */
+inline size_t AsciiRunLength(const unsigned char* str, const size_t len)
+{
+  size_t pos = 0;
+#if defined(__SSE2__)
+  while (pos + 16 <= len)
+  {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + pos));
+    if (_mm_movemask_epi8(chunk) != 0)
+      break;
+    pos += 16;
+  }
+#endif
+  while (pos + 8 <= len)
+  {
+    uint64_t word;
+    memcpy(&word, str + pos, sizeof(word));
+    if (word & 0x8080808080808080ULL)
+      break;
+    pos += 8;
+  }
+  while (pos < len && str[pos] < 0x80)
+    pos++;
+
+  return pos;
+}
+
+/* decode one multi-byte sequence, this is an implementation of
+   http://www.unicode.org/versions/Unicode6.2.0/ch03.pdf#G27506
+   returns the length of the sequence or 0 if it is invalid */
+inline size_t DecodeUtf8Sequence(const unsigned char* str, const size_t len, char32_t& codePoint)
+{
+  const unsigned char chr = str[0];
+  size_t seqLen;
+  unsigned char lowerBound = 0x80, upperBound = 0xBF; // valid range of the second byte
+
+  if (chr >= 0xC2 && chr <= 0xDF)
+  {
+    seqLen = 2;
+    codePoint = chr & 0x1F;
+  }
+  else if (chr >= 0xE0 && chr <= 0xEF)
+  {
+    seqLen = 3;
+    codePoint = chr & 0x0F;
+    if (chr == 0xE0)
+      lowerBound = 0xA0; // overlong
+    else if (chr == 0xED)
+      upperBound = 0x9F; // surrogates
+  }
+  else if (chr >= 0xF0 && chr <= 0xF4)
+  {
+    seqLen = 4;
+    codePoint = chr & 0x07;
+    if (chr == 0xF0)
+      lowerBound = 0x90; // overlong
+    else if (chr == 0xF4)
+      upperBound = 0x8F; // above U+10FFFF
+  }
+  else
+    return 0;
+
+  if (seqLen > len || str[1] < lowerBound || str[1] > upperBound)
+    return 0;
+  codePoint = (codePoint << 6) | (str[1] & 0x3F);
+
+  for (size_t i = 2; i < seqLen; i++)
+  {
+    if ((str[i] & 0xC0) != 0x80)
+      return 0;
+    codePoint = (codePoint << 6) | (str[i] & 0x3F);
+  }
+
+  return seqLen;
+}
+
+/* read one code point from a UTF-16 or UTF-32 string
+   returns the number of code units used or 0 if they are invalid */
+template<class INPUT>
+inline size_t ReadCodePoint(const INPUT& str, const size_t pos, char32_t& codePoint)
+{
+  codePoint = static_cast<char32_t>(str[pos]);
+  if (sizeof(typename INPUT::value_type) >= 4)
+    return (codePoint < 0xD800 || (codePoint > 0xDFFF && codePoint <= 0x10FFFF)) ? 1 : 0;
+
+  codePoint &= 0xFFFF;
+  if (codePoint < 0xD800 || codePoint > 0xDFFF)
+    return 1;
+
+  if (codePoint <= 0xDBFF && pos + 1 < str.length())
+  {
+    const char32_t low = static_cast<char32_t>(str[pos + 1]) & 0xFFFF;
+    if (low >= 0xDC00 && low <= 0xDFFF)
+    {
+      codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+      return 2;
+    }
+  }
+
+  return 0; // unpaired surrogate
+}
+
+template<class OUTPUT>
+inline void AppendCodePoint(OUTPUT& str, const char32_t codePoint)
+{
+  typedef typename OUTPUT::value_type CharT;
+  if (sizeof(CharT) >= 4 || codePoint < 0x10000)
+    str.push_back(static_cast<CharT>(codePoint));
+  else
+  {
+    str.push_back(static_cast<CharT>(0xD800 + ((codePoint - 0x10000) >> 10)));
+    str.push_back(static_cast<CharT>(0xDC00 + ((codePoint - 0x10000) & 0x3FF)));
+  }
+}
+
+template<class OUTPUT>
+bool DecodeUtf8(const std::string& src, OUTPUT& dst, bool failOnBadChar)
+{
+  typedef typename OUTPUT::value_type CharT;
+  const unsigned char* const str = reinterpret_cast<const unsigned char*>(src.data());
+  const size_t len = src.length();
+
+  dst.clear();
+  dst.reserve(len); // each code point uses at most as many code units as it has bytes
+
+  size_t pos = 0;
+  while (pos < len)
+  {
+    const size_t asciiLen = AsciiRunLength(str + pos, len - pos);
+    if (asciiLen)
+    {
+      // widen the whole run at once, this loop is vectorised by the compiler
+      const size_t dstPos = dst.length();
+      dst.resize(dstPos + asciiLen);
+      CharT* const out = &dst[dstPos];
+      const unsigned char* const in = str + pos;
+      for (size_t i = 0; i < asciiLen; i++)
+        out[i] = static_cast<CharT>(in[i]);
+
+      pos += asciiLen;
+      if (pos >= len)
+        break;
+    }
+
+    char32_t codePoint;
+    const size_t seqLen = DecodeUtf8Sequence(str + pos, len - pos, codePoint);
+    if (seqLen == 0)
+    {
+      if (failOnBadChar)
+      {
+        dst.clear();
+        return false;
+      }
+      pos++; // skip invalid byte
+      continue;
+    }
+
+    AppendCodePoint(dst, codePoint);
+    pos += seqLen;
+  }
+
+  return true;
+}
+
+template<class INPUT>
+bool EncodeUtf8(const INPUT& src, std::string& dst, bool failOnBadChar)
+{
+  const size_t len = src.length();
+
+  dst.clear();
+  dst.reserve(len);
+
+  size_t pos = 0;
+  while (pos < len)
+  {
+    char32_t codePoint = static_cast<char32_t>(src[pos]);
+    if (codePoint < 0x80)
+    {
+      dst.push_back(static_cast<char>(codePoint));
+      pos++;
+      continue;
+    }
+
+    const size_t units = ReadCodePoint(src, pos, codePoint);
+    if (units == 0)
+    {
+      if (failOnBadChar)
+      {
+        dst.clear();
+        return false;
+      }
+      pos++; // skip invalid code unit
+      continue;
+    }
+    pos += units;
+
+    if (codePoint < 0x800)
+    {
+      dst.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+    }
+    else
+    {
+      if (codePoint < 0x10000)
+        dst.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+      else
+      {
+        dst.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+        dst.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+      }
+      dst.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+    }
+    dst.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+  }
+
+  return true;
+}
+
+template<class INPUT, class OUTPUT>
+bool TranscodeUtf(const INPUT& src, OUTPUT& dst, bool failOnBadChar)
+{
+  const size_t len = src.length();
+
+  dst.clear();
+  dst.reserve(len);
+
+  size_t pos = 0;
+  while (pos < len)
+  {
+    char32_t codePoint;
+    const size_t units = ReadCodePoint(src, pos, codePoint);
+    if (units == 0)
+    {
+      if (failOnBadChar)
+      {
+        dst.clear();
+        return false;
+      }
+      pos++; // skip invalid code unit
+      continue;
+    }
+
+    AppendCodePoint(dst, codePoint);
+    pos += units;
+  }
+
+  return true;
+}
+
+} // unnamed namespace
+
 
 CUtf8Utils::utf8CheckResult CUtf8Utils::checkStrForUtf8(const std::string& str)
 {
@@ -158,3 +418,48 @@ inline size_t CUtf8Utils::SizeOfUtf8Char(const char* const str)
 
   return 0; // invalid UTF-8 char sequence
 }
+
+bool CUtf8Utils::Utf8ToUtf32(const std::string& src, std::u32string& dst, bool failOnBadChar /*= false*/)
+{
+  return DecodeUtf8(src, dst, failOnBadChar);
+}
+
+bool CUtf8Utils::Utf8ToUtf16(const std::string& src, std::u16string& dst, bool failOnBadChar /*= false*/)
+{
+  return DecodeUtf8(src, dst, failOnBadChar);
+}
+
+bool CUtf8Utils::Utf8ToW(const std::string& src, std::wstring& dst, bool failOnBadChar /*= false*/)
+{
+  return DecodeUtf8(src, dst, failOnBadChar);
+}
+
+bool CUtf8Utils::Utf32ToUtf8(const std::u32string& src, std::string& dst, bool failOnBadChar /*= false*/)
+{
+  return EncodeUtf8(src, dst, failOnBadChar);
+}
+
+bool CUtf8Utils::Utf16ToUtf8(const std::u16string& src, std::string& dst, bool failOnBadChar /*= false*/)
+{
+  return EncodeUtf8(src, dst, failOnBadChar);
+}
+
+bool CUtf8Utils::WToUtf8(const std::wstring& src, std::string& dst, bool failOnBadChar /*= false*/)
+{
+  return EncodeUtf8(src, dst, failOnBadChar);
+}
+
+bool CUtf8Utils::Utf32ToW(const std::u32string& src, std::wstring& dst, bool failOnBadChar /*= false*/)
+{
+  return TranscodeUtf(src, dst, failOnBadChar);
+}
+
+bool CUtf8Utils::WToUtf32(const std::wstring& src, std::u32string& dst, bool failOnBadChar /*= false*/)
+{
+  return TranscodeUtf(src, dst, failOnBadChar);
+}
+
+bool CUtf8Utils::Utf16ToW(const std::u16string& src, std::wstring& dst, bool failOnBadChar /*= false*/)
+{
+  return TranscodeUtf(src, dst, failOnBadChar);
+}
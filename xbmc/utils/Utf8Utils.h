@@ -50,6 +50,27 @@ public:
   static size_t RFindValidUtf8Char(const std::string& str, const size_t startPos);
   
   static size_t SizeOfUtf8Char(const std::string& str, const size_t charStart = 0);
+
+  /**
+   * Convert between UTF-8 and UTF-16/UTF-32 without iconv.
+   * These are reentrant and need no locking, runs of ASCII are converted in bulk.
+   * Invalid sequences (overlong forms, surrogates, code points above U+10FFFF,
+   * truncated sequences) are skipped unless failOnBadChar is set.
+   * @param src string to convert
+   * @param dst receives the converted string, cleared on failure
+   * @param failOnBadChar if true, fail on the first invalid sequence
+   * @return true on success, false if an invalid sequence was found and failOnBadChar is set
+   */
+  static bool Utf8ToUtf32(const std::string& src, std::u32string& dst, bool failOnBadChar = false);
+  static bool Utf8ToUtf16(const std::string& src, std::u16string& dst, bool failOnBadChar = false);
+  static bool Utf8ToW(const std::string& src, std::wstring& dst, bool failOnBadChar = false);
+  static bool Utf32ToUtf8(const std::u32string& src, std::string& dst, bool failOnBadChar = false);
+  static bool Utf16ToUtf8(const std::u16string& src, std::string& dst, bool failOnBadChar = false);
+  static bool WToUtf8(const std::wstring& src, std::string& dst, bool failOnBadChar = false);
+  static bool Utf32ToW(const std::u32string& src, std::wstring& dst, bool failOnBadChar = false);
+  static bool WToUtf32(const std::wstring& src, std::u32string& dst, bool failOnBadChar = false);
+  static bool Utf16ToW(const std::u16string& src, std::wstring& dst, bool failOnBadChar = false);
+
 private:
   static size_t SizeOfUtf8Char(const char* const str);
 };
@@ -0,0 +1,362 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "XMLBinaryCache.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#define XML_CACHE_FOLDER  "special://temp/xmlcache/"
+
+namespace
+{
+
+const char CacheMagic[4] = { 'K', 'X', 'B', 'C' };
+// bump whenever the snapshot layout changes
+const uint32_t CacheVersion = 2;
+
+// stored instead of the modification time while it can't be trusted yet
+const int64_t UntrustedMtime = INT64_MIN;
+
+enum NodeTag : uint8_t
+{
+  TagEnd = 0,
+  TagElement,
+  TagText,
+  TagCData,
+  TagDeclaration
+};
+
+struct CacheHeader
+{
+  char magic[4];
+  uint32_t version;
+  uint64_t sourceSize;
+  int64_t sourceMtime;
+  uint32_t sourceCrc;
+  uint32_t dataSize;
+};
+
+// A file modified again within the second it was last modified in keeps its
+// size and modification time. Only trust the time once that second is over,
+// until then the snapshot is validated by its CRC.
+int64_t GetTrustedMtime(int64_t mtime)
+{
+  return time(nullptr) > mtime ? mtime : UntrustedMtime;
+}
+
+void WriteU32(std::string& data, uint32_t value)
+{
+  data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteString(std::string& data, const std::string& value)
+{
+  WriteU32(data, static_cast<uint32_t>(value.size()));
+  data.append(value);
+}
+
+class CReader
+{
+public:
+  CReader(const char* data, size_t size) : m_pos(data), m_end(data + size) { }
+
+  bool ReadTag(uint8_t& tag)
+  {
+    if (m_pos >= m_end)
+      return false;
+    tag = static_cast<uint8_t>(*m_pos++);
+    return true;
+  }
+
+  bool ReadU32(uint32_t& value)
+  {
+    if (static_cast<size_t>(m_end - m_pos) < sizeof(value))
+      return false;
+    memcpy(&value, m_pos, sizeof(value));
+    m_pos += sizeof(value);
+    return true;
+  }
+
+  bool ReadString(std::string& value)
+  {
+    uint32_t length;
+    if (!ReadU32(length) || static_cast<size_t>(m_end - m_pos) < length)
+      return false;
+    value.assign(m_pos, length);
+    m_pos += length;
+    return true;
+  }
+
+  bool AtEnd() const { return m_pos == m_end; }
+
+private:
+  const char* m_pos;
+  const char* m_end;
+};
+
+bool ReadChildren(CReader& reader, TiXmlNode& parent)
+{
+  std::string name, value, extra;
+  uint8_t tag;
+  while (reader.ReadTag(tag))
+  {
+    switch (tag)
+    {
+      case TagEnd:
+        return true;
+
+      case TagElement:
+      {
+        uint32_t attributes;
+        if (!reader.ReadString(name) || !reader.ReadU32(attributes))
+          return false;
+
+        TiXmlElement* element = new TiXmlElement(name);
+        parent.LinkEndChild(element);
+        for (uint32_t i = 0; i < attributes; i++)
+        {
+          if (!reader.ReadString(name) || !reader.ReadString(value))
+            return false;
+          element->SetAttribute(name, value);
+        }
+        if (!ReadChildren(reader, *element))
+          return false;
+        break;
+      }
+
+      case TagText:
+      case TagCData:
+      {
+        if (!reader.ReadString(value))
+          return false;
+
+        TiXmlText* text = new TiXmlText(value);
+        text->SetCDATA(tag == TagCData);
+        parent.LinkEndChild(text);
+        break;
+      }
+
+      case TagDeclaration:
+      {
+        if (!reader.ReadString(name) || !reader.ReadString(value) || !reader.ReadString(extra))
+          return false;
+
+        parent.LinkEndChild(new TiXmlDeclaration(name, value, extra));
+        break;
+      }
+
+      default:
+        return false;
+    }
+  }
+
+  // missing end tag
+  return false;
+}
+
+}
+
+bool CXMLBinaryCache::LoadFile(const std::string& file, CXBMCTinyXML& xmlDoc)
+{
+  struct __stat64 st;
+  if (XFILE::CFile::Stat(file, &st) != 0)
+    return xmlDoc.LoadFile(file);
+
+  const std::string cachePath = GetCachePath(file);
+  XFILE::auto_buffer cache;
+  CacheHeader header;
+  bool validCache = false;
+  if (XFILE::CFile().LoadFile(cachePath, cache) > static_cast<ssize_t>(sizeof(CacheHeader)))
+  {
+    memcpy(&header, cache.get(), sizeof(header));
+    validCache = memcmp(header.magic, CacheMagic, sizeof(CacheMagic)) == 0 &&
+                 header.version == CacheVersion &&
+                 header.dataSize == cache.size() - sizeof(header);
+  }
+
+  // unchanged size and modification time, the source doesn't need to be read
+  if (validCache &&
+      header.sourceSize == static_cast<uint64_t>(st.st_size) &&
+      header.sourceMtime == static_cast<int64_t>(st.st_mtime))
+  {
+    if (LoadSnapshot(file, cache.get() + sizeof(header), header.dataSize, xmlDoc))
+      return true;
+    validCache = false;
+  }
+
+  XFILE::auto_buffer source;
+  if (XFILE::CFile().LoadFile(file, source) <= 0)
+    return xmlDoc.LoadFile(file);
+
+  const uint64_t sourceSize = source.size();
+  Crc32 crc;
+  crc.Compute(source.get(), source.size());
+
+  // the file was touched but its content is the same, only refresh the time
+  if (validCache &&
+      header.sourceSize == sourceSize &&
+      header.sourceCrc == static_cast<uint32_t>(crc) &&
+      LoadSnapshot(file, cache.get() + sizeof(header), header.dataSize, xmlDoc))
+  {
+    header.sourceMtime = GetTrustedMtime(st.st_mtime);
+    if (header.sourceMtime != UntrustedMtime)
+    {
+      memcpy(cache.get(), &header, sizeof(header));
+      WriteSnapshot(file, cachePath, cache.get(), cache.size());
+    }
+    return true;
+  }
+
+  // something changed, parse the XML and refresh the snapshot
+  cache.clear();
+  std::string xml(source.get(), source.size());
+  source.clear();
+
+  xmlDoc.Clear();
+  xmlDoc.SetValue(file);
+  if (!xmlDoc.Parse(xml) || xmlDoc.Error())
+    return false;
+  xml.clear();
+
+  std::string data(sizeof(CacheHeader), '\0');
+  Serialize(xmlDoc, data);
+
+  memcpy(header.magic, CacheMagic, sizeof(CacheMagic));
+  header.version = CacheVersion;
+  header.sourceSize = sourceSize;
+  header.sourceMtime = GetTrustedMtime(st.st_mtime);
+  header.sourceCrc = crc;
+  header.dataSize = static_cast<uint32_t>(data.size() - sizeof(header));
+  data.replace(0, sizeof(header), reinterpret_cast<const char*>(&header), sizeof(header));
+
+  WriteSnapshot(file, cachePath, data.c_str(), data.size());
+  return true;
+}
+
+bool CXMLBinaryCache::LoadSnapshot(const std::string& file, const char* data, size_t size, CXBMCTinyXML& xmlDoc)
+{
+  xmlDoc.Clear();
+  xmlDoc.SetValue(file);
+  if (Deserialize(data, size, xmlDoc) && xmlDoc.RootElement() != nullptr)
+  {
+    CLog::Log(LOGDEBUG, "CXMLBinaryCache: loaded %s from binary cache", file.c_str());
+    return true;
+  }
+
+  CLog::Log(LOGWARNING, "CXMLBinaryCache: discarding invalid binary cache of %s", file.c_str());
+  return false;
+}
+
+void CXMLBinaryCache::WriteSnapshot(const std::string& file, const std::string& cachePath, const char* data, size_t size)
+{
+  // the same file may be loaded on several threads at once (e.g. by the GUI and
+  // a preload job), don't let them write to the same temporary file
+  static CCriticalSection writeSection;
+  CSingleLock lock(writeSection);
+
+  // write to a temporary file first so that a crash never leaves a truncated snapshot behind
+  const std::string tempPath = cachePath + ".tmp";
+  XFILE::CFile cacheFile;
+  if (!XFILE::CDirectory::Exists(XML_CACHE_FOLDER) && !XFILE::CDirectory::Create(XML_CACHE_FOLDER))
+    return;
+  if (!cacheFile.OpenForWrite(tempPath, true))
+    return;
+  bool written = cacheFile.Write(data, size) == static_cast<ssize_t>(size);
+  cacheFile.Close();
+
+  if (!written || !XFILE::CFile::Rename(tempPath, cachePath))
+  {
+    CLog::Log(LOGWARNING, "CXMLBinaryCache: unable to write binary cache of %s", file.c_str());
+    XFILE::CFile::Delete(tempPath);
+  }
+}
+
+void CXMLBinaryCache::Serialize(const TiXmlNode& node, std::string& data)
+{
+  for (const TiXmlNode* child = node.FirstChild(); child != nullptr; child = child->NextSibling())
+  {
+    switch (child->Type())
+    {
+      case TiXmlNode::TINYXML_ELEMENT:
+      {
+        const TiXmlElement* element = child->ToElement();
+        uint32_t attributes = 0;
+        for (const TiXmlAttribute* attribute = element->FirstAttribute(); attribute != nullptr; attribute = attribute->Next())
+          attributes++;
+
+        data.push_back(static_cast<char>(TagElement));
+        WriteString(data, element->ValueStr());
+        WriteU32(data, attributes);
+        for (const TiXmlAttribute* attribute = element->FirstAttribute(); attribute != nullptr; attribute = attribute->Next())
+        {
+          WriteString(data, attribute->NameTStr());
+          WriteString(data, attribute->ValueStr());
+        }
+        Serialize(*element, data);
+        break;
+      }
+
+      case TiXmlNode::TINYXML_TEXT:
+      {
+        const TiXmlText* text = child->ToText();
+        data.push_back(static_cast<char>(text->CDATA() ? TagCData : TagText));
+        WriteString(data, text->ValueStr());
+        break;
+      }
+
+      case TiXmlNode::TINYXML_DECLARATION:
+      {
+        const TiXmlDeclaration* declaration = child->ToDeclaration();
+        data.push_back(static_cast<char>(TagDeclaration));
+        WriteString(data, declaration->Version());
+        WriteString(data, declaration->Encoding());
+        WriteString(data, declaration->Standalone());
+        break;
+      }
+
+      default:
+        // comments and unknown nodes aren't needed by anyone reading the document
+        break;
+    }
+  }
+
+  data.push_back(static_cast<char>(TagEnd));
+}
+
+bool CXMLBinaryCache::Deserialize(const char* data, size_t size, TiXmlNode& node)
+{
+  CReader reader(data, size);
+  return ReadChildren(reader, node) && reader.AtEnd();
+}
+
+std::string CXMLBinaryCache::GetCachePath(const std::string& file)
+{
+  return StringUtils::Format(XML_CACHE_FOLDER "%08x.bin", Crc32::Compute(file));
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stddef.h>
+#include <string>
+
+class CXBMCTinyXML;
+class TiXmlNode;
+
+/*!
+ \brief Binary snapshot of parsed XML documents.
+
+ Parsing large XML files like the settings definitions with TinyXML on every
+ start is comparatively expensive. This cache stores the parsed document tree
+ in a compact binary form in special://temp/xmlcache/ together with the size,
+ modification time and CRC of the XML source it was created from. As long as
+ size and modification time are unchanged the document is rebuilt from the
+ snapshot without reading the source at all; if only the time changed the CRC
+ decides. Otherwise the XML is parsed as usual and the snapshot is refreshed.
+
+ Comments and processing instructions are not part of the snapshot.
+ */
+class CXMLBinaryCache
+{
+public:
+  /*!
+   \brief Loads the given XML file into the given document, like
+   CXBMCTinyXML::LoadFile(), using the binary snapshot if it is up to date.
+
+   \param file Path of the XML file
+   \param xmlDoc Document to load the file into
+   \return True if the document was loaded, false otherwise
+   */
+  static bool LoadFile(const std::string& file, CXBMCTinyXML& xmlDoc);
+
+  /*!
+   \brief Serializes the children of the given node into a snapshot.
+
+   \param node Node (usually a document) to serialize
+   \param data Output buffer the snapshot is appended to
+   */
+  static void Serialize(const TiXmlNode& node, std::string& data);
+  /*!
+   \brief Rebuilds the children of the given node from a snapshot.
+
+   \param data Snapshot created by Serialize()
+   \param size Size of the snapshot
+   \param node Node to append the rebuilt children to
+   \return True if the snapshot was complete and valid, false otherwise
+   */
+  static bool Deserialize(const char* data, size_t size, TiXmlNode& node);
+
+private:
+  static std::string GetCachePath(const std::string& file);
+  static bool LoadSnapshot(const std::string& file, const char* data, size_t size, CXBMCTinyXML& xmlDoc);
+  static void WriteSnapshot(const std::string& file, const std::string& cachePath, const char* data, size_t size);
+};
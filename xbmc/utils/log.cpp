@@ -18,10 +18,17 @@
  *
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
 #include "log.h"
 #include "CompileInfo.h"
 #include "settings/AdvancedSettings.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
 #include "threads/SingleLock.h"
 #include "threads/Thread.h"
 #include "utils/StringUtils.h"
@@ -34,6 +41,10 @@ typedef class CPosixInterfaceForCLog PlatformInterfaceForCLog;
 typedef class CWin32InterfaceForCLog PlatformInterfaceForCLog;
 #endif
 
+// lines a thread can have waiting for the log writer before further lines are dropped
+#define LOG_QUEUE_SIZE 1024
+// the log writer wakes up at least this often even if nobody signals it
+#define LOG_WRITER_INTERVAL 100
 
 static const char* const levelNames[] =
 {"DEBUG", "INFO", "NOTICE", "WARNING", "ERROR", "SEVERE", "FATAL", "NONE"};
@@ -44,38 +55,173 @@ static const char* const logLevelNames[] =
 
 namespace
 {
+struct LogLine
+{
+  int logLevel = 0;
+  uint64_t threadId = 0;
+  std::chrono::steady_clock::time_point time;
+  std::string text;
+};
+
+/*!
+ \brief Lines logged by one thread, written by that thread and read by the log writer only
+ */
+class CLogQueue
+{
+public:
+  bool Push(LogLine &&line)
+  {
+    uint64_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) >= LOG_QUEUE_SIZE)
+    {
+      m_dropped++;
+      return false;
+    }
+
+    m_lines[tail % LOG_QUEUE_SIZE] = std::move(line);
+    m_tail.store(tail + 1);
+    return true;
+  }
+
+  void Pop(std::vector<LogLine> &lines)
+  {
+    uint64_t head = m_head.load(std::memory_order_relaxed);
+    uint64_t tail = m_tail.load(std::memory_order_acquire);
+    for (; head < tail; head++)
+      lines.push_back(std::move(m_lines[head % LOG_QUEUE_SIZE]));
+    m_head.store(head, std::memory_order_release);
+  }
+
+  bool IsEmpty() const { return m_head.load() == m_tail.load(); }
+
+  std::atomic<unsigned int> m_dropped{0};
+  std::atomic<bool> m_retired{false};
+  uint64_t m_threadId = 0;
+
+private:
+  LogLine m_lines[LOG_QUEUE_SIZE];
+  std::atomic<uint64_t> m_head{0};
+  std::atomic<uint64_t> m_tail{0};
+};
+
 class CLogGlobals
 {
 public:
   CLogGlobals(void) : m_repeatCount(0), m_repeatLogLevel(-1), m_logLevel(LOG_LEVEL_DEBUG), m_extraLogLevels(0) {}
-  ~CLogGlobals() = default;
+  ~CLogGlobals() { StopWriter(); }
+
+  void StartWriter();
+  void StopWriter();
+  void Wake() { if (m_writerIdle.load() && m_writerIdle.exchange(false)) m_wake.Set(); }
+  /*!
+   \brief Write all queued lines, critSec has to be held
+   */
+  void Drain();
+  bool HasQueuedLines();
+  /*!
+   \brief Write the lines collected in m_batch to the log file, critSec has to be held
+   */
+  void Flush();
+  /*!
+   \brief Convert a steady clock time to microseconds since local midnight
+   */
+  int64_t GetTimeOfDay(std::chrono::steady_clock::time_point time);
+
   PlatformInterfaceForCLog m_platform;
   int         m_repeatCount;
   int         m_repeatLogLevel;
   std::string m_repeatLine;
+  std::string m_batch;
+  int64_t m_clockTimeOfDay = 0;
+  std::chrono::steady_clock::time_point m_clockTime;
   int         m_logLevel;
   int         m_extraLogLevels;
   CCriticalSection critSec;
+
+  // lines are only queued while the writer runs, it runs while the log file
+  // is open if advancedsettings.xml asks for it
+  bool m_asyncEnabled = false;
+  bool m_open = false;
+  std::atomic<bool> m_async{false};
+  std::atomic<uint64_t> m_dropped{0};
+  CCriticalSection m_queuesSection;
+  std::vector<std::shared_ptr<CLogQueue>> m_queues;
+
+private:
+  void Process();
+
+  std::thread m_writer;
+  std::atomic<bool> m_stop{false};
+  std::atomic<bool> m_writerIdle{false};
+  CEvent m_wake;
 };
 
 static CLogGlobals g_logState;
-}
 
-CLog::CLog() = default;
+// set once the queue of the thread is gone, whatever the thread logs
+// afterwards is written synchronously
+thread_local bool threadQueueReleased = false;
 
-CLog::~CLog() = default;
+struct CThreadLogQueue
+{
+  std::shared_ptr<CLogQueue> m_queue;
 
-void CLog::Close()
+  ~CThreadLogQueue()
+  {
+    threadQueueReleased = true;
+    if (m_queue)
+    {
+      m_queue->m_retired = true;
+      g_logState.Wake();
+    }
+  }
+};
+
+thread_local CThreadLogQueue threadQueue;
+
+CLogQueue* GetThreadQueue()
 {
-  CSingleLock waitLock(g_logState.critSec);
-  g_logState.m_platform.CloseLogFile();
-  g_logState.m_repeatLine.clear();
+  if (!threadQueue.m_queue)
+  {
+    threadQueue.m_queue = std::make_shared<CLogQueue>();
+    threadQueue.m_queue->m_threadId = (uint64_t)CThread::GetCurrentThreadId();
+
+    CSingleLock lock(g_logState.m_queuesSection);
+    g_logState.m_queues.push_back(threadQueue.m_queue);
+  }
+  return threadQueue.m_queue.get();
 }
 
-void CLog::LogString(int logLevel, std::string&& logString)
+void WriteLogString(int logLevel, uint64_t threadId, std::chrono::steady_clock::time_point time, const std::string& logString)
 {
-  CSingleLock waitLock(g_logState.critSec);
+  static const char* prefixFormat = "%02d:%02d:%02d.%03d T:%" PRIu64" %7s: ";
+
   std::string strData(logString);
+  /* fixup newline alignment, number of spaces should equal prefix length */
+  StringUtils::Replace(strData, "\n", "\n                                            ");
+
+  // stamp the line with the time it was logged, not the time it is written
+  static const int64_t microsecondsPerDay = 24LL * 60 * 60 * 1000 * 1000;
+  int64_t timeOfDay = g_logState.GetTimeOfDay(time);
+  timeOfDay = (timeOfDay % microsecondsPerDay + microsecondsPerDay) % microsecondsPerDay / 1000;
+
+  strData = StringUtils::Format(prefixFormat,
+                                  static_cast<int>(timeOfDay / 3600000),
+                                  static_cast<int>(timeOfDay / 60000 % 60),
+                                  static_cast<int>(timeOfDay / 1000 % 60),
+                                  static_cast<int>(timeOfDay % 1000),
+                                  threadId,
+                                  levelNames[logLevel]) + strData;
+
+  // the file is written once per batch instead of once per line
+  if (!g_logState.m_batch.empty())
+    g_logState.m_batch += '\n';
+  g_logState.m_batch += strData;
+}
+
+void WriteLine(int logLevel, uint64_t threadId, std::chrono::steady_clock::time_point time, std::string&& logString)
+{
+  std::string strData(std::move(logString));
   StringUtils::TrimRight(strData);
   if (!strData.empty())
   {
@@ -88,18 +234,178 @@ void CLog::LogString(int logLevel, std::string&& logString)
     {
       std::string strData2 = StringUtils::Format("Previous line repeats %d times.",
                                                 g_logState.m_repeatCount);
-      PrintDebugString(strData2);
-      WriteLogString(g_logState.m_repeatLogLevel, strData2);
+      CLog::PrintDebugString(strData2);
+      WriteLogString(g_logState.m_repeatLogLevel, threadId, time, strData2);
       g_logState.m_repeatCount = 0;
     }
 
     g_logState.m_repeatLine = strData;
     g_logState.m_repeatLogLevel = logLevel;
 
-    PrintDebugString(strData);
+    CLog::PrintDebugString(strData);
+
+    WriteLogString(logLevel, threadId, time, strData);
+  }
+}
+
+void CLogGlobals::StartWriter()
+{
+  if (m_writer.joinable())
+    return;
+
+  m_stop = false;
+  m_writer = std::thread(&CLogGlobals::Process, this);
+  m_async = true;
+}
+
+void CLogGlobals::StopWriter()
+{
+  if (!m_writer.joinable())
+    return;
+
+  m_async = false;
+  m_stop = true;
+  m_wake.Set();
+  m_writer.join();
+}
+
+void CLogGlobals::Process()
+{
+  while (!m_stop)
+  {
+    {
+      CSingleLock lock(critSec);
+      Drain();
+    }
+
+    // anyone queueing a line after this wakes the writer up
+    m_writerIdle = true;
+    if (!HasQueuedLines())
+      m_wake.WaitMSec(LOG_WRITER_INTERVAL);
+    m_writerIdle = false;
+  }
+}
+
+bool CLogGlobals::HasQueuedLines()
+{
+  CSingleLock lock(m_queuesSection);
+  for (const auto &queue : m_queues)
+  {
+    if (!queue->IsEmpty())
+      return true;
+  }
+  return false;
+}
+
+void CLogGlobals::Drain()
+{
+  std::vector<std::shared_ptr<CLogQueue>> queues;
+  {
+    CSingleLock lock(m_queuesSection);
+    queues = m_queues;
+  }
+
+  std::vector<LogLine> lines;
+  std::vector<std::pair<uint64_t, unsigned int>> dropped;
+  for (const auto &queue : queues)
+  {
+    // read the flag first so the lines logged right before the thread ended are popped
+    bool retired = queue->m_retired;
+    queue->Pop(lines);
+    unsigned int count = queue->m_dropped.exchange(0);
+    if (count > 0)
+      dropped.push_back(std::make_pair(queue->m_threadId, count));
+
+    if (retired)
+    {
+      CSingleLock lock(m_queuesSection);
+      m_queues.erase(std::remove(m_queues.begin(), m_queues.end(), queue), m_queues.end());
+    }
+  }
+
+  // lines of different threads are written in the order they were logged
+  std::stable_sort(lines.begin(), lines.end(), [](const LogLine &lhs, const LogLine &rhs)
+  {
+    return lhs.time < rhs.time;
+  });
+
+  for (auto &line : lines)
+    WriteLine(line.logLevel, line.threadId, line.time, std::move(line.text));
+
+  for (const auto &thread : dropped)
+  {
+    m_dropped += thread.second;
+    WriteLine(LOGWARNING, thread.first, std::chrono::steady_clock::now(),
+              StringUtils::Format("Dropped %u log lines of this thread, it logged faster than they could be written", thread.second));
+  }
+
+  Flush();
+}
+
+int64_t CLogGlobals::GetTimeOfDay(std::chrono::steady_clock::time_point time)
+{
+  // reading the local time for every line is expensive and lets the written
+  // times jitter, so it is only read again once the last reading is a second old
+  auto now = std::chrono::steady_clock::now();
+  if (m_clockTime == std::chrono::steady_clock::time_point() || now - m_clockTime > std::chrono::seconds(1))
+  {
+    int hour, minute, second;
+    double millisecond;
+    m_platform.GetCurrentLocalTime(hour, minute, second, millisecond);
+    m_clockTimeOfDay = ((hour * 60 + minute) * 60 + second) * 1000000LL + static_cast<int64_t>(millisecond * 1000);
+    m_clockTime = now;
+  }
+
+  return m_clockTimeOfDay + std::chrono::duration_cast<std::chrono::microseconds>(time - m_clockTime).count();
+}
+
+void CLogGlobals::Flush()
+{
+  if (m_batch.empty())
+    return;
+
+  m_platform.WriteStringToLog(m_batch);
+  m_batch.clear();
+}
+}
+
+CLog::CLog() = default;
+
+CLog::~CLog() = default;
+
+void CLog::Close()
+{
+  g_logState.StopWriter();
+
+  CSingleLock waitLock(g_logState.critSec);
+  g_logState.Drain();
+  g_logState.m_platform.CloseLogFile();
+  g_logState.m_open = false;
+  g_logState.m_repeatLine.clear();
+}
 
-    WriteLogString(logLevel, strData);
+void CLog::LogString(int logLevel, std::string&& logString)
+{
+  LogLine line;
+  line.logLevel = logLevel;
+  line.threadId = (uint64_t)CThread::GetCurrentThreadId();
+  line.time = std::chrono::steady_clock::now();
+  line.text = std::move(logString);
+
+  // severe and fatal lines are written right away in case the process dies,
+  // other lines are dropped and counted when the queue of the thread is full
+  // rather than stalling the thread until the writer catches up
+  if (g_logState.m_async && !threadQueueReleased && (logLevel & LOGMASK) < LOGSEVERE)
+  {
+    GetThreadQueue()->Push(std::move(line));
+    g_logState.Wake();
+    return;
   }
+
+  CSingleLock waitLock(g_logState.critSec);
+  g_logState.Drain();
+  WriteLine(line.logLevel, line.threadId, line.time, std::move(line.text));
+  g_logState.Flush();
 }
 
 void CLog::LogString(int logLevel, int component, std::string&& logString)
@@ -117,7 +423,33 @@ bool CLog::Init(const std::string& path)
 
   std::string appName = CCompileInfo::GetAppName();
   StringUtils::ToLower(appName);
-  return g_logState.m_platform.OpenLogFile(path + appName + ".log", path + appName + ".old.log");
+  if (!g_logState.m_platform.OpenLogFile(path + appName + ".log", path + appName + ".old.log"))
+    return false;
+
+  g_logState.m_open = true;
+  if (g_logState.m_asyncEnabled)
+    g_logState.StartWriter();
+  return true;
+}
+
+void CLog::SetAsync(bool async)
+{
+  {
+    CSingleLock waitLock(g_logState.critSec);
+    g_logState.m_asyncEnabled = async;
+    if (async)
+    {
+      if (g_logState.m_open)
+        g_logState.StartWriter();
+      return;
+    }
+  }
+
+  // the writer takes critSec itself
+  g_logState.StopWriter();
+
+  CSingleLock waitLock(g_logState.critSec);
+  g_logState.Drain();
 }
 
 void CLog::MemDump(char *pData, int length)
@@ -174,6 +506,16 @@ void CLog::SetExtraLogLevels(int level)
   g_logState.m_extraLogLevels = level;
 }
 
+bool CLog::IsComponentLogged(int component)
+{
+  return g_advancedSettings.CanLogComponent(component);
+}
+
+uint64_t CLog::GetDroppedLineCount()
+{
+  return g_logState.m_dropped;
+}
+
 bool CLog::IsLogLevelLogged(int loglevel)
 {
   const int extras = (loglevel & ~LOGMASK);
@@ -196,26 +538,3 @@ void CLog::PrintDebugString(const std::string& line)
   g_logState.m_platform.PrintDebugString(line);
 #endif // defined(_DEBUG) || defined(PROFILE)
 }
-
-bool CLog::WriteLogString(int logLevel, const std::string& logString)
-{
-  static const char* prefixFormat = "%02d:%02d:%02d.%03d T:%" PRIu64" %7s: ";
-
-  std::string strData(logString);
-  /* fixup newline alignment, number of spaces should equal prefix length */
-  StringUtils::Replace(strData, "\n", "\n                                            ");
-
-  int hour, minute, second;
-  double millisecond;
-  g_logState.m_platform.GetCurrentLocalTime(hour, minute, second, millisecond);
-
-  strData = StringUtils::Format(prefixFormat,
-                                  hour,
-                                  minute,
-                                  second,
-                                  static_cast<int>(millisecond),
-                                  (uint64_t)CThread::GetCurrentThreadId(),
-                                  levelNames[logLevel]) + strData;
-
-  return g_logState.m_platform.WriteStringToLog(strData);
-}
@@ -21,6 +21,7 @@
  */
 
 #include <memory>
+#include <stdint.h>
 #include <string>
 #include <utility>
 
@@ -58,10 +59,10 @@ public:
   template<typename... Args>
   static void Log(int loglevel, int component, const char* format, Args&&... args)
   {
-    // We defer component checking to LogString to avoid having to drag in advancedsettings
-    // everywhere we want to log anything
-    if (IsLogLevelLogged(loglevel))
-      LogString(loglevel, component, StringUtils::Format(format, std::forward<Args>(args)...));
+    // check the component before formatting, IsComponentLogged isn't inline
+    // to avoid having to drag in advancedsettings everywhere we want to log anything
+    if (IsLogLevelLogged(loglevel) && IsComponentLogged(component))
+      LogString(loglevel, StringUtils::Format(format, std::forward<Args>(args)...));
   }
 
   static void LogFunction(int loglevel, std::string functionName, const char* format)
@@ -93,13 +94,10 @@ public:
   static void LogFunction(
       int loglevel, std::string functionName, int component, const char* format, Args&&... args)
   {
-    // We defer component checking to LogString to avoid having to drag in advancedsettings
-    // everywhere we want to log anything
-    if (IsLogLevelLogged(loglevel))
+    if (IsLogLevelLogged(loglevel) && IsComponentLogged(component))
     {
       functionName.append(": ");
-      LogString(loglevel, component,
-                functionName + StringUtils::Format(format, std::forward<Args>(args)...));
+      LogString(loglevel, functionName + StringUtils::Format(format, std::forward<Args>(args)...));
     }
   }
 #define LogF(loglevel, ...) LogFunction((loglevel), __FUNCTION__, ##__VA_ARGS__)
@@ -111,9 +109,21 @@ public:
   static int  GetLogLevel();
   static void SetExtraLogLevels(int level);
   static bool IsLogLevelLogged(int loglevel);
+  static bool IsComponentLogged(int component);
+  /*!
+   \brief Queue the lines of each thread and write them on a background
+   thread instead of writing them right away
+   \param async whether to queue lines, queued lines are lost if the process crashes
+   and lines are dropped while the queue of a thread is full
+   */
+  static void SetAsync(bool async);
+  /*!
+   \brief Number of lines dropped since startup because a thread logged
+   faster than the log writer could write them
+   */
+  static uint64_t GetDroppedLineCount();
 
 protected:
   static void LogString(int logLevel, std::string&& logString);
   static void LogString(int logLevel, int component, std::string&& logString);
-  static bool WriteLogString(int logLevel, const std::string& logString);
 };
\ No newline at end of file
@@ -25,6 +25,12 @@
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
 #if 0
 static const uint16_t refutf16LE1[] = { 0xff54, 0xff45, 0xff53, 0xff54,
                                         0xff3f, 0xff55, 0xff54, 0xff46,
@@ -411,3 +417,58 @@ TEST_F(TestCharsetConverter, fromW)
   g_charsetConverter.fromW(refstrw1, varstra1, "UTF-16LE");
   EXPECT_STREQ(refstra1.c_str(), varstra1.c_str());
 }
+
+namespace
+{
+// label-like mix of ASCII and CJK text as rendered by the GUI
+const std::string labelUtf8 = "Episode 12 - \xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E (2018) 1080p";
+
+// converts the label back and forth on several threads at once and returns
+// the number of conversions that failed or didn't round-trip
+unsigned int ConvertConcurrently(unsigned int threadCount, unsigned int iterations)
+{
+  std::u32string reference;
+  if (!g_charsetConverter.utf8ToUtf32(labelUtf8, reference))
+    return iterations * threadCount;
+
+  std::atomic<unsigned int> failures(0);
+  std::vector<std::thread> threads;
+  for (unsigned int i = 0; i < threadCount; i++)
+  {
+    threads.emplace_back([&]()
+    {
+      std::u32string utf32;
+      std::string back;
+      for (unsigned int j = 0; j < iterations; j++)
+      {
+        if (!g_charsetConverter.utf8ToUtf32(labelUtf8, utf32) || utf32 != reference ||
+            !g_charsetConverter.utf32ToUtf8(utf32, back) || back != labelUtf8)
+          failures++;
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  return failures;
+}
+}
+
+TEST_F(TestCharsetConverter, utf8ToUtf32_threaded)
+{
+  EXPECT_EQ(0U, ConvertConcurrently(4, 2000));
+}
+
+// conversions per second of four threads, run with --gtest_also_run_disabled_tests
+TEST_F(TestCharsetConverter, DISABLED_Benchmark)
+{
+  const unsigned int threadCount = 4;
+  const unsigned int iterations = 200000;
+
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(0U, ConvertConcurrently(threadCount, iterations));
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+  const double conversions = 2.0 * threadCount * iterations;
+  RecordProperty("ConversionsPerSecond", static_cast<int>(conversions * 1000000 / std::max<int64_t>(elapsed.count(), 1)));
+}
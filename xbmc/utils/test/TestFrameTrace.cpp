@@ -0,0 +1,116 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+#include <thread>
+
+#include "utils/FrameTrace.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+unsigned int CountZones(const CVariant &trace, const std::string &name)
+{
+  unsigned int count = 0;
+  for (CVariant::const_iterator_array itr = trace["traceEvents"].begin_array(); itr != trace["traceEvents"].end_array(); ++itr)
+  {
+    if ((*itr)["ph"].asString() == "X" && (*itr)["name"].asString() == name)
+      count++;
+  }
+  return count;
+}
+}
+
+TEST(TestFrameTrace, RecordsZonesWhileEnabled)
+{
+  CFrameTrace::SetEnabled(false);
+  {
+    FRAME_TRACE_ZONE("TestFrameTrace.Disabled");
+  }
+
+  CFrameTrace::SetEnabled(true);
+  {
+    FRAME_TRACE_ZONE("TestFrameTrace.Enabled");
+  }
+  std::thread other([]()
+  {
+    FRAME_TRACE_ZONE("TestFrameTrace.Other");
+  });
+  other.join();
+  CFrameTrace::SetEnabled(false);
+
+  CVariant trace;
+  CFrameTrace::Export(trace);
+  ASSERT_TRUE(trace["traceEvents"].isArray());
+  EXPECT_EQ(0u, CountZones(trace, "TestFrameTrace.Disabled"));
+  EXPECT_EQ(1u, CountZones(trace, "TestFrameTrace.Enabled"));
+  EXPECT_EQ(1u, CountZones(trace, "TestFrameTrace.Other"));
+
+  // zones of different threads end up on different tracks
+  int64_t enabledTid = -1;
+  int64_t otherTid = -1;
+  for (CVariant::const_iterator_array itr = trace["traceEvents"].begin_array(); itr != trace["traceEvents"].end_array(); ++itr)
+  {
+    if ((*itr)["name"].asString() == "TestFrameTrace.Enabled")
+    {
+      enabledTid = (*itr)["tid"].asInteger();
+      EXPECT_GE((*itr)["dur"].asInteger(), 0);
+    }
+    else if ((*itr)["name"].asString() == "TestFrameTrace.Other")
+      otherTid = (*itr)["tid"].asInteger();
+  }
+  EXPECT_NE(enabledTid, otherTid);
+}
+
+TEST(TestFrameTrace, KeepsNewestZonesWhenFull)
+{
+  static const unsigned int zones = 3 * FRAME_TRACE_EVENTS + 5;
+
+  CFrameTrace::SetEnabled(true);
+  int64_t now = CFrameTrace::Now();
+  for (unsigned int index = 0; index < zones; index++)
+    CFrameTrace::Record("TestFrameTrace.Full", now + index, now + index + 1);
+  CFrameTrace::SetEnabled(false);
+
+  CVariant trace;
+  CFrameTrace::Export(trace);
+
+  // the slot the next zone goes to is never exported, all others are
+  unsigned int count = 0;
+  int64_t oldest = -1;
+  int64_t newest = -1;
+  for (CVariant::const_iterator_array itr = trace["traceEvents"].begin_array(); itr != trace["traceEvents"].end_array(); ++itr)
+  {
+    if ((*itr)["ph"].asString() != "X" || (*itr)["name"].asString() != "TestFrameTrace.Full")
+      continue;
+
+    int64_t ts = (*itr)["ts"].asInteger();
+    if (count == 0 || ts < oldest)
+      oldest = ts;
+    if (count == 0 || ts > newest)
+      newest = ts;
+    count++;
+  }
+  EXPECT_EQ(FRAME_TRACE_EVENTS - 1u, count);
+  EXPECT_EQ(now + zones - 1, newest);
+  EXPECT_EQ(now + zones - (FRAME_TRACE_EVENTS - 1), oldest);
+}
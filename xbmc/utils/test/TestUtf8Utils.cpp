@@ -0,0 +1,104 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/Utf8Utils.h"
+
+#include "gtest/gtest.h"
+
+// "Kodi ü € 日本 😀" followed by enough ASCII to use the bulk path
+static const char refUtf8[] = "Kodi \xC3\xBC \xE2\x82\xAC \xE6\x97\xA5\xE6\x9C\xAC \xF0\x9F\x98\x80"
+                              " and a long run of plain ASCII text after it";
+static const char32_t refUtf32[] = U"Kodi ü € 日本 \U0001F600"
+                                   U" and a long run of plain ASCII text after it";
+static const char16_t refUtf16[] = u"Kodi ü € 日本 \U0001F600"
+                                   u" and a long run of plain ASCII text after it";
+
+TEST(TestUtf8Utils, Utf8ToUtf32)
+{
+  std::u32string utf32;
+  EXPECT_TRUE(CUtf8Utils::Utf8ToUtf32(refUtf8, utf32, true));
+  EXPECT_EQ(std::u32string(refUtf32), utf32);
+}
+
+TEST(TestUtf8Utils, Utf8ToUtf16)
+{
+  std::u16string utf16;
+  EXPECT_TRUE(CUtf8Utils::Utf8ToUtf16(refUtf8, utf16, true));
+  EXPECT_EQ(std::u16string(refUtf16), utf16);
+}
+
+TEST(TestUtf8Utils, ToUtf8)
+{
+  std::string utf8;
+  EXPECT_TRUE(CUtf8Utils::Utf32ToUtf8(refUtf32, utf8, true));
+  EXPECT_EQ(std::string(refUtf8), utf8);
+
+  utf8.clear();
+  EXPECT_TRUE(CUtf8Utils::Utf16ToUtf8(refUtf16, utf8, true));
+  EXPECT_EQ(std::string(refUtf8), utf8);
+}
+
+TEST(TestUtf8Utils, WideRoundTrip)
+{
+  std::wstring wide;
+  std::string utf8;
+  std::u32string utf32;
+  EXPECT_TRUE(CUtf8Utils::Utf8ToW(refUtf8, wide, true));
+  EXPECT_TRUE(CUtf8Utils::WToUtf8(wide, utf8, true));
+  EXPECT_EQ(std::string(refUtf8), utf8);
+  EXPECT_TRUE(CUtf8Utils::WToUtf32(wide, utf32, true));
+  EXPECT_EQ(std::u32string(refUtf32), utf32);
+  wide.clear();
+  EXPECT_TRUE(CUtf8Utils::Utf32ToW(utf32, wide, true));
+  EXPECT_TRUE(CUtf8Utils::WToUtf8(wide, utf8, true));
+  EXPECT_EQ(std::string(refUtf8), utf8);
+}
+
+TEST(TestUtf8Utils, InvalidUtf8)
+{
+  // overlong '/', encoded surrogate, code point above U+10FFFF, truncated sequence
+  const std::string invalid("a\xC0\xAF" "b\xED\xA0\x80" "c\xF4\x90\x80\x80" "d\xE2\x82");
+  std::u32string utf32;
+
+  EXPECT_FALSE(CUtf8Utils::Utf8ToUtf32(invalid, utf32, true));
+  EXPECT_TRUE(utf32.empty());
+
+  EXPECT_TRUE(CUtf8Utils::Utf8ToUtf32(invalid, utf32, false));
+  EXPECT_EQ(std::u32string(U"abcd"), utf32);
+}
+
+TEST(TestUtf8Utils, InvalidUtf16)
+{
+  // unpaired high and low surrogates
+  const std::u16string invalid = std::u16string(u"a") + char16_t(0xD800) + u"b" + char16_t(0xDC00);
+  std::string utf8;
+
+  EXPECT_FALSE(CUtf8Utils::Utf16ToUtf8(invalid, utf8, true));
+  EXPECT_TRUE(CUtf8Utils::Utf16ToUtf8(invalid, utf8, false));
+  EXPECT_EQ("ab", utf8);
+}
+
+TEST(TestUtf8Utils, EmbeddedNull)
+{
+  const std::string utf8("a\0b", 3);
+  std::u32string utf32;
+  EXPECT_TRUE(CUtf8Utils::Utf8ToUtf32(utf8, utf32, true));
+  EXPECT_EQ(3U, utf32.length());
+}
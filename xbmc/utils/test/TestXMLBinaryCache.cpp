@@ -0,0 +1,131 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/XBMCTinyXML.h"
+#include "utils/XMLBinaryCache.h"
+#include "test/TestUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <string>
+
+namespace
+{
+
+std::string Print(const TiXmlNode& node)
+{
+  TiXmlPrinter printer;
+  node.Accept(&printer);
+  return printer.Str();
+}
+
+}
+
+TEST(TestXMLBinaryCache, RoundTrip)
+{
+  CXBMCTinyXML doc;
+  doc.Parse(std::string("<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                        "<settings version=\"2\"><!-- comment -->"
+                        "<setting id=\"a.b\" type=\"integer\" label=\"&amp;&lt;\">"
+                        "<default>10</default><data><![CDATA[<raw>]]></data>"
+                        "</setting><empty/></settings>"));
+  ASSERT_FALSE(doc.Error());
+
+  std::string data;
+  CXMLBinaryCache::Serialize(doc, data);
+
+  CXBMCTinyXML copy;
+  ASSERT_TRUE(CXMLBinaryCache::Deserialize(data.c_str(), data.size(), copy));
+  ASSERT_TRUE(copy.RootElement() != nullptr);
+
+  // comments are dropped, everything else is identical
+  doc.RootElement()->RemoveChild(doc.RootElement()->FirstChild());
+  EXPECT_EQ(Print(doc), Print(copy));
+
+  const TiXmlElement* setting = copy.RootElement()->FirstChildElement("setting");
+  ASSERT_TRUE(setting != nullptr);
+  EXPECT_STREQ("&<", setting->Attribute("label"));
+  ASSERT_TRUE(setting->FirstChildElement("data") != nullptr);
+  EXPECT_TRUE(setting->FirstChildElement("data")->FirstChild()->ToText()->CDATA());
+}
+
+TEST(TestXMLBinaryCache, TruncatedData)
+{
+  CXBMCTinyXML doc;
+  doc.Parse(std::string("<a><b c=\"d\">e</b></a>"));
+
+  std::string data;
+  CXMLBinaryCache::Serialize(doc, data);
+
+  for (size_t size = 0; size < data.size(); size++)
+  {
+    CXBMCTinyXML copy;
+    EXPECT_FALSE(CXMLBinaryCache::Deserialize(data.c_str(), size, copy));
+  }
+}
+
+TEST(TestXMLBinaryCache, LoadFile)
+{
+  const std::string file = XBMC_REF_FILE_PATH("system/settings/settings.xml");
+
+  // the first load parses the XML and creates the snapshot, the second one uses it
+  CXBMCTinyXML parsed;
+  ASSERT_TRUE(CXMLBinaryCache::LoadFile(file, parsed));
+  CXBMCTinyXML cached;
+  ASSERT_TRUE(CXMLBinaryCache::LoadFile(file, cached));
+
+  std::string parsedData, cachedData;
+  CXMLBinaryCache::Serialize(parsed, parsedData);
+  CXMLBinaryCache::Serialize(cached, cachedData);
+  EXPECT_EQ(parsedData, cachedData);
+}
+
+// compares loading the file with and without the snapshot, including file I/O,
+// run with --gtest_also_run_disabled_tests
+TEST(TestXMLBinaryCache, DISABLED_Benchmark)
+{
+  static const int iterations = 20;
+  const std::string file = XBMC_REF_FILE_PATH("system/settings/settings.xml");
+
+  {
+    CXBMCTinyXML doc;
+    ASSERT_TRUE(CXMLBinaryCache::LoadFile(file, doc));
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++)
+  {
+    CXBMCTinyXML doc;
+    EXPECT_TRUE(doc.LoadFile(file));
+  }
+  auto parseTime = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++)
+  {
+    CXBMCTinyXML doc;
+    EXPECT_TRUE(CXMLBinaryCache::LoadFile(file, doc));
+  }
+  auto cacheTime = std::chrono::steady_clock::now() - start;
+
+  RecordProperty("ParseUs", std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(parseTime).count() / iterations));
+  RecordProperty("CacheUs", std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(cacheTime).count() / iterations));
+}
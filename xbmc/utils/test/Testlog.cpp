@@ -19,6 +19,11 @@
  */
 
 #include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
 #include "utils/log.h"
 #include "utils/RegExp.h"
 #include "filesystem/File.h"
@@ -151,3 +156,116 @@ TEST_F(Testlog, SetLogLevel)
   CLog::Close();
   EXPECT_TRUE(XFILE::CFile::Delete(logfile));
 }
+
+namespace
+{
+// logs lineCount debug lines and one severe line from each thread with the
+// log writer running and returns the log file
+std::string LogConcurrently(int threadCount, int lineCount, uint64_t &dropped)
+{
+  std::string appName = CCompileInfo::GetAppName();
+  StringUtils::ToLower(appName);
+  std::string logfile = CSpecialProtocol::TranslatePath("special://temp/") + appName + ".log";
+  EXPECT_TRUE(CLog::Init(CSpecialProtocol::TranslatePath("special://temp/").c_str()));
+  EXPECT_TRUE(XFILE::CFile::Exists(logfile));
+  CLog::SetAsync(true);
+
+  dropped = CLog::GetDroppedLineCount();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < threadCount; ++i)
+  {
+    threads.emplace_back([i, lineCount]()
+    {
+      for (int line = 0; line < lineCount; ++line)
+        CLog::Log(LOGDEBUG, "thread %d line %d", i, line);
+      CLog::Log(LOGSEVERE, "thread %d done", i);
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  CLog::SetAsync(false);
+  CLog::Close();
+  dropped = CLog::GetDroppedLineCount() - dropped;
+
+  return logfile;
+}
+}
+
+TEST_F(Testlog, ConcurrentLog)
+{
+  const int threadCount = 4;
+  const int lineCount = 20000;
+  std::string logstring;
+  char buf[4096];
+  unsigned int bytesread;
+  XFILE::CFile file;
+
+  // every thread logs far more lines than its queue holds
+  uint64_t dropped;
+  std::string logfile = LogConcurrently(threadCount, lineCount, dropped);
+
+  EXPECT_TRUE(file.Open(logfile));
+  while ((bytesread = file.Read(buf, sizeof(buf) - 1)) > 0)
+  {
+    buf[bytesread] = '\0';
+    logstring.append(buf);
+  }
+  file.Close();
+
+  // every line is either written, in the order of its thread, or counted
+  // as dropped and reported, severe lines are never dropped
+  std::vector<int> last(threadCount, -1);
+  std::vector<bool> done(threadCount, false);
+  uint64_t written = 0;
+  uint64_t reported = 0;
+  for (const auto &logline : StringUtils::Split(logstring, "\n"))
+  {
+    size_t pos = logline.find("Dropped ");
+    unsigned int count;
+    if (pos != std::string::npos && sscanf(logline.c_str() + pos, "Dropped %u", &count) == 1)
+    {
+      reported += count;
+      continue;
+    }
+
+    pos = logline.find("thread ");
+    int thread, line;
+    int fields = pos != std::string::npos ? sscanf(logline.c_str() + pos, "thread %d line %d", &thread, &line) : 0;
+    if (fields == 0)
+      continue;
+
+    ASSERT_TRUE(thread >= 0 && thread < threadCount) << logline;
+    if (fields == 2)
+    {
+      EXPECT_LT(last[thread], line) << logline;
+      last[thread] = line;
+      written++;
+    }
+    else
+      done[thread] = true;
+  }
+  for (int i = 0; i < threadCount; ++i)
+    EXPECT_TRUE(done[i]);
+  EXPECT_EQ(dropped, reported);
+  EXPECT_EQ(static_cast<uint64_t>(threadCount) * lineCount, written + dropped);
+
+  EXPECT_TRUE(XFILE::CFile::Delete(logfile));
+}
+
+// lines per second of four threads logging at once, run with
+// --gtest_also_run_disabled_tests
+TEST_F(Testlog, DISABLED_Benchmark)
+{
+  const int threadCount = 4;
+  const int lineCount = 200000;
+
+  uint64_t dropped;
+  auto start = std::chrono::steady_clock::now();
+  std::string logfile = LogConcurrently(threadCount, lineCount, dropped);
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  RecordProperty("lines_per_second", static_cast<int>(threadCount * lineCount * 1000000LL / std::max<int64_t>(elapsed, 1)));
+  RecordProperty("dropped_lines", static_cast<int>(dropped));
+
+  EXPECT_TRUE(XFILE::CFile::Delete(logfile));
+}
@@ -529,12 +529,22 @@ int CVideoDatabase::GetPathId(const std::string& strPath)
 
     URIUtils::AddSlashAtEnd(strPath1);
 
+    std::string cacheKey = "path:" + strPath1;
+    if (InBatch())
+    {
+      auto it = m_batchIdCache.find(cacheKey);
+      if (it != m_batchIdCache.end())
+        return it->second;
+    }
+
     strSQL=PrepareSQL("select idPath from path where strPath='%s'",strPath1.c_str());
     m_pDS->query(strSQL);
     if (!m_pDS->eof())
       idPath = m_pDS->fv("path.idPath").get_asInt();
 
     m_pDS->close();
+    if (idPath >= 0 && InBatch())
+      m_batchIdCache.insert(std::make_pair(cacheKey, idPath));
     return idPath;
   }
   catch (...)
@@ -748,6 +758,8 @@ int CVideoDatabase::AddPath(const std::string& strPath, const std::string &paren
     }
     m_pDS->exec(strSQL);
     idPath = (int)m_pDS->lastinsertid();
+    if (InBatch())
+      m_batchIdCache.insert(std::make_pair("path:" + strPath1, idPath));
     return idPath;
   }
   catch (...)
@@ -1404,6 +1416,11 @@ int CVideoDatabase::AddMusicVideo(const std::string& strFilenameAndPath)
   return -1;
 }
 
+void CVideoDatabase::ClearBatchCache()
+{
+  m_batchIdCache.clear();
+}
+
 //********************************************************************************************************************************
 int CVideoDatabase::AddToTable(const std::string& table, const std::string& firstField, const std::string& secondField, const std::string& value)
 {
@@ -1412,6 +1429,18 @@ int CVideoDatabase::AddToTable(const std::string& table, const std::string& firs
     if (NULL == m_pDB.get()) return -1;
     if (NULL == m_pDS.get()) return -1;
 
+    // tags are removed by trigger together with their last link, so they can't be cached
+    std::string cacheKey;
+    if (InBatch() && table != "tag")
+    {
+      cacheKey = table + ":" + value.substr(0, 255);
+      StringUtils::ToLower(cacheKey);
+      auto it = m_batchIdCache.find(cacheKey);
+      if (it != m_batchIdCache.end())
+        return it->second;
+    }
+
+    int id = -1;
     std::string strSQL = PrepareSQL("select %s from %s where %s like '%s'", firstField.c_str(), table.c_str(), secondField.c_str(), value.substr(0, 255).c_str());
     m_pDS->query(strSQL);
     if (m_pDS->num_rows() == 0)
@@ -1420,15 +1449,17 @@ int CVideoDatabase::AddToTable(const std::string& table, const std::string& firs
       // doesnt exists, add it
       strSQL = PrepareSQL("insert into %s (%s, %s) values(NULL, '%s')", table.c_str(), firstField.c_str(), secondField.c_str(), value.substr(0, 255).c_str());
       m_pDS->exec(strSQL);
-      int id = (int)m_pDS->lastinsertid();
-      return id;
+      id = (int)m_pDS->lastinsertid();
     }
     else
     {
-      int id = m_pDS->fv(firstField.c_str()).get_asInt();
+      id = m_pDS->fv(firstField.c_str()).get_asInt();
       m_pDS->close();
-      return id;
     }
+
+    if (!cacheKey.empty())
+      m_batchIdCache.insert(std::make_pair(cacheKey, id));
+    return id;
   }
   catch (...)
   {
@@ -1615,26 +1646,44 @@ int CVideoDatabase::AddActor(const std::string& name, const std::string& thumbUR
     std::string trimmedName = name.c_str();
     StringUtils::Trim(trimmedName);
 
-    std::string strSQL=PrepareSQL("select actor_id from actor where name like '%s'", trimmedName.substr(0, 255).c_str());
-    m_pDS->query(strSQL);
-    if (m_pDS->num_rows() == 0)
+    std::string cacheKey = "actor:" + trimmedName.substr(0, 255);
+    StringUtils::ToLower(cacheKey);
+    if (InBatch())
     {
-      m_pDS->close();
-      // doesnt exists, add it
-      strSQL=PrepareSQL("insert into actor (actor_id, name, art_urls) values(NULL, '%s', '%s')", trimmedName.substr(0,255).c_str(), thumbURLs.c_str());
-      m_pDS->exec(strSQL);
-      idActor = (int)m_pDS->lastinsertid();
+      auto it = m_batchIdCache.find(cacheKey);
+      if (it != m_batchIdCache.end())
+        idActor = it->second;
     }
-    else
+
+    std::string strSQL;
+    bool added = false;
+    if (idActor < 0)
     {
-      idActor = m_pDS->fv(0).get_asInt();
-      m_pDS->close();
-      // update the thumb url's
-      if (!thumbURLs.empty())
+      strSQL=PrepareSQL("select actor_id from actor where name like '%s'", trimmedName.substr(0, 255).c_str());
+      m_pDS->query(strSQL);
+      if (m_pDS->num_rows() == 0)
       {
-        strSQL=PrepareSQL("update actor set art_urls = '%s' where actor_id = %i", thumbURLs.c_str(), idActor);
+        m_pDS->close();
+        // doesnt exists, add it
+        strSQL=PrepareSQL("insert into actor (actor_id, name, art_urls) values(NULL, '%s', '%s')", trimmedName.substr(0,255).c_str(), thumbURLs.c_str());
         m_pDS->exec(strSQL);
+        idActor = (int)m_pDS->lastinsertid();
+        added = true;
       }
+      else
+      {
+        idActor = m_pDS->fv(0).get_asInt();
+        m_pDS->close();
+      }
+      if (InBatch())
+        m_batchIdCache.insert(std::make_pair(cacheKey, idActor));
+    }
+
+    // update the thumb url's
+    if (!added && !thumbURLs.empty())
+    {
+      strSQL=PrepareSQL("update actor set art_urls = '%s' where actor_id = %i", thumbURLs.c_str(), idActor);
+      m_pDS->exec(strSQL);
     }
     // add artwork
     if (!thumb.empty())
@@ -9647,15 +9696,32 @@ bool CVideoDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
   { // number of items in the db has likely changed, so recalculate
-    GUIINFO::CLibraryGUIInfo& guiInfo = CServiceBroker::GetGUI()->GetInfoManager().GetInfoProviders().GetLibraryInfoProvider();
-    guiInfo.SetLibraryBool(LIBRARY_HAS_MOVIES, HasContent(VIDEODB_CONTENT_MOVIES));
-    guiInfo.SetLibraryBool(LIBRARY_HAS_TVSHOWS, HasContent(VIDEODB_CONTENT_TVSHOWS));
-    guiInfo.SetLibraryBool(LIBRARY_HAS_MUSICVIDEOS, HasContent(VIDEODB_CONTENT_MUSICVIDEOS));
+    // within a batch this is done once the batch is closed
+    if (!InBatch())
+      UpdateLibraryInfo();
     return true;
   }
   return false;
 }
 
+bool CVideoDatabase::EndBatch()
+{
+  if (!InBatch())
+    return false;
+
+  bool ret = CDatabase::EndBatch();
+  UpdateLibraryInfo();
+  return ret;
+}
+
+void CVideoDatabase::UpdateLibraryInfo()
+{
+  GUIINFO::CLibraryGUIInfo& guiInfo = CServiceBroker::GetGUI()->GetInfoManager().GetInfoProviders().GetLibraryInfoProvider();
+  guiInfo.SetLibraryBool(LIBRARY_HAS_MOVIES, HasContent(VIDEODB_CONTENT_MOVIES));
+  guiInfo.SetLibraryBool(LIBRARY_HAS_TVSHOWS, HasContent(VIDEODB_CONTENT_TVSHOWS));
+  guiInfo.SetLibraryBool(LIBRARY_HAS_MUSICVIDEOS, HasContent(VIDEODB_CONTENT_MUSICVIDEOS));
+}
+
 bool CVideoDatabase::SetSingleValue(VIDEODB_CONTENT_TYPE type, int dbId, int dbField, const std::string &strValue)
 {
   std::string strSQL;
@@ -432,6 +432,7 @@ public:
 
   bool Open() override;
   bool CommitTransaction() override;
+  bool EndBatch() override;
 
   int AddMovie(const std::string& strFilenameAndPath);
   int AddEpisode(int idShow, const std::string& strFilenameAndPath);
@@ -940,6 +941,10 @@ private:
   void CreateTables() override;
   void CreateAnalytics() override;
   void UpdateTables(int version) override;
+  void ClearBatchCache() override;
+  /*! \brief Update whether the library has movies, tv shows and music videos for the GUI.
+   */
+  void UpdateLibraryInfo();
   void CreateLinkIndex(const char *table);
   void CreateForeignLinkIndex(const char *table, const char *foreignkey);
 
@@ -999,4 +1004,9 @@ private:
 
   static void AnnounceRemove(std::string content, int id, bool scanning = false);
   static void AnnounceUpdate(std::string content, int id);
+
+  /*! \brief ids of paths, actors, genres, studios etc. looked up or added during a batch,
+   keyed by table and value. Only used while a batch is open, see CDatabase::BeginBatch.
+   */
+  std::map<std::string, int> m_batchIdCache;
 };
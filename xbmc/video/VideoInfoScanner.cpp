@@ -111,6 +111,7 @@ namespace VIDEO
       unsigned int tick = XbmcThreads::SystemClockMillis();
 
       m_database.Open();
+      m_database.BeginBatch();
 
       m_bCanInterrupt = true;
 
@@ -150,6 +151,8 @@ namespace VIDEO
           bCancelled = true;
       }
 
+      m_database.EndBatch();
+
       if (!bCancelled)
       {
         if (m_bClean)
@@ -170,6 +173,7 @@ namespace VIDEO
     }
     catch (...)
     {
+      m_database.EndBatch();
       CLog::Log(LOGERROR, "VideoInfoScanner: Exception while scanning.");
     }
     
@@ -1313,6 +1317,7 @@ namespace VIDEO
       if (!strTrailer.empty())
         movieDetails.m_strTrailer = strTrailer;
 
+      m_database.BeginBatchItem();
       lResult = m_database.SetDetailsForMovie(pItem->GetPath(), movieDetails, art);
       movieDetails.m_iDbId = lResult;
       movieDetails.m_type = MediaTypeMovie;
@@ -1348,6 +1353,7 @@ namespace VIDEO
         if (!libraryImport)
           GetSeasonThumbs(movieDetails, seasonArt, CVideoThumbLoader::GetArtTypes(MediaTypeSeason), useLocal && !pItem->IsPlugin());
 
+        m_database.BeginBatchItem();
         lResult = m_database.SetDetailsForTvShow(paths, movieDetails, art, seasonArt);
         movieDetails.m_iDbId = lResult;
         movieDetails.m_type = MediaTypeTvShow;
@@ -1357,6 +1363,7 @@ namespace VIDEO
         // we add episode then set details, as otherwise set details will delete the
         // episode then add, which breaks multi-episode files.
         int idShow = showInfo ? showInfo->m_iDbId : -1;
+        m_database.BeginBatchItem();
         int idEpisode = m_database.AddEpisode(idShow, pItem->GetPath());
         lResult = m_database.SetDetailsForEpisode(pItem->GetPath(), movieDetails, art, idShow, idEpisode);
         movieDetails.m_iDbId = lResult;
@@ -1373,6 +1380,7 @@ namespace VIDEO
     }
     else if (content == CONTENT_MUSICVIDEOS)
     {
+      m_database.BeginBatchItem();
       lResult = m_database.SetDetailsForMusicVideo(pItem->GetPath(), movieDetails, art);
       movieDetails.m_iDbId = lResult;
       movieDetails.m_type = MediaTypeMusicVideo;
@@ -1388,6 +1396,7 @@ namespace VIDEO
         m_database.AddBookMarkToFile(pItem->GetPath(), movieDetails.GetResumePoint(), CBookmark::RESUME);
     }
 
+    m_database.BatchItemDone();
     m_database.Close();
 
     CFileItemPtr itemCopy = CFileItemPtr(new CFileItem(*pItem));
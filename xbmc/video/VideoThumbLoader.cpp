@@ -20,6 +20,7 @@
 
 #include "VideoThumbLoader.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <utility>
 
@@ -39,6 +40,7 @@
 #include "cores/VideoSettings.h"
 #include "TextureCache.h"
 #include "URL.h"
+#include "utils/CPUInfo.h"
 #include "utils/log.h"
 #include "utils/EmbeddedArt.h"
 #include "utils/StringUtils.h"
@@ -183,8 +185,14 @@ bool CThumbExtractor::DoWork()
   return false;
 }
 
+unsigned int CThumbExtractor::GetConcurrency()
+{
+  int cpus = g_cpuInfo.getCPUCount();
+  return static_cast<unsigned int>(std::max(1, std::min(4, cpus / 2)));
+}
+
 CVideoThumbLoader::CVideoThumbLoader() :
-  CThumbLoader(), CJobQueue(true, 1, CJob::PRIORITY_LOW_PAUSABLE)
+  CThumbLoader(), CJobQueue(true, CThumbExtractor::GetConcurrency(), CJob::PRIORITY_LOW_PAUSABLE)
 {
   m_videoDatabase = new CVideoDatabase();
 }
@@ -55,6 +55,13 @@ public:
 
   bool operator==(const CJob* job) const override;
 
+  /*!
+   \brief Number of extractor jobs that may run in parallel.
+   Extraction decodes keyframes only, so a few jobs keep the cores busy without
+   starving playback.
+   */
+  static unsigned int GetConcurrency();
+
   std::string m_target; ///< thumbpath
   std::string m_listpath; ///< path used in fileitem list
   CFileItem  m_item;
@@ -84,5 +84,6 @@ private:
   int m_jobsStarted;
   std::string m_filePath;
   CCriticalSection m_refreshSection;
+  CCriticalSection m_mapJobsSection; ///< chapter jobs complete on several workers
   MAPJOBSCHAPS m_mapJobsChapter;
 };
@@ -0,0 +1,129 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/DVDFileInfo.h"
+#include "TextureCacheJob.h"
+#include "filesystem/Directory.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/StringUtils.h"
+#include "video/VideoThumbLoader.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// There is no sample media in the tree, the benchmark runs against the files
+// listed (separated by ';') in KODI_THUMB_BENCH_FILES and only with
+// --gtest_also_run_disabled_tests.
+std::vector<std::string> GetBenchmarkFiles()
+{
+  const char* files = std::getenv("KODI_THUMB_BENCH_FILES");
+  if (!files)
+    return {};
+
+  std::vector<std::string> result = StringUtils::Split(files, ";");
+  result.erase(std::remove(result.begin(), result.end(), ""), result.end());
+  return result;
+}
+
+class TestVideoThumbExtraction : public testing::Test
+{
+protected:
+  TestVideoThumbExtraction()
+  {
+    m_thumbPath = CSpecialProtocol::TranslatePath("special://temp/thumb-benchmark/");
+    XFILE::CDirectory::Create(m_thumbPath);
+  }
+
+  ~TestVideoThumbExtraction() override
+  {
+    XFILE::CDirectory::RemoveRecursive(m_thumbPath);
+  }
+
+  bool ExtractThumb(const std::string& file, unsigned int index)
+  {
+    CTextureDetails details;
+    details.file = m_thumbPath + StringUtils::Format("thumb-%u.jpg", index);
+    return CDVDFileInfo::ExtractThumb(file, details, nullptr);
+  }
+
+  std::string m_thumbPath;
+};
+}
+
+TEST_F(TestVideoThumbExtraction, DISABLED_Benchmark)
+{
+  const std::vector<std::string> files = GetBenchmarkFiles();
+  if (files.empty())
+  {
+#ifdef GTEST_SKIP
+    GTEST_SKIP() << "KODI_THUMB_BENCH_FILES is not set";
+#else
+    std::cout << "[  SKIPPED ] KODI_THUMB_BENCH_FILES is not set" << std::endl;
+    return;
+#endif
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  unsigned int extracted = 0;
+  for (unsigned int i = 0; i < files.size(); i++)
+  {
+    if (ExtractThumb(files[i], i))
+      extracted++;
+  }
+  const auto sequential = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+  const unsigned int threadCount = CThumbExtractor::GetConcurrency();
+  std::atomic<unsigned int> next(0);
+  std::atomic<unsigned int> extractedParallel(0);
+  std::vector<std::thread> threads;
+
+  start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < threadCount; i++)
+  {
+    threads.emplace_back([&]()
+    {
+      for (unsigned int index = next++; index < files.size(); index = next++)
+      {
+        if (ExtractThumb(files[index], index))
+          extractedParallel++;
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  const auto parallel = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+  EXPECT_EQ(extracted, extractedParallel.load());
+
+  RecordProperty("Files", static_cast<int>(files.size()));
+  RecordProperty("Threads", static_cast<int>(threadCount));
+  RecordProperty("SequentialMsPerFile", static_cast<int>(sequential.count() / files.size()));
+  RecordProperty("ParallelMsPerFile", static_cast<int>(parallel.count() / files.size()));
+}
@@ -395,6 +395,8 @@ bool CGUIMediaWindow::OnMessage(CGUIMessage& message)
 
           CFileItemList list(message.GetStringParam());
           list.RemoveDiscCache(GetID());
+          if (list.IsPlugin())
+            XFILE::CPluginDirectory::ClearCachedListing(message.GetStringParam());
           Update(message.GetStringParam());
         }
         else
@@ -930,7 +932,11 @@ bool CGUIMediaWindow::Refresh(bool clearCache /* = false */)
   m_vecItemsUpdating = true;
 
   if (clearCache)
+  {
     m_vecItems->RemoveDiscCache(GetID());
+    if (m_vecItems->IsPlugin())
+      XFILE::CPluginDirectory::ClearCachedListing(strCurrentDirectory);
+  }
 
   bool ret = true;
 